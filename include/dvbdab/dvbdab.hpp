@@ -5,6 +5,7 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <stop_token>
 
 namespace dvbdab {
 
@@ -66,15 +67,19 @@ using SubchannelCallback = std::function<void(const StreamKey& stream,
                                                uint8_t subchannel_id,
                                                const uint8_t* data, size_t len)>;
 
+// Subchannel data callback with the CIF count of the frame the data came from
+// cif_count = DFLC (0-4999) for EDI sources, FCT (DFLC mod 250) for ETI-NA/TSNI
+using SubchannelCifCallback = std::function<void(const StreamKey& stream,
+                                                  uint8_t subchannel_id,
+                                                  const uint8_t* data, size_t len,
+                                                  uint16_t cif_count)>;
+
 // Audio frame callback (AAC or MP2)
 using AudioFrameCallback = std::function<void(const StreamKey& stream,
                                                uint32_t sid,
                                                const uint8_t* frame, size_t len,
                                                bool is_aac)>;
 
-// Ensemble discovery callback
-using EnsembleFoundCallback = std::function<void(const DABEnsemble& ensemble)>;
-
 // ETI frame constants
 constexpr size_t ETI_FRAME_SIZE = 6144;
 constexpr uint32_t ETI_FSYNC_ODD = 0xF8C549;   // Odd frames
@@ -120,6 +125,15 @@ struct EtiNaInfo {
     bool inverted{false};      // Signal is inverted
 };
 
+// Encapsulation an ensemble was found in
+enum class EnsembleFormat {
+    MPE,     // EDI over IP in MPE sections
+    GSE,     // EDI over IP in GSE-in-TS
+    BBF,     // EDI over IP in BBFrame pseudo-TS
+    ETI_NA,  // ETI over E1 (G.704)
+    TSNI     // TS NI V.11
+};
+
 // Discovered ensemble info (with full service list)
 struct DiscoveredEnsemble {
     uint32_t ip{0};              // Multicast IP address (0 for ETI-NA)
@@ -128,6 +142,7 @@ struct DiscoveredEnsemble {
     uint16_t pid{0};             // PID where ensemble was found
     std::string label;           // Ensemble label
     std::vector<DiscoveredService> services;  // Full service list
+    EnsembleFormat format{EnsembleFormat::MPE};  // Detected encapsulation
 
     // ETI-NA specific info (valid when is_etina is true)
     bool is_etina{false};        // True if this is an ETI-NA ensemble
@@ -150,6 +165,32 @@ struct DiscoveredEnsemble {
     }
 };
 
+// Ensemble discovery callback (progressive results, one call per ensemble)
+// complete = false: basic-ready report (EID + services, labels may be missing)
+// complete = true:  all labels received, same data as the final results
+// Return false to stop discovery early (e.g. once the wanted ensemble appeared)
+using EnsembleFoundCallback = std::function<bool(const DiscoveredEnsemble& ensemble, bool complete)>;
+
+// Time base for scan timeouts and early-exit windows
+enum class ClockMode {
+    Wall,   // Real time (steady_clock) - live input
+    Media,  // Stream time: PCR if present, else DFLC (24 ms per ETI frame), else TS
+            // packet (or IP byte) count at a nominal rate. Deterministic, runs at CPU
+            // speed on files.
+};
+
+// Custom time source: monotonic milliseconds, arbitrary epoch (overrides ClockMode)
+using ClockFunction = std::function<uint64_t()>;
+
+// Optional progressive reporting / cancellation for discoverEnsembles*()
+struct DiscoveryOptions {
+    EnsembleFoundCallback on_ensemble;  // Called as soon as each ensemble completes
+    bool report_basic_ready{false};     // Also call on_ensemble at basic-ready (complete=false)
+    std::stop_token stop_token;         // Cancel the scan from another thread
+    ClockMode clock_mode{ClockMode::Wall};  // Time base for timeout_ms
+    ClockFunction clock;                // Custom time source (overrides clock_mode)
+};
+
 // Input format for ensemble discovery
 enum class InputFormat {
     MPE,    // MPE-in-TS (Astra, etc.) - requires PID
@@ -176,11 +217,29 @@ std::vector<DiscoveredEnsemble> discoverEnsembles(
     unsigned int timeout_ms = 20000
 );
 
+/**
+ * Discover DAB ensembles in a file with progressive reporting.
+ *
+ * Same as above, but options.on_ensemble is invoked for every ensemble as soon
+ * as it completes, instead of only after all streams complete or the timeout.
+ * The scan stops early when the callback returns false or when
+ * options.stop_token is signalled; results found so far are returned.
+ */
+std::vector<DiscoveredEnsemble> discoverEnsembles(
+    const std::string& file_path,
+    InputFormat format,
+    uint16_t pid,
+    unsigned int timeout_ms,
+    const DiscoveryOptions& options
+);
+
 /**
  * Discover all DAB ensembles from a file descriptor (e.g., DVB DVR device).
  *
  * Reads from the fd and scans for DAB ensembles carried via EDI-over-UDP.
  * Returns information about each discovered ensemble including IP:port, EID, and label.
+ * Reading is done on a separate thread in large batches; on a DVR device the
+ * kernel buffer is enlarged (DMX_SET_BUFFER_SIZE) to avoid overflows.
  *
  * @param fd            File descriptor to read from (must be open and readable)
  * @param format        Input format (MPE, BBF, or GSE)
@@ -195,6 +254,20 @@ std::vector<DiscoveredEnsemble> discoverEnsemblesFromFd(
     unsigned int timeout_ms
 );
 
+/**
+ * Discover DAB ensembles from a file descriptor with progressive reporting.
+ *
+ * See the file-based overload for the meaning of options. Cancellation via
+ * options.stop_token is noticed within one poll interval (100ms).
+ */
+std::vector<DiscoveredEnsemble> discoverEnsemblesFromFd(
+    int fd,
+    InputFormat format,
+    uint16_t pid,
+    unsigned int timeout_ms,
+    const DiscoveryOptions& options
+);
+
 /**
  * Callback-fed ensemble discovery (for integration with table filter systems).
  *
@@ -203,8 +276,19 @@ std::vector<DiscoveredEnsemble> discoverEnsemblesFromFd(
  * existing demultiplexer (e.g., tvheadend's table filter system).
  *
  * Two-tier timeout:
- * - early_timeout_ms: Fail fast if no multicast UDP within this time
+ * - early_timeout_ms: Fail fast if no multicast UDP (or ETI frame) within this time
  * - total_timeout_ms: Max time to wait for ensemble discovery once multicast found
+ *
+ * Besides MPE-extracted IP packets, whole TS packets or TS payloads of one
+ * PID can be fed in any EnsembleFormat (see setFormat()). These paths also
+ * fail on the data itself, typically within a few dozen packets of a
+ * non-DAB PID, without waiting for early_timeout_ms:
+ * - MPE:    no MPE section within 64 packets
+ * - GSE:    no GSE packet within 64 packets, or no IPv4 within 32 GSE packets
+ * - BBF:    8 packets without the pseudo-TS header, no BBFrame start within
+ *           64 packets, or no IPv4 within 16 BBFrames
+ * - ETI_NA: no E1 sync within 16 KiB, or no ETI frame within 64 KiB
+ * - TSNI:   no PUSI within 16 KiB, or no frame sequence within 8 PUSIs
  */
 class EnsembleDiscovery {
 public:
@@ -234,7 +318,59 @@ public:
     int feedIpPacket(const uint8_t* ip_data, size_t len);
 
     /**
-     * Get discovered ensembles (call after feedIpPacket returns 1).
+     * Set the encapsulation of the PID fed with feedTsPacket()/feedPayload()
+     * (default: MPE). Call before the first feed.
+     *
+     * @param format    Encapsulation of the PID
+     * @param pid       PID carrying it (feedTsPacket() drops other PIDs)
+     */
+    void setFormat(EnsembleFormat format, uint16_t pid);
+
+    /**
+     * Feed TS data of the PID set with setFormat().
+     *
+     * Any alignment and amount; 188/192/204-byte packets are detected and
+     * packets split across calls are handled internally.
+     *
+     * @return          0=continue feeding, 1=done (found ensembles), -1=failed/timeout
+     */
+    int feedTsPacket(const uint8_t* data, size_t len);
+
+    /**
+     * Feed the payload of one TS packet (after the TS header and any
+     * adaptation field) of the PID set with setFormat(), for demuxers that
+     * deliver payloads. pusi is the payload_unit_start_indicator.
+     *
+     * @return          0=continue feeding, 1=done (found ensembles), -1=failed/timeout
+     */
+    int feedPayload(const uint8_t* payload, size_t len, bool pusi);
+
+    /**
+     * Set progressive ensemble callback.
+     *
+     * Called from within the feed call as soon as an ensemble completes
+     * (and at basic-ready if report_basic_ready is set). Returning false
+     * finishes discovery: the feed call then returns 1.
+     */
+    void setEnsembleCallback(EnsembleFoundCallback callback, bool report_basic_ready = false);
+
+    /**
+     * Cancel discovery. Safe to call from another thread; the next
+     * feed call returns 1 (or -1 if nothing was found yet).
+     */
+    void cancel();
+
+    /**
+     * Set the time base for both timeouts (default: wall clock).
+     * In media mode time advances with the PCR (TS input), the DFLC of the
+     * EDI streams, or else the amount of input at a nominal 50 Mbit/s, so
+     * the timeouts count stream time. Call before the first feed call.
+     */
+    void setClock(ClockMode mode);
+    void setClock(ClockFunction clock);
+
+    /**
+     * Get discovered ensembles (call after a feed call returns 1).
      */
     std::vector<DiscoveredEnsemble> getResults();
 
@@ -253,4 +389,38 @@ private:
     std::unique_ptr<Impl> impl_;
 };
 
+// =============================================================================
+// Threading - placement of threads created by the library
+// =============================================================================
+
+// Threads the library creates, by pipeline stage. Each gets a thread name
+// ("dvbdab-dvr", ...) visible in top -H and perf.
+enum class ThreadRole {
+    DvrReader,  // DvrReader / dvbdab_reader_t input thread ("dvbdab-dvr")
+    AsyncFeed,  // Streamer async feed worker ("dvbdab-feed")
+    UdpSender,  // UdpTsStreamer sender ("dvbdab-udp")
+    Recorder,   // Flight recorder dump writer ("dvbdab-rec")
+};
+
+struct ThreadConfig {
+    std::vector<int> cpus;  // CPUs to run on (empty = all, or the NUMA node's CPUs)
+    int policy{-1};         // SCHED_OTHER / SCHED_FIFO / SCHED_RR (-1 = inherit)
+    int priority{0};        // Scheduler priority (SCHED_FIFO / SCHED_RR)
+    int numa_node{-1};      // Preferred memory node, also the default CPU set (-1 = none)
+};
+
+/**
+ * Set the placement for threads of a role.
+ *
+ * Applies to threads started after the call. With a NUMA node, memory the
+ * thread allocates itself is placed on that node, and the DvrReader thread
+ * moves its ring there. Streamers, muxers and decoders are allocated by the
+ * thread that creates the streamer or starts the service, not by AsyncFeed:
+ * call those from a thread on the node to keep them local. Settings that
+ * fail (e.g. real-time priority without CAP_SYS_NICE) are skipped; the
+ * thread still runs.
+ */
+void setThreadConfig(ThreadRole role, const ThreadConfig& config);
+ThreadConfig getThreadConfig(ThreadRole role);
+
 } // namespace dvbdab
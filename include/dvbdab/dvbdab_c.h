@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <sys/uio.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -41,6 +42,7 @@ typedef struct {
     int etina_padding;      /* ETI-NA: leading 0xFF bytes */
     int etina_bit_offset;   /* ETI-NA: bit position of E1 sync */
     int etina_inverted;     /* ETI-NA: signal is inverted */
+    int format;             /* Detected encapsulation (dvbdab_format_t value) */
 } dvbdab_ensemble_t;
 
 /* ETI-NA detection info */
@@ -78,6 +80,33 @@ void dvbdab_scanner_destroy(dvbdab_scanner_t *scanner);
  */
 void dvbdab_scanner_set_timeout(dvbdab_scanner_t *scanner, unsigned int timeout_ms);
 
+/* Time base for the scanner timeout */
+typedef enum {
+    DVBDAB_CLOCK_WALL = 0,   /* Real time (default) */
+    DVBDAB_CLOCK_MEDIA = 1   /* Stream time from PCR or packet count: deterministic file scans */
+} dvbdab_clock_mode_t;
+
+/* Custom time source: monotonic milliseconds, arbitrary epoch */
+typedef uint64_t (*dvbdab_clock_cb)(void *opaque);
+
+/**
+ * Set the scanner time base. Call before the first feed.
+ * In media mode the timeout counts stream time, so a file scan gives the
+ * same result on every machine and runs as fast as the CPU allows.
+ * @param scanner Scanner handle
+ * @param mode    DVBDAB_CLOCK_WALL or DVBDAB_CLOCK_MEDIA
+ */
+void dvbdab_scanner_set_clock(dvbdab_scanner_t *scanner, dvbdab_clock_mode_t mode);
+
+/**
+ * Use a custom time source for the scanner (overrides the clock mode).
+ * @param scanner  Scanner handle
+ * @param callback Returns the current time in milliseconds, or NULL to remove
+ * @param opaque   User data passed to callback
+ */
+void dvbdab_scanner_set_clock_callback(dvbdab_scanner_t *scanner,
+                                       dvbdab_clock_cb callback, void *opaque);
+
 /**
  * Feed TS data to scanner.
  * @param scanner Scanner handle
@@ -101,6 +130,36 @@ int dvbdab_scanner_is_done(dvbdab_scanner_t *scanner);
  */
 int dvbdab_scanner_had_traffic(dvbdab_scanner_t *scanner);
 
+/**
+ * Callback for progressive scan results.
+ * Called from within dvbdab_scanner_feed() as soon as an ensemble is found.
+ * The ensemble (and its services array) is only valid during the call.
+ * @param opaque   User data passed to dvbdab_scanner_set_ensemble_callback
+ * @param ensemble Discovered ensemble
+ * @param complete 1 if all labels received, 0 for a basic-ready report
+ * @return         0 to continue scanning, non-zero to stop
+ */
+typedef int (*dvbdab_ensemble_found_cb)(void *opaque, const dvbdab_ensemble_t *ensemble,
+                                         int complete);
+
+/**
+ * Set progressive ensemble callback.
+ * @param scanner            Scanner handle
+ * @param callback           Function to call per ensemble (NULL to disable)
+ * @param opaque             User data passed to callback
+ * @param report_basic_ready 1 to also report ensembles at basic-ready
+ */
+void dvbdab_scanner_set_ensemble_callback(dvbdab_scanner_t *scanner,
+                                           dvbdab_ensemble_found_cb callback, void *opaque,
+                                           int report_basic_ready);
+
+/**
+ * Cancel scanning (safe to call from another thread).
+ * The next dvbdab_scanner_feed() returns 1; results found so far remain available.
+ * @param scanner Scanner handle
+ */
+void dvbdab_scanner_cancel(dvbdab_scanner_t *scanner);
+
 /**
  * Get scanner results.
  * Caller must free the results using dvbdab_results_free().
@@ -130,7 +189,8 @@ typedef enum {
     DVBDAB_FORMAT_MPE    = 1,  /* MPE/IP encapsulation */
     DVBDAB_FORMAT_GSE    = 2,  /* GSE encapsulation (in normal TS) */
     DVBDAB_FORMAT_BBF_TS = 3,  /* BBFrame-in-PseudoTS (from DMX_SET_FE_STREAM) */
-    DVBDAB_FORMAT_TSNI   = 4   /* TS NI V.11 encapsulation */
+    DVBDAB_FORMAT_TSNI   = 4,  /* TS NI V.11 encapsulation */
+    DVBDAB_FORMAT_EDI    = 5   /* Raw EDI AF packet stream (EDI over TCP, EDI files) */
 } dvbdab_format_t;
 
 /* Opaque unified streamer handle */
@@ -146,7 +206,7 @@ typedef struct {
     uint8_t eti_bit_offset;     /* Bit position of E1 sync (0-7) */
     uint8_t eti_inverted;       /* Signal is inverted */
 
-    /* MPE/GSE specific (only used when format == MPE or GSE) */
+    /* MPE/GSE specific (only used when format == MPE or GSE; EDI: stream key) */
     uint32_t filter_ip;         /* Multicast IP to filter (host byte order) */
     uint16_t filter_port;       /* UDP port to filter */
 
@@ -163,11 +223,28 @@ typedef struct {
 dvbdab_streamer_t *dvbdab_streamer_create(const dvbdab_streamer_config_t *config);
 
 /**
- * Destroy a streamer.
+ * Destroy a streamer (and the PID handles added to it).
  * @param streamer Streamer handle
  */
 void dvbdab_streamer_destroy(dvbdab_streamer_t *streamer);
 
+/**
+ * Handle a further ETI-NA or TSNI PID in the same streamer.
+ * The PID gets its own pipeline, ensemble, services and output; use the
+ * returned handle like a streamer of its own (set_output, start_service,
+ * get_ensemble, ...). Its data comes from feeding the parent streamer, so
+ * the TS is scanned once for all PIDs - do not feed the returned handle
+ * (dvbdab_streamer_replay_history() before the first feed is fine).
+ * Destroy the handle to stop handling the PID; it is destroyed with the
+ * parent otherwise.
+ * @param streamer Streamer created with format ETI_NA or TSNI
+ * @param config   Configuration of the PID (format ETI_NA or TSNI, a PID
+ *                 the streamer does not handle yet)
+ * @return Streamer handle for the PID, or NULL on error
+ */
+dvbdab_streamer_t *dvbdab_streamer_add_pid(dvbdab_streamer_t *streamer,
+                                           const dvbdab_streamer_config_t *config);
+
 /**
  * Set TS output callback.
  * The callback receives complete TS packets (188 bytes each) with proper
@@ -190,6 +267,78 @@ void dvbdab_streamer_set_output(dvbdab_streamer_t *streamer,
 int dvbdab_streamer_feed(dvbdab_streamer_t *streamer,
                           const uint8_t *data, size_t len);
 
+/**
+ * Feed raw TS data from several buffers (e.g. the segments of a ring buffer).
+ * Packets may span buffer boundaries; they are not copied into one buffer.
+ * @param streamer Streamer handle
+ * @param iov      Buffers, in stream order
+ * @param iovcnt   Number of buffers
+ * @return         0 on success, -1 on error
+ */
+int dvbdab_streamer_feedv(dvbdab_streamer_t *streamer,
+                           const struct iovec *iov, int iovcnt);
+
+/**
+ * Signal that input data was lost before the next feed (e.g. an RTP
+ * sequence gap). Each PID's next packet is handled as a continuity error,
+ * so partially received sections and frames are discarded.
+ * @param streamer Streamer handle
+ */
+void dvbdab_streamer_signal_discontinuity(dvbdab_streamer_t *streamer);
+
+/*
+ * Asynchronous feed.
+ * Buffers are queued without copying and processed in order on a worker
+ * thread owned by the streamer. Once a buffer has been consumed, the done
+ * callback is called with its tag (on the worker thread) and the memory may
+ * be reused. The output and MOT callbacks then also run on the worker thread.
+ *
+ * All streamer functions may be called from any thread while the worker runs;
+ * they are serialized internally. Do not call dvbdab_streamer_async_flush(),
+ * dvbdab_streamer_async_stop() or dvbdab_streamer_destroy() from a callback.
+ */
+
+/* Callback when a queued buffer has been consumed */
+typedef void (*dvbdab_feed_done_cb)(void *opaque, void *tag);
+
+/**
+ * Start the async feed worker.
+ * @param streamer   Streamer handle
+ * @param max_queued Maximum buffers in the queue (0 = default, 64)
+ * @param callback   Function to call per consumed buffer (may be NULL)
+ * @param opaque     User data passed to callback
+ * @return           0 on success, -1 on error (or already started)
+ */
+int dvbdab_streamer_async_start(dvbdab_streamer_t *streamer, size_t max_queued,
+                                 dvbdab_feed_done_cb callback, void *opaque);
+
+/**
+ * Queue buffers for the worker and return immediately.
+ * The iovec array is copied; the data it points to must stay valid until
+ * the done callback reports the tag.
+ * @param streamer Streamer handle
+ * @param iov      Buffers, in stream order
+ * @param iovcnt   Number of buffers
+ * @param tag      Passed to the done callback
+ * @return         0 if queued, 1 if the queue is full (retry later),
+ *                 -1 on error (or worker not started)
+ */
+int dvbdab_streamer_feedv_async(dvbdab_streamer_t *streamer,
+                                 const struct iovec *iov, int iovcnt, void *tag);
+
+/**
+ * Wait until all queued buffers have been consumed.
+ * @param streamer Streamer handle
+ */
+void dvbdab_streamer_async_flush(dvbdab_streamer_t *streamer);
+
+/**
+ * Consume the remaining queued buffers and stop the worker.
+ * Called by dvbdab_streamer_destroy() if needed.
+ * @param streamer Streamer handle
+ */
+void dvbdab_streamer_async_stop(dvbdab_streamer_t *streamer);
+
 /**
  * Check if ensemble discovery is complete.
  * @param streamer Streamer handle
@@ -206,7 +355,8 @@ int dvbdab_streamer_is_ready(dvbdab_streamer_t *streamer);
 int dvbdab_streamer_is_basic_ready(dvbdab_streamer_t *streamer);
 
 /**
- * Get discovered ensemble info.
+ * Get discovered ensemble info. Reflects the current FIC, so services added,
+ * removed or moved by a reconfiguration show up on the next call.
  * Caller must free with dvbdab_streamer_free_ensemble().
  * @param streamer Streamer handle
  * @return         Ensemble info, or NULL if not ready
@@ -263,6 +413,527 @@ int dvbdab_streamer_stop_service(dvbdab_streamer_t *streamer,
  */
 int dvbdab_streamer_start_all(dvbdab_streamer_t *streamer);
 
+/* MOT object (SlideShow image, station logo) */
+typedef struct {
+    uint32_t sid;               /* Service ID (0 if not signalled) */
+    uint8_t subchannel_id;      /* Subchannel carrying the object */
+    uint16_t transport_id;      /* MOT transport ID */
+    uint8_t content_type;       /* MOT content type (2 = image) */
+    uint16_t content_subtype;   /* Image: 1 = JPEG, 3 = PNG */
+    const char *content_name;   /* ContentName, NUL-terminated (may be empty) */
+    const uint8_t *data;        /* Object body */
+    size_t len;                 /* Body length in bytes */
+} dvbdab_mot_object_t;
+
+/* Callback for MOT objects; object and its data are only valid during the call */
+typedef void (*dvbdab_mot_object_cb)(void *opaque, const dvbdab_mot_object_t *object);
+
+/**
+ * Set callback for MOT objects (SlideShow).
+ * Objects are taken from the X-PAD of started DAB+ services and from
+ * packet-mode MOT data services signalled in the FIC. Each object is
+ * reported once; carousel repetitions are suppressed. MOT decoding only
+ * runs while a callback is set, and only for services subscribed with
+ * dvbdab_streamer_subscribe_mot().
+ * @param streamer Streamer handle
+ * @param callback Function to call per object, or NULL to disable
+ * @param opaque   User data passed to callback
+ */
+void dvbdab_streamer_set_mot_callback(dvbdab_streamer_t *streamer,
+                                       dvbdab_mot_object_cb callback, void *opaque);
+
+/* Subscribe MOT of every service (dvbdab_streamer_subscribe_mot) */
+#define DVBDAB_MOT_ALL 0
+
+/**
+ * Decode MOT objects of a service. MOT decoders and their buffers exist
+ * only for subscribed services: the X-PAD decoder of a started DAB+
+ * service, or the packet-mode decoder of a MOT data service.
+ * @param streamer Streamer handle
+ * @param sid      Service ID (the audio service for X-PAD, the data service
+ *                 for packet mode), or DVBDAB_MOT_ALL
+ */
+void dvbdab_streamer_subscribe_mot(dvbdab_streamer_t *streamer, uint32_t sid);
+
+/**
+ * Stop decoding MOT objects of a service.
+ * @param streamer Streamer handle
+ * @param sid      Service ID, or DVBDAB_MOT_ALL to remove all subscriptions
+ */
+void dvbdab_streamer_unsubscribe_mot(dvbdab_streamer_t *streamer, uint32_t sid);
+
+/*
+ * Callback for raw subchannel data: the MSC stream of one subchannel for one
+ * 24 ms CIF, pointing straight into the ETI frame (only valid during the call).
+ * cif_count is the DFLC (0-4999) for EDI input and the FCT (DFLC mod 250) for
+ * ETI-NA and TSNI input.
+ */
+typedef void (*dvbdab_subchannel_cb)(void *opaque, uint8_t subchannel_id,
+                                     const uint8_t *data, size_t len,
+                                     uint16_t cif_count);
+
+/**
+ * Subscribe to the raw data of a subchannel (packet mode, TPEG, EPG or an
+ * external audio decoder). Works without starting a service and without an
+ * output callback. Replaces any previous subscription for the subchannel.
+ * @param streamer      Streamer handle
+ * @param subchannel_id Subchannel ID (0-63)
+ * @param callback      Function to call per CIF
+ * @param opaque        User data passed to callback
+ * @return 0 on success, -1 on error
+ */
+int dvbdab_streamer_subscribe_subchannel(dvbdab_streamer_t *streamer, uint8_t subchannel_id,
+                                         dvbdab_subchannel_cb callback, void *opaque);
+
+/**
+ * Remove a raw subchannel subscription.
+ * @param streamer      Streamer handle
+ * @param subchannel_id Subchannel ID (0-63)
+ */
+void dvbdab_streamer_unsubscribe_subchannel(dvbdab_streamer_t *streamer, uint8_t subchannel_id);
+
+/* ============================================================================
+ * TS History - recent packets per PID for instant start of new streamers
+ * ============================================================================ */
+
+/* Opaque history handle */
+typedef struct dvbdab_history dvbdab_history_t;
+
+/**
+ * Create a TS history.
+ * Keeps the last duration_ms of TS packets for each selected PID, bounded by
+ * max_bytes_per_pid. Feed it everything read from the DVR; when a streamer is
+ * created later, replay the history into it before feeding live data.
+ * @param duration_ms       History length (0 = default, 5000 ms)
+ * @param max_bytes_per_pid Ring size per PID (0 = default, 2 MB)
+ * @return History handle, or NULL on error
+ */
+dvbdab_history_t *dvbdab_history_create(unsigned int duration_ms, size_t max_bytes_per_pid);
+
+/**
+ * Destroy a history.
+ * @param history History handle
+ */
+void dvbdab_history_destroy(dvbdab_history_t *history);
+
+/**
+ * Select a PID to record (MPE, GSE, ETI-NA, TSNI or BBF PID).
+ * @param history History handle
+ * @param pid     PID to record
+ */
+void dvbdab_history_add_pid(dvbdab_history_t *history, uint16_t pid);
+
+/**
+ * Stop recording a PID and free its packets.
+ * @param history History handle
+ * @param pid     PID to drop
+ */
+void dvbdab_history_remove_pid(dvbdab_history_t *history, uint16_t pid);
+
+/**
+ * Feed raw TS data (any alignment, 188/192/204-byte packets).
+ * @param history History handle
+ * @param data    TS data
+ * @param len     Length in bytes
+ */
+void dvbdab_history_feed(dvbdab_history_t *history, const uint8_t *data, size_t len);
+
+/**
+ * Replay the history recorded for the streamer's configured PID at full speed.
+ * Call right after creating the streamer (and setting its output), before
+ * feeding live data. ETI frames in live data that repeat replayed ones are
+ * dropped (frame count check), so history and live data may overlap.
+ * @param streamer Streamer handle
+ * @param history  History handle
+ * @return Number of TS packets replayed, or -1 on error
+ */
+int dvbdab_streamer_replay_history(dvbdab_streamer_t *streamer,
+                                    const dvbdab_history_t *history);
+
+/* ============================================================================
+ * Flight Recorder - raw input of a streamer dumped to disk around anomalies
+ * ============================================================================ */
+
+/* Flight recorder configuration (0 = default for all numeric fields) */
+typedef struct {
+    const char *directory;          /* Existing directory for the dumps */
+    const char *prefix;             /* File name prefix (NULL = "dvbdab") */
+    unsigned int duration_ms;       /* Input kept before a trigger (default 5000) */
+    unsigned int post_trigger_ms;   /* Input recorded after a trigger (default 1000) */
+    size_t max_bytes;               /* Ring size, two rings are allocated (default 32 MB) */
+    unsigned int check_interval_ms; /* Counter check interval (default 1000) */
+
+    /* Dump when a counter grows by at least this much within one check interval (0 = off) */
+    unsigned int cc_errors;          /* TS continuity errors (MPE/GSE/BBF only, must be 0 otherwise) */
+    unsigned int fib_crc_errors;     /* FIBs with CRC errors */
+    unsigned int pf_expired;         /* EDI AF packets lost to missing PF fragments */
+    unsigned int superframe_resyncs; /* DAB+ superframe sync losses */
+} dvbdab_recorder_config_t;
+
+/* Flight recorder statistics */
+typedef struct {
+    uint64_t trigger_count;     /* Triggers (threshold or API) */
+    uint64_t skipped_count;     /* Triggers ignored while a dump was pending */
+    uint64_t dump_count;        /* Dumps written */
+    int busy;                   /* A dump is pending or being written */
+    int error;                  /* errno of the last failed dump, 0 if none */
+} dvbdab_recorder_stats_t;
+
+/**
+ * Record the streamer's raw input and dump it around anomalies.
+ * Fed data is copied into a preallocated ring (one memcpy per feed). On a
+ * trigger, recording continues for post_trigger_ms and the window is written
+ * to <directory>/<prefix>-<date>-<time>-<n>-<reason>.ts (.edi for EDI input)
+ * by a background thread. Replaces a previous recorder. The rings are
+ * allocated without holding up feeds; a replaced recorder finishes a pending
+ * dump before the call returns.
+ * @param streamer Streamer handle
+ * @param config   Recorder configuration
+ * @return 0 on success, -1 on error (also cc_errors set for a format without
+ *         TS continuity counters: ETI-NA, TSNI, EDI)
+ */
+int dvbdab_streamer_enable_recorder(dvbdab_streamer_t *streamer,
+                                    const dvbdab_recorder_config_t *config);
+
+/**
+ * Stop recording; a pending dump is still written (feeds are not blocked meanwhile).
+ * @param streamer Streamer handle
+ */
+void dvbdab_streamer_disable_recorder(dvbdab_streamer_t *streamer);
+
+/**
+ * Dump the recorded input now (after post_trigger_ms).
+ * @param streamer Streamer handle
+ * @param reason   Short reason, used in the file name (NULL = "manual")
+ * @return 0 if a dump was started, -1 if no recorder or a dump is pending
+ */
+int dvbdab_streamer_trigger_recorder(dvbdab_streamer_t *streamer, const char *reason);
+
+/**
+ * Get flight recorder statistics.
+ * @param streamer Streamer handle
+ * @param stats    Filled with the current statistics
+ * @return 0 on success, -1 if no recorder is enabled
+ */
+int dvbdab_streamer_get_recorder_stats(dvbdab_streamer_t *streamer, dvbdab_recorder_stats_t *stats);
+
+/* ============================================================================
+ * Subchannel Statistics - measured payload per subchannel, rolling windows
+ * ============================================================================ */
+
+/* MSC capacity of an ensemble in capacity units (CUs) */
+#define DVBDAB_ENSEMBLE_CU 864
+
+/* Per-subchannel statistics over a window */
+typedef struct {
+    uint8_t subchannel_id;      /* Sub-channel ID */
+    uint32_t sid;               /* Primary service (0 if none, e.g. packet data) */
+    int dabplus;                /* 1 for DAB+ */
+
+    /* Signalled in the FIC (0 if the subchannel is not signalled) */
+    int start_cu;               /* Start address in CUs */
+    int size_cu;                /* Size in CUs */
+    int signalled_kbps;         /* Bitrate in kbps */
+
+    /* Measured in the ETI frames */
+    double carried_kbps;        /* Subchannel stream bitrate */
+    uint64_t cif_count;         /* ETI frames carrying the subchannel */
+
+    /* Measured by the decoder (only while the service is started) */
+    int decoded;                /* 1 if a decoder ran in the window */
+    double au_kbps;             /* Valid AUs (DAB+) or MP2 frames, PAD included */
+    double pad_kbps;            /* PAD (F-PAD and X-PAD) within them */
+    uint64_t au_count;          /* AUs or MP2 frames checked */
+    uint64_t au_crc_errors;     /* DAB+ AU CRC / DAB header CRC failures */
+    double au_error_rate;       /* au_crc_errors / au_count */
+    uint64_t superframe_count;  /* DAB+ superframe starts checked */
+    uint64_t firecode_errors;   /* DAB+ superframe starts failing FireCode */
+    double firecode_error_rate; /* firecode_errors / superframe_count */
+} dvbdab_subchannel_stats_t;
+
+/* Ensemble statistics over a window */
+typedef struct {
+    unsigned int window_ms;     /* Stream time covered (24 ms per ETI frame) */
+    int cu_used;                /* CUs of all subchannels signalled in the FIC */
+    int cu_capacity;            /* DVBDAB_ENSEMBLE_CU */
+    double cu_usage;            /* cu_used / cu_capacity */
+    double carried_kbps;        /* Sum over all subchannels */
+    int subchannel_count;       /* Subchannels signalled or carried */
+} dvbdab_ensemble_stats_t;
+
+/**
+ * Get measured per-subchannel statistics.
+ * Counted in the ETI dispatch for every subchannel and in the decoders of
+ * started services, in one-second buckets of stream time; the last 60 s
+ * are kept. Covers the newest complete seconds, so the figures are empty
+ * during the first second.
+ * @param streamer        Streamer handle
+ * @param window_s        Window length in seconds (1-60, 0 = 10)
+ * @param ensemble        Filled with the ensemble totals (may be NULL)
+ * @param subchannels     Filled in subchannel ID order (may be NULL)
+ * @param max_subchannels Capacity of subchannels (64 covers every ID)
+ * @return Number of subchannels written, or -1 on error
+ */
+int dvbdab_streamer_get_subchannel_stats(dvbdab_streamer_t *streamer, unsigned int window_s,
+                                          dvbdab_ensemble_stats_t *ensemble,
+                                          dvbdab_subchannel_stats_t *subchannels,
+                                          int max_subchannels);
+
+/* ============================================================================
+ * Diversity - several inputs of one ensemble, best frame per 24 ms slot
+ * ============================================================================ */
+
+/* Diversity combiner statistics */
+typedef struct {
+    uint64_t output_count;      /* Frames decoded */
+    uint64_t missing_count;     /* Slots no input delivered */
+    uint64_t late_count;        /* Frames dropped, slot already decoded */
+    uint64_t misaligned_count;  /* Frames dropped on TIST mismatch */
+    uint64_t unusable_count;    /* Frames dropped with bad sync or header */
+    uint64_t switch_count;      /* Changes of the selected input */
+    uint64_t input_frames;      /* This handle's input: frames received */
+    uint64_t input_selected;    /* This handle's input: frames decoded */
+    int input_count;            /* Inputs, including the streamer's own */
+} dvbdab_combiner_stats_t;
+
+/**
+ * Add a redundant input of the streamer's ensemble (e.g. the same EID via
+ * a second satellite, or ETI-NA next to MPE).
+ * Returns an input handle, fed like a streamer (dvbdab_streamer_feed(),
+ * readers, async feed) from any thread. Its ETI frames are aligned with
+ * those of the streamer's own input and of other added inputs; for each
+ * 24 ms frame the copy with the best quality (header, FIB and MST CRCs) is
+ * decoded and output by the streamer. Frames are delayed by up to 10 frames
+ * while waiting for a lagging input. The ensemble information comes from
+ * whichever input delivers it first.
+ * Destroy the handle to remove the input; it is destroyed with the streamer
+ * otherwise.
+ * @param streamer Streamer decoding the ensemble
+ * @param config   Configuration of the input (any format)
+ * @return Input handle, or NULL on error
+ */
+dvbdab_streamer_t *dvbdab_streamer_add_input(dvbdab_streamer_t *streamer,
+                                             const dvbdab_streamer_config_t *config);
+
+/**
+ * Get diversity combiner statistics.
+ * @param streamer Streamer, or an input handle (adds its own counts)
+ * @param stats    Filled with the current statistics
+ * @return 0 on success, -1 if the streamer has no added inputs
+ */
+int dvbdab_streamer_get_combiner_stats(dvbdab_streamer_t *streamer, dvbdab_combiner_stats_t *stats);
+
+/* ============================================================================
+ * DVR Reader - batched reading of a DVR device (or pipe/file) on a thread
+ * ============================================================================ */
+
+/* Opaque reader handle */
+typedef struct dvbdab_reader dvbdab_reader_t;
+
+/* Reader statistics */
+typedef struct {
+    uint64_t bytes_read;        /* Bytes read from the fd */
+    uint64_t read_count;        /* read() calls returning data */
+    uint64_t overflow_count;    /* EOVERFLOW reported by the driver (data lost) */
+    uint64_t ring_full_count;   /* Reader stalled because the consumer fell behind */
+    uint64_t rate;              /* Measured input rate in bytes/s */
+    size_t read_size;           /* Current read size in bytes */
+    size_t dvr_buffer_size;     /* Kernel DVR buffer set, 0 if not a DVR device */
+    int error;                  /* errno of a fatal read error, 0 if none */
+} dvbdab_reader_stats_t;
+
+/**
+ * Create a reader and start its thread.
+ * On a DVR device the kernel buffer is set with DMX_SET_BUFFER_SIZE. Reads
+ * are sized to the measured input rate and go into a ring buffer that is
+ * consumed with dvbdab_reader_feed_streamer(). The fd is not closed.
+ * @param fd              File descriptor to read from
+ * @param ring_size       Ring buffer size (0 = default, 16 MB)
+ * @param dvr_buffer_size Kernel DVR buffer size (0 = default, 8 MB)
+ * @return Reader handle, or NULL on error
+ */
+dvbdab_reader_t *dvbdab_reader_create(int fd, size_t ring_size, size_t dvr_buffer_size);
+
+/**
+ * Stop the reader thread and destroy the reader.
+ * @param reader Reader handle
+ */
+void dvbdab_reader_destroy(dvbdab_reader_t *reader);
+
+/**
+ * Wait for data and feed everything buffered to a streamer.
+ * @param reader     Reader handle
+ * @param streamer   Streamer to feed
+ * @param timeout_ms Maximum time to wait for data
+ * @return Bytes fed, 0 on timeout, -1 at end of input (EOF or read error)
+ */
+long dvbdab_reader_feed_streamer(dvbdab_reader_t *reader, dvbdab_streamer_t *streamer,
+                                 unsigned int timeout_ms);
+
+/**
+ * Get reader statistics.
+ * @param reader Reader handle
+ * @param stats  Filled with the current statistics
+ */
+void dvbdab_reader_get_stats(const dvbdab_reader_t *reader, dvbdab_reader_stats_t *stats);
+
+/* ============================================================================
+ * TS over UDP/RTP - multicast or unicast TS (SAT>IP, minisatip, IPTV)
+ * ============================================================================ */
+
+/* Opaque UDP TS receiver handle */
+typedef struct dvbdab_udp_ts dvbdab_udp_ts_t;
+
+/* Receive method */
+typedef enum {
+    DVBDAB_UDP_TS_AUTO   = 0,  /* Ring if an interface is given and allowed, else socket */
+    DVBDAB_UDP_TS_RING   = 1,  /* AF_PACKET TPACKET_V3 mmap ring (CAP_NET_RAW, interface) */
+    DVBDAB_UDP_TS_SOCKET = 2   /* UDP socket with recvmmsg() */
+} dvbdab_udp_ts_mode_t;
+
+/* UDP TS receiver statistics */
+typedef struct {
+    uint64_t datagram_count;    /* Datagrams received */
+    uint64_t rtp_count;         /* Datagrams with an RTP header */
+    uint64_t sequence_gaps;     /* RTP sequence gaps (signalled as discontinuities) */
+    uint64_t lost_datagrams;    /* Missing RTP sequence numbers */
+    uint64_t invalid_count;     /* Not TS, or late/duplicate RTP */
+    uint64_t drop_count;        /* Dropped by the kernel (ring or socket buffer full) */
+    int ring;                   /* Receiving through the mmap ring */
+    int error;                  /* errno of the last failure, 0 if none */
+} dvbdab_udp_ts_stats_t;
+
+/**
+ * Open a TS-over-UDP/RTP receiver and join the group.
+ * @param address   Multicast group or local address (NULL or "" = any)
+ * @param port      UDP port
+ * @param interface Network interface name (NULL = default; required for the ring)
+ * @param mode      Receive method
+ * @return Receiver handle, or NULL on error
+ */
+dvbdab_udp_ts_t *dvbdab_udp_ts_open(const char *address, uint16_t port,
+                                    const char *interface, dvbdab_udp_ts_mode_t mode);
+
+/**
+ * Leave the group and destroy the receiver.
+ * @param rx Receiver handle
+ */
+void dvbdab_udp_ts_destroy(dvbdab_udp_ts_t *rx);
+
+/**
+ * Wait for datagrams and feed their TS payloads to a streamer.
+ * RTP headers are stripped; sequence gaps are passed on with
+ * dvbdab_streamer_signal_discontinuity(). Payloads are fed straight from the
+ * receive buffers.
+ * @param rx         Receiver handle
+ * @param streamer   Streamer to feed
+ * @param timeout_ms Maximum time to wait for data
+ * @return TS bytes fed, 0 on timeout, -1 on error
+ */
+long dvbdab_udp_ts_feed_streamer(dvbdab_udp_ts_t *rx, dvbdab_streamer_t *streamer,
+                                 unsigned int timeout_ms);
+
+/**
+ * Get receiver statistics.
+ * @param rx    Receiver handle
+ * @param stats Filled with the current statistics
+ */
+void dvbdab_udp_ts_get_stats(const dvbdab_udp_ts_t *rx, dvbdab_udp_ts_stats_t *stats);
+
+/* ============================================================================
+ * EDI over TCP - AF packet stream from an EDI sender (e.g. ODR-DabMux)
+ * ============================================================================ */
+
+/* Opaque EDI TCP input handle */
+typedef struct dvbdab_edi_tcp dvbdab_edi_tcp_t;
+
+/* EDI TCP input statistics */
+typedef struct {
+    uint64_t bytes_read;        /* Bytes received over all connections */
+    uint64_t rate;              /* Input rate of the current connection in bytes/s */
+    uint64_t connect_count;     /* Connections established */
+    int connected;              /* A sender is currently connected */
+    int error;                  /* errno of the last connect/accept/read failure, 0 if none */
+} dvbdab_edi_tcp_stats_t;
+
+/**
+ * Create an EDI TCP client that connects to a sender.
+ * The connection is made on the first dvbdab_edi_tcp_feed_streamer() call
+ * and re-established with exponential backoff whenever it drops.
+ * @param host Sender host name or address
+ * @param port Sender TCP port
+ * @return Handle, or NULL on error
+ */
+dvbdab_edi_tcp_t *dvbdab_edi_tcp_connect(const char *host, uint16_t port);
+
+/**
+ * Create an EDI TCP server that accepts one sender at a time.
+ * @param bind_addr Local address to listen on (NULL = any)
+ * @param port      TCP port to listen on
+ * @return Handle, or NULL on error
+ */
+dvbdab_edi_tcp_t *dvbdab_edi_tcp_listen(const char *bind_addr, uint16_t port);
+
+/**
+ * Close the connection and destroy the handle.
+ * @param tcp Handle
+ */
+void dvbdab_edi_tcp_destroy(dvbdab_edi_tcp_t *tcp);
+
+/**
+ * Wait for data and feed the AF packets received to a streamer.
+ * The streamer must be created with format DVBDAB_FORMAT_EDI; its
+ * filter_ip/filter_port are used as the stream key (any values, e.g. 0/0).
+ * @param tcp        Handle
+ * @param streamer   Streamer to feed
+ * @param timeout_ms Maximum time to wait for a connection or data
+ * @return Bytes fed, 0 on timeout or while (re)connecting, -1 on error
+ */
+long dvbdab_edi_tcp_feed_streamer(dvbdab_edi_tcp_t *tcp, dvbdab_streamer_t *streamer,
+                                  unsigned int timeout_ms);
+
+/**
+ * Get EDI TCP input statistics.
+ * @param tcp   Handle
+ * @param stats Filled with the current statistics
+ */
+void dvbdab_edi_tcp_get_stats(const dvbdab_edi_tcp_t *tcp, dvbdab_edi_tcp_stats_t *stats);
+
+/* ============================================================================
+ * Threading - placement of threads created by the library
+ * ============================================================================ */
+
+/* Library threads by pipeline stage (thread names as shown by top -H / perf) */
+typedef enum {
+    DVBDAB_THREAD_DVR_READER = 0,   /* dvbdab_reader_t input thread ("dvbdab-dvr") */
+    DVBDAB_THREAD_ASYNC_FEED = 1,   /* Streamer async feed worker ("dvbdab-feed") */
+    DVBDAB_THREAD_UDP_SENDER = 2,   /* UDP output sender ("dvbdab-udp") */
+    DVBDAB_THREAD_RECORDER   = 3    /* Flight recorder dump writer ("dvbdab-rec") */
+} dvbdab_thread_role_t;
+
+/* Thread placement */
+typedef struct {
+    const int *cpus;        /* CPUs to run on (NULL = all, or the NUMA node's CPUs) */
+    int cpu_count;          /* Number of entries in cpus */
+    int policy;             /* SCHED_OTHER / SCHED_FIFO / SCHED_RR, -1 = inherit */
+    int priority;           /* Scheduler priority (SCHED_FIFO / SCHED_RR) */
+    int numa_node;          /* Preferred memory node and default CPU set, -1 = none */
+} dvbdab_thread_config_t;
+
+/**
+ * Set the placement for threads of a role.
+ * Applies to threads started after the call. With a NUMA node, memory the
+ * thread allocates itself is placed on that node, and the DVR reader thread
+ * moves its ring there. Streamers and their decoders are allocated by the
+ * thread calling dvbdab_streamer_create / dvbdab_streamer_start_service:
+ * call those from a thread on the node to keep them local. Settings the
+ * system refuses (e.g. real-time priority without CAP_SYS_NICE) are skipped.
+ * @param role   Thread role
+ * @param config Placement, or NULL to reset to defaults
+ * @return 0 on success, -1 on error
+ */
+int dvbdab_set_thread_config(dvbdab_thread_role_t role, const dvbdab_thread_config_t *config);
+
 #ifdef __cplusplus
 }
 #endif
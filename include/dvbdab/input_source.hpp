@@ -28,6 +28,10 @@ public:
     // Get source description
     virtual const char* description() const = 0;
 
+    // Data was lost upstream of the TS (e.g. an RTP sequence gap): the next
+    // packet of every PID is treated as a continuity counter error
+    void markDiscontinuity() { cc_epoch_++; }
+
     // Statistics (common to all sources)
     size_t getDiscontinuityCount() const { return discontinuity_count_; }
 
@@ -44,13 +48,15 @@ protected:
         auto& state = cc_state_[pid];
         if (state.initialized) {
             uint8_t expected = (state.last_cc + 1) & 0x0f;
-            if (cc != expected) {
+            if (cc != expected || state.epoch != cc_epoch_) {
                 discontinuity_count_++;
                 state.last_cc = cc;
+                state.epoch = cc_epoch_;
                 return false;
             }
         }
         state.last_cc = cc;
+        state.epoch = cc_epoch_;
         state.initialized = true;
         return true;
     }
@@ -62,8 +68,10 @@ private:
     struct CcState {
         uint8_t last_cc{0};
         bool initialized{false};
+        uint8_t epoch{0};  // cc_epoch_ when last seen (wraps; only compared for equality)
     };
     std::array<CcState, 8192> cc_state_{};  // Max 13-bit PID
+    uint8_t cc_epoch_{0};
 };
 
 } // namespace dvbdab
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <dvbdab/dvbdab.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <version>
+
+#if !defined(__cpp_lib_generator)
+#error "<dvbdab/pull.hpp> needs std::generator (GCC/libstdc++ 14 or later)"
+#endif
+#include <generator>
+
+namespace dvbdab {
+
+// =============================================================================
+// Pull API - generators over an input that is read at the consumer's pace
+// =============================================================================
+
+// Read up to len bytes into buf; returns bytes read, 0 at end of input
+using ReadFunction = std::function<size_t(uint8_t* buf, size_t len)>;
+
+// ETI-NI frame (6144 bytes), borrowed from the source's buffer pool.
+// Valid until the generator is resumed.
+struct EtiFrameView {
+    StreamKey stream;               // EDI stream the frame belongs to
+    std::span<const uint8_t> data;
+    uint16_t dflc;                  // Data Flow Counter (0-4999)
+};
+
+// Audio access unit, borrowed from the decoder. Valid until the generator is resumed.
+struct AudioUnitView {
+    uint32_t sid;
+    uint8_t subchannel_id;
+    bool is_aac;                        // DAB+ (AAC) or DAB (MP2)
+    std::span<const uint8_t> adts_header;  // ADTS header for the AU (AAC only)
+    std::span<const uint8_t> data;      // Raw AAC access unit or MP2 frame
+    int64_t pts;                        // 90 kHz, continuous per service
+};
+
+// Ensemble state change
+struct EnsembleEvent {
+    enum class Type {
+        BasicReady,    // Services and subchannels known (labels may be missing)
+        Complete,      // All labels received
+        Reconfigured,  // Service to subchannel mapping changed after completion
+    };
+    Type type;
+    DiscoveredEnsemble ensemble;
+};
+
+/**
+ * Pull-driven input for the generator API.
+ *
+ * Nothing is read until a generator asks for its next item: each resume
+ * reads at most one block of read_size bytes at a time until that item is
+ * available, so the pipeline never runs ahead of the consumer. Only one
+ * generator should iterate a source at a time.
+ *
+ * Example:
+ *   PullSource source(PullSource::fdReader(fd), InputFormat::MPE, 3000);
+ *   for (const AudioUnitView& au : audioUnits(source, 0xD210)) {
+ *       write(out, au.data.data(), au.data.size());
+ *   }
+ */
+class PullSource {
+public:
+    static constexpr size_t DEFAULT_READ_SIZE = 188 * 64;
+
+    PullSource(ReadFunction read, InputFormat format, uint16_t pid = 3000,
+               size_t read_size = DEFAULT_READ_SIZE);
+    ~PullSource();
+
+    // Non-copyable
+    PullSource(const PullSource&) = delete;
+    PullSource& operator=(const PullSource&) = delete;
+
+    // Reader for a file descriptor (file, pipe, DVR device); the fd is not closed
+    static ReadFunction fdReader(int fd);
+
+    // Only deliver frames, audio and events of one EDI stream (default: all streams)
+    void setStream(const StreamKey& stream);
+
+    // Raw MSC data of a subchannel (0-63), passed straight out of each ETI
+    // frame while a generator reads the source; data is only valid during
+    // the call. Replaces any previous subscription for that subchannel.
+    void subscribeSubchannel(uint8_t subchannel_id, SubchannelCallback callback);
+    void subscribeSubchannel(uint8_t subchannel_id, SubchannelCifCallback callback);
+    void unsubscribeSubchannel(uint8_t subchannel_id);
+
+    // End of input reached
+    bool atEnd() const;
+
+    // Statistics
+    size_t getBytesRead() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    friend std::generator<const EtiFrameView&> frames(PullSource& source);
+    friend std::generator<const AudioUnitView&> audioUnits(PullSource& source, uint32_t sid);
+    friend std::generator<const EnsembleEvent&> ensembleEvents(PullSource& source);
+};
+
+/**
+ * ETI frames of all streams (or the one selected with setStream()).
+ * Frame buffers come from a pool and are reused once the consumer resumes.
+ */
+std::generator<const EtiFrameView&> frames(PullSource& source);
+
+/**
+ * Audio access units of one service. The decoder is created once the
+ * service is signalled and follows subchannel reconfigurations.
+ */
+std::generator<const AudioUnitView&> audioUnits(PullSource& source, uint32_t sid);
+
+/**
+ * Ensemble events (basic-ready, complete, reconfigured) in stream order.
+ */
+std::generator<const EnsembleEvent&> ensembleEvents(PullSource& source);
+
+} // namespace dvbdab
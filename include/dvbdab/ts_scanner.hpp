@@ -24,7 +24,13 @@ struct EtiNaDetectionInfo {
  *
  * Scans raw TS packets to automatically detect DAB ensembles carried via:
  *   - MPE (Multi-Protocol Encapsulation) - section-based, table_id 0x3E
+ *   - GSE-in-TS - continuous mode, no PUSI (also on the null PID)
+ *   - BBF pseudo-TS - 00 80 00 pseudo header with BBFrame sync 0xB8
  *   - ETI-NA (G.704/E1) - continuous mode, no PUSI, UK satellite feeds
+ *   - TS NI V.11 - pointer 0 followed by an incrementing frame counter
+ *
+ * All formats are detected in one pass; each result carries the detected
+ * format (DiscoveredEnsemble::format).
  *
  * Detection flow for MPE:
  *   1. Scan ALL PIDs for MPE sections (table_id 0x3E)
@@ -32,6 +38,12 @@ struct EtiNaDetectionInfo {
  *   3. Detect ETI frames in UDP payloads
  *   4. Parse FIC for ensemble/service information
  *
+ * Detection flow for GSE / BBF (after 100 packets on a PID):
+ *   1. All packets with the pseudo-TS header -> BBF source
+ *   2. No PUSI -> GSE trial (next to the ETI-NA trial), confirmed by the
+ *      first valid IPv4 packet, dropped after 2000 packets without one
+ *   3. IP packets then follow the MPE path (UDP -> ETI -> FIC)
+ *
  * Detection flow for ETI-NA:
  *   1. Detect PIDs with no PUSI (continuous data)
  *   2. Analyze for consistent 0xFF padding
@@ -63,16 +75,42 @@ public:
      */
     void setTimeout(unsigned int timeout_ms);
 
+    /**
+     * Set the time base for the timeout and early-exit windows.
+     * Default: wall clock. In media mode time is taken from the stream
+     * (PCR, or TS packet count at a nominal rate while no PCR was seen),
+     * so a file scan gives the same result on any machine and is not
+     * limited by real time. Call before the first feed().
+     */
+    void setClock(ClockMode mode);
+    void setClock(ClockFunction clock);
+
     /**
      * Feed raw TS data to the scanner.
-     * Can be called with any amount of data (handles partial packets).
+     * Can be called with any amount of data at any alignment (sync is
+     * acquired internally; 188, 192 and 204-byte packets are detected).
      *
-     * @param data  Raw TS data (must start at sync byte 0x47)
+     * @param data  Raw TS data
      * @param len   Length of data in bytes
      * @return      0 = continue feeding, 1 = done (timeout or all complete)
      */
     int feed(const uint8_t* data, size_t len);
 
+    /**
+     * Set progressive ensemble callback.
+     *
+     * Called from within feed() for each ensemble (MPE, ETI-NA or TSNI) as soon
+     * as it completes, and additionally at basic-ready if report_basic_ready
+     * is set. Returning false stops the scan: feed() then returns 1.
+     */
+    void setEnsembleCallback(EnsembleFoundCallback callback, bool report_basic_ready = false);
+
+    /**
+     * Cancel scanning. Safe to call from another thread; the next feed()
+     * returns 1 and getResults() holds whatever was found so far.
+     */
+    void cancel();
+
     /**
      * Get discovered ensembles.
      * Call after feed() returns 1 or isDone() returns true.
@@ -95,6 +133,11 @@ public:
      */
     std::vector<uint16_t> getMpePids() const;
 
+    /**
+     * Get list of GSE-in-TS and BBF pseudo-TS PIDs discovered during scan.
+     */
+    std::vector<uint16_t> getGsePids() const;
+
     /**
      * Get ETI-NA detection results.
      * Returns information about PIDs detected as carrying ETI-NA data
@@ -0,0 +1,86 @@
+#include "clock.hpp"
+
+namespace dvbdab {
+
+void Clock::start() {
+    if (fn_) {
+        fn_start_ = fn_();
+    } else if (mode_ == ClockMode::Media) {
+        media_ns_ = 0;
+    } else {
+        wall_start_ = std::chrono::steady_clock::now();
+    }
+}
+
+uint64_t Clock::elapsedMs() const {
+    if (fn_) {
+        return fn_() - fn_start_;
+    }
+    if (mode_ == ClockMode::Media) {
+        return media_ns_ / 1'000'000;
+    }
+    auto elapsed = std::chrono::steady_clock::now() - wall_start_;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+}
+
+void Clock::onTsPacket(const uint8_t* ts) {
+    // Adaptation field with PCR
+    if ((ts[3] & 0x20) && ts[4] >= 7 && (ts[5] & 0x10)) {
+        uint16_t pid = ((ts[1] & 0x1F) << 8) | ts[2];
+        uint64_t pcr = (static_cast<uint64_t>(ts[6]) << 25) | (static_cast<uint64_t>(ts[7]) << 17) |
+                       (static_cast<uint64_t>(ts[8]) << 9) | (static_cast<uint64_t>(ts[9]) << 1) |
+                       (ts[10] >> 7);
+
+        // Lock to the first PID carrying a PCR
+        if (source_ != Source::Pcr) {
+            source_ = Source::Pcr;
+            pcr_pid_ = pid;
+            last_pcr_ = pcr;
+            return;
+        }
+        if (pid != pcr_pid_) return;
+
+        uint64_t delta = (pcr - last_pcr_) & ((uint64_t{1} << 33) - 1);
+        last_pcr_ = pcr;
+        if (delta <= MAX_PCR_STEP) {
+            media_ns_ += delta * 100'000 / 9;
+        }
+        return;
+    }
+
+    if (source_ <= Source::Packets) {
+        source_ = Source::Packets;
+        media_ns_ += TS_PACKET_NS;
+    }
+}
+
+void Clock::onBytes(size_t len) {
+    if (source_ <= Source::Packets) {
+        source_ = Source::Packets;
+        media_ns_ += len * BYTE_NS;
+    }
+}
+
+void Clock::onEtiFrame(uint64_t stream_id, uint16_t dflc) {
+    if (source_ == Source::Pcr) return;
+
+    // Lock to the first stream delivering frames
+    if (source_ != Source::Frames) {
+        source_ = Source::Frames;
+        frame_stream_ = stream_id;
+        last_dflc_ = dflc;
+        media_ns_ += ETI_FRAME_NS;
+        return;
+    }
+    if (stream_id != frame_stream_) return;
+
+    // DFLC counts frames modulo 5000; no DFLC (ETI-NA) or a jump counts as one frame
+    uint64_t frames = (dflc + 5000 - last_dflc_) % 5000;
+    last_dflc_ = dflc;
+    if (frames == 0 || frames > 250) {
+        frames = 1;
+    }
+    media_ns_ += frames * ETI_FRAME_NS;
+}
+
+} // namespace dvbdab
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <dvbdab/dvbdab.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace dvbdab {
+
+// Time base for timeouts: wall clock, a custom function, or media time
+//
+// Media time is driven by the stream itself. Several sources can feed it;
+// the most precise one seen so far wins (PCR > ETI frames > TS packets or
+// bytes at a nominal rate) and time stays continuous when a better source
+// takes over. In media mode no system clock is read at all.
+class Clock {
+public:
+    // Rate assumed for media time from TS packet count (no PCR in the input)
+    static constexpr uint64_t NOMINAL_TS_BITRATE = 50'000'000;
+    static constexpr uint64_t BYTE_NS = 8 * 1'000'000'000ull / NOMINAL_TS_BITRATE;
+    static constexpr uint64_t TS_PACKET_NS = 188 * BYTE_NS;
+    static constexpr uint64_t ETI_FRAME_NS = 24'000'000;
+    static constexpr uint64_t MAX_PCR_STEP = 90'000;  // 1 s; larger steps are discontinuities
+
+    explicit Clock(ClockMode mode = ClockMode::Wall) : mode_(mode) {}
+
+    void setMode(ClockMode mode) { mode_ = mode; }
+    void setFunction(ClockFunction fn) { fn_ = std::move(fn); }
+
+    // True if the media time inputs below are used
+    bool isMedia() const { return mode_ == ClockMode::Media && !fn_; }
+
+    // Start (or restart) measuring elapsed time
+    void start();
+
+    // Milliseconds since start()
+    uint64_t elapsedMs() const;
+
+    // Media time inputs (only call when isMedia())
+    void onTsPacket(const uint8_t* ts);
+    void onBytes(size_t len);  // Input without TS headers (IP packets, TS payloads)
+    void onEtiFrame(uint64_t stream_id, uint16_t dflc);
+
+private:
+    enum class Source : uint8_t { None, Packets, Frames, Pcr };
+
+    ClockMode mode_;
+    ClockFunction fn_;
+    uint64_t fn_start_{0};
+    std::chrono::steady_clock::time_point wall_start_{};
+
+    // Media time state
+    uint64_t media_ns_{0};
+    Source source_{Source::None};
+    uint16_t pcr_pid_{0};
+    uint64_t last_pcr_{0};       // 90 kHz PCR base
+    uint64_t frame_stream_{0};
+    uint16_t last_dflc_{0};
+};
+
+} // namespace dvbdab
@@ -72,20 +72,28 @@ static inline const uint8_t* ts_get_payload(const uint8_t* ts) {
     return &ts[TS_HEADER_SIZE + 1 + ts[4]];
 }
 
-// Bitrate tables from ETSI EN 300 401
-static const int uep_bitrates[] = {
-    32, 32, 32, 32, 32,   // indices 0-4
-    48, 48, 48, 48, 48,   // indices 5-9
-    56, 56, 56, 56,       // indices 10-13
-    64, 64, 64, 64, 64, 64, 64,  // indices 14-20
-    80, 80, 80, 80, 80, 80,      // indices 21-26
-    96, 96, 96, 96, 96, 96,      // indices 27-32
-    112, 112, 112, 112,   // indices 33-36
-    128, 128, 128, 128, 128, 128, 128, // indices 37-43
-    160, 160, 160, 160, 160, 160, // indices 44-49
-    192, 192, 192, 192, 192, 192, 192, // indices 50-56
-    224, 224, 224, 224, 224, // indices 57-61
-    256, 256, 256          // indices 62-64
+// UEP sub-channel sizes (CUs), protection levels and bitrates (kbps),
+// ETSI EN 300 401 Table 6, indexed by the FIG 0/1 short form table index
+struct UepEntry {
+    int16_t size;
+    int8_t level;
+    int16_t bitrate;
+};
+static const UepEntry uep_table[64] = {
+    {16, 5, 32}, {21, 4, 32}, {24, 3, 32}, {29, 2, 32}, {35, 1, 32},
+    {24, 5, 48}, {29, 4, 48}, {35, 3, 48}, {42, 2, 48}, {52, 1, 48},
+    {29, 5, 56}, {35, 4, 56}, {42, 3, 56}, {52, 2, 56},
+    {32, 5, 64}, {42, 4, 64}, {48, 3, 64}, {58, 2, 64}, {70, 1, 64},
+    {40, 5, 80}, {52, 4, 80}, {58, 3, 80}, {70, 2, 80}, {84, 1, 80},
+    {48, 5, 96}, {58, 4, 96}, {70, 3, 96}, {84, 2, 96}, {104, 1, 96},
+    {58, 5, 112}, {70, 4, 112}, {84, 3, 112}, {104, 2, 112},
+    {64, 5, 128}, {84, 4, 128}, {96, 3, 128}, {116, 2, 128}, {140, 1, 128},
+    {80, 5, 160}, {104, 4, 160}, {116, 3, 160}, {140, 2, 160}, {168, 1, 160},
+    {96, 5, 192}, {116, 4, 192}, {140, 3, 192}, {168, 2, 192}, {208, 1, 192},
+    {116, 5, 224}, {140, 4, 224}, {168, 3, 224}, {208, 2, 224}, {232, 1, 224},
+    {128, 5, 256}, {168, 4, 256}, {192, 3, 256}, {232, 2, 256}, {280, 1, 256},
+    {160, 5, 320}, {208, 4, 320}, {280, 2, 320},
+    {192, 5, 384}, {280, 3, 384}, {416, 1, 384},
 };
 
 static int get_eep_bitrate(int subchsz, int protlvl) {
@@ -136,6 +144,8 @@ DABParser::~DABParser() = default;
 void DABParser::reset() {
     subchannels_.clear();
     service_map_.clear();
+    packet_mode_map_.clear();
+    packet_component_sid_.clear();
     service_labels_.clear();
     ensemble_label_.clear();
     ensemble_id_ = 0;
@@ -149,13 +159,14 @@ void DABParser::reset() {
     last_label_count_ = 0;
     label_stable_frames_ = 0;
     // Reset timestamp tracking
-    start_time_ = std::chrono::steady_clock::now();
+    frames_since_reset_ = 0;
     label_first_seen_ms_.clear();
     ensemble_label_first_seen_ms_ = -1;
 }
 
 bool DABParser::process_eti_frame(const uint8_t* frame, size_t len) {
     eti_call_count_++;
+    frames_since_reset_++;
 
     // Already complete - skip further processing
     if (labelled_) return true;
@@ -301,6 +312,7 @@ void DABParser::process_fib(const uint8_t* fib) {
     // Check FIB CRC
     bool debug = fib_count_ <= 10;
     if (!fib_crc_ok(fib, debug)) {
+        fib_crc_errors_++;
         if (debug) {
             LOG_WARN(SERVER, "FIB CRC fail - first 8 bytes: 0x" << std::hex
                      << (int)fib[0] << " 0x" << (int)fib[1] << " 0x" << (int)fib[2]
@@ -398,11 +410,10 @@ void DABParser::process_fig_0(const uint8_t* data, int len, int ext, int pd) {
                     int table_index = data[pos + 2] & 0x3F;
                     sc.eepprot = 0;
                     sc.uep_indx = table_index;
-                    // Size and bitrate from table
-                    if (table_index < 64) {
-                        sc.bitrate = uep_bitrates[table_index];
-                    }
-                    sc.subchsz = 0;  // TODO: lookup from table
+                    // Size, level and bitrate from table
+                    sc.subchsz = uep_table[table_index].size;
+                    sc.protlvl = uep_table[table_index].level - 1;
+                    sc.bitrate = uep_table[table_index].bitrate;
                     pos += 3;
                 } else {
                     // Long form (EEP)
@@ -472,7 +483,7 @@ void DABParser::process_fig_0(const uint8_t* data, int len, int ext, int pd) {
                             info.secondary_subch = subchid;
                         }
                     } else if (tmid == 1) {
-                        // Data (MSC packet mode)
+                        // Data (MSC stream mode)
                         int dscty = data[pos] & 0x3F;  // Data Service Component Type
                         int subchid = (data[pos + 1] >> 2) & 0x3F;
                         int primary = (data[pos + 1] >> 1) & 0x01;
@@ -481,11 +492,18 @@ void DABParser::process_fig_0(const uint8_t* data, int len, int ext, int pd) {
                                  << " subch=" << subchid
                                  << " DSCTy=" << dscty
                                  << " primary=" << primary
-                                 << " (packet mode)");
+                                 << " (stream mode)");
 
                         if (primary && info.primary_subch < 0) {
                             info.primary_subch = subchid;
                         }
+                    } else if (tmid == 3) {
+                        // Data (MSC packet mode) - subchannel comes from FIG 0/3
+                        int scid = ((data[pos] & 0x3F) << 6) | (data[pos + 1] >> 2);
+                        packet_component_sid_[scid] = sid;
+
+                        LOG_DEBUG(SERVER, "FIG 0/2: DATA SID=0x" << std::hex << sid << std::dec
+                                 << " SCId=" << scid << " (packet mode)");
                     }
                     pos += 2;
                 }
@@ -504,28 +522,26 @@ void DABParser::process_fig_0(const uint8_t* data, int len, int ext, int pd) {
         case 3: {
             // FIG 0/3 - Service Component in Packet Mode
             // Links SCId (Service Component ID) to SubChId for packet-mode data services
-            // Structure (5 bytes per entry):
-            //   Bytes 0-1: Rfa(4) + SCId(12)
-            //   Byte 2: Rfa(3) + SCCA_flag(1) + DG_flag(1) + Rfu(1) + DSCTy_high(2)
-            //   Byte 3: DSCTy_low(4) + SubChId(4) or DSCTy in low 6 bits
-            //   Byte 4: SubChId (low 6 bits)
+            // Structure (5 bytes per entry, EN 300 401 6.3.2):
+            //   Bytes 0-1: SCId(12) + Rfa(3) + CAOrg_flag(1)
+            //   Byte 2: DG_flag(1) + Rfu(1) + DSCTy(6)
+            //   Byte 3: SubChId(6) + PacketAddress_high(2)
+            //   Byte 4: PacketAddress_low(8)
+            //   Optional CAOrg (2 bytes) if CAOrg_flag
             int pos = 0;
             while (pos + 5 <= len) {
-                int scid = ((data[pos] & 0x0F) << 8) | data[pos + 1];
+                int scid = (data[pos] << 4) | (data[pos + 1] >> 4);
+                int scca_flag = data[pos + 1] & 0x01;
                 pos += 2;
 
-                // Flags byte
-                int scca_flag = (data[pos] >> 4) & 0x01;
-                int dg_flag = (data[pos] >> 3) & 0x01;
-                pos++;
-
-                // DSCTy in low 6 bits of next byte
+                // DG_flag: 0 = data groups are used
+                int dg_flag = ((data[pos] >> 7) & 0x01) == 0;
                 int dscty = data[pos] & 0x3F;
                 pos++;
 
-                // SubChId in low 6 bits of next byte
-                int subchid = data[pos] & 0x3F;
-                pos++;
+                int subchid = (data[pos] >> 2) & 0x3F;
+                int packet_addr = ((data[pos] & 0x03) << 8) | data[pos + 1];
+                pos += 2;
 
                 // Optional CA data if scca_flag
                 if (scca_flag && pos + 2 <= len) {
@@ -534,12 +550,13 @@ void DABParser::process_fig_0(const uint8_t* data, int len, int ext, int pd) {
 
                 LOG_DEBUG(SERVER, "FIG 0/3: SCId=" << scid
                          << " -> SubChId=" << subchid
+                         << " addr=" << packet_addr
                          << " DSCTy=" << dscty
                          << " DG=" << dg_flag
                          << " (packet mode data)");
 
                 // Store mapping for packet decoder
-                packet_mode_map_[scid] = {subchid, 0, dscty, dg_flag != 0};
+                packet_mode_map_[scid] = {subchid, packet_addr, dscty, dg_flag != 0};
             }
             break;
         }
@@ -694,8 +711,7 @@ void DABParser::process_fig_1(const uint8_t* data, int len, int ext) {
             ensemble_label_ = latin1_to_utf8(label, 16);
 
             // Track when ensemble label was first seen
-            auto now = std::chrono::steady_clock::now();
-            int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time_).count();
+            int64_t now_ms = frames_since_reset_ * 24;
             if (ensemble_label_first_seen_ms_ < 0) {
                 ensemble_label_first_seen_ms_ = now_ms;
                 LOG_DEBUG(SERVER, "FIG 1/0: Ensemble EID=0x" << std::hex << ensemble_id_
@@ -730,8 +746,7 @@ void DABParser::process_fig_1(const uint8_t* data, int len, int ext) {
             fig11_count_++;
 
             // Track when each label was first seen
-            auto now = std::chrono::steady_clock::now();
-            int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time_).count();
+            int64_t now_ms = frames_since_reset_ * 24;
             if (label_first_seen_ms_.count(sid) == 0) {
                 label_first_seen_ms_[sid] = now_ms;
                 LOG_DEBUG(SERVER, "FIG 1/1: SID=0x" << std::hex << sid << std::dec
@@ -777,6 +792,32 @@ void DABParser::build_ensemble() {
         ensemble_.services.push_back(svc);
     }
 
+    ensemble_.subchannels.clear();
+    for (const auto& [subchid, sc] : subchannels_) {
+        DABSubchannel sub;
+        sub.subchannel_id = sc.subchid;
+        sub.start_addr = sc.startaddr;
+        sub.size = sc.subchsz;
+        sub.bitrate = sc.bitrate;
+        sub.protection_level = sc.protlvl;
+        sub.eep_protection = (sc.eepprot == 1);
+        sub.dabplus = (sc.dabplus == 1);
+        ensemble_.subchannels.push_back(sub);
+    }
+
+    ensemble_.packet_components.clear();
+    for (const auto& [scid, info] : packet_mode_map_) {
+        DABPacketComponent pc;
+        auto sid_it = packet_component_sid_.find(scid);
+        pc.sid = (sid_it != packet_component_sid_.end()) ? sid_it->second : 0;
+        pc.scid = scid;
+        pc.subchannel_id = info.subchid;
+        pc.packet_addr = info.packet_addr;
+        pc.dscty = info.dscty;
+        pc.dg_flag = info.dg_flag;
+        ensemble_.packet_components.push_back(pc);
+    }
+
     // Sort by SID
     std::sort(ensemble_.services.begin(), ensemble_.services.end(),
               [](const DABService& a, const DABService& b) { return a.sid < b.sid; });
@@ -800,9 +841,20 @@ void PF_Reassembler::reset() {
     af_buffer_.clear();
 }
 
-void PF_Reassembler::cleanup_old_collectors() {
+void PF_Reassembler::cleanup_old_collectors(uint16_t current_pseq) {
     // Remove completed collectors when we have too many
     if (collectors_.size() > 16) {
+        // Incomplete collectors far behind the current pseq lost a fragment
+        for (auto it = collectors_.begin(); it != collectors_.end();) {
+            uint16_t age = static_cast<uint16_t>(current_pseq - it->first);
+            if (!it->second.processed && age > NUM_PF_COLLECTORS && age < 0x8000) {
+                expired_count_++;
+                it = collectors_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
         auto it = collectors_.begin();
         while (collectors_.size() > 8 && it != collectors_.end()) {
             if (it->second.processed) {
@@ -893,7 +945,7 @@ const uint8_t* PF_Reassembler::add_fragment(const PF_Header& hdr, const uint8_t*
     }
 
     // Cleanup old collectors
-    cleanup_old_collectors();
+    cleanup_old_collectors(hdr.pseq);
 
     af_len = af_buffer_.size();
     return af_buffer_.data();
@@ -7,7 +7,6 @@
 #include <array>
 #include <deque>
 #include <functional>
-#include <chrono>
 
 namespace lsdvb {
 
@@ -24,11 +23,34 @@ struct DABService {
     bool eep_protection;    // EEP (true) or UEP (false)
 };
 
+// Sub-channel in the MSC (FIG 0/1), audio or data
+struct DABSubchannel {
+    int subchannel_id;      // Sub-channel ID
+    int start_addr;         // Start address in CUs
+    int size;               // Size in CUs
+    int bitrate;            // Bitrate in kbps
+    int protection_level;   // EEP: 0-3 = 1A-4A, 4-7 = 1B-4B; UEP: 0-4 = level 1-5
+    bool eep_protection;    // EEP (true) or UEP (false)
+    bool dabplus;           // true for DAB+ audio
+};
+
+// Packet-mode data service component (FIG 0/2 TMId=3 + FIG 0/3)
+struct DABPacketComponent {
+    uint32_t sid;           // Service ID (0 if not yet signalled in FIG 0/2)
+    int scid;               // Service Component ID
+    int subchannel_id;      // Sub-channel carrying the packets
+    int packet_addr;        // Packet address (10 bits)
+    int dscty;              // Data Service Component Type (60 = MOT)
+    bool dg_flag;           // Data groups used
+};
+
 // DAB Ensemble Information
 struct DABEnsemble {
     uint16_t eid;           // Ensemble ID
     std::string label;      // Ensemble label
     std::vector<DABService> services;
+    std::vector<DABPacketComponent> packet_components;
+    std::vector<DABSubchannel> subchannels;  // Sorted by sub-channel ID
 };
 
 // ETI Frame Constants - sync word includes ERR byte (0xFF) + FSYNC pattern
@@ -99,6 +121,9 @@ public:
     // This allows early audio start before labels are available
     bool is_basic_ready() const { return basic_ready_; }
 
+    // FIBs dropped on CRC error (not cleared by reset)
+    size_t get_fib_crc_errors() const { return fib_crc_errors_; }
+
 private:
     // Process FIC data from ETI frame
     void process_fic(const uint8_t* fic_data, int fic_len, int mode_id);
@@ -142,14 +167,16 @@ private:
         bool dg_flag;  // Data Group flag
     };
     std::map<int, PacketModeInfo> packet_mode_map_;  // SCId -> info
+    std::map<int, uint32_t> packet_component_sid_;   // SCId -> SID (FIG 0/2 TMId=3)
 
     // Labels
     std::map<uint32_t, std::string> service_labels_;
     std::string ensemble_label_;
     uint16_t ensemble_id_;
 
-    // Debug: Track when labels were first seen (milliseconds from parser start)
-    std::chrono::steady_clock::time_point start_time_;
+    // Debug: Track when labels were first seen (stream time in ms since reset,
+    // 24 ms per ETI frame - no clock reads in the FIG path)
+    int64_t frames_since_reset_ = 0;
     std::map<uint32_t, int64_t> label_first_seen_ms_;  // SID -> first seen time
     int64_t ensemble_label_first_seen_ms_ = -1;
 
@@ -176,6 +203,8 @@ private:
     int fig02_count_ = 0;
     int fig11_count_ = 0;
 
+    size_t fib_crc_errors_ = 0;
+
     // Build final ensemble from parsed components
     void build_ensemble();
 };
@@ -255,11 +284,15 @@ public:
     // Returns pointer to internal buffer (valid until next call)
     const uint8_t* add_fragment(const PF_Header& hdr, const uint8_t* pkt, size_t len, size_t& af_len);
 
+    // Incomplete AF packets given up (fragments lost; not cleared by reset)
+    size_t get_expired_count() const { return expired_count_; }
+
 private:
     std::map<uint16_t, PF_Collector> collectors_;  // Keyed by pseq - no collisions
     std::vector<uint8_t> af_buffer_;
+    size_t expired_count_ = 0;
 
-    void cleanup_old_collectors();
+    void cleanup_old_collectors(uint16_t current_pseq);
 };
 
 // MPE/PSI section accumulator with queue for back-to-back sections
@@ -352,6 +385,10 @@ public:
     // Check if parser has received any useful data (ETI frames)
     bool has_data() const;
 
+    // Error counters (for monitoring / flight recorder triggers)
+    size_t get_fib_crc_errors() const { return fic_parser_.get_fib_crc_errors(); }
+    size_t get_pf_expired_count() const { return pf_reassembler_.get_expired_count(); }
+
     // Set callback for ETI frames (called for each 6144-byte frame)
     void setEtiCallback(EtiFrameCallback cb) { eti_callback_ = std::move(cb); }
 
@@ -413,7 +450,6 @@ private:
     std::vector<uint8_t> pending_ring_buffer_;
     bool ring_buffer_pending_ = false;
     bool ring_buffer_processed_ = false;
-    std::chrono::steady_clock::time_point ring_buffer_start_time_;
     static constexpr int RING_BUFFER_DELAY_MS = 3000;  // Wait 3s of live data before processing buffer
 };
 
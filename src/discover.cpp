@@ -4,107 +4,196 @@
 #include "sources/gse_ts_source.hpp"
 #include "sources/bbf_ts_source.hpp"
 #include "sources/mpe_ts_source.hpp"
+#include "sources/dvr_reader.hpp"
+#include "sources/ts_sync.hpp"
 #include "parsers/udp_extractor.hpp"
+#include "parsers/tsni_framer.hpp"
 #include "ensemble_manager.hpp"
+#include "etina_pipeline.hpp"
+#include "clock.hpp"
+#include <atomic>
 #include <fstream>
-#include <chrono>
-#include <unistd.h>
-#include <poll.h>
 
 namespace dvbdab {
 
-std::vector<DiscoveredEnsemble> discoverEnsembles(
-    const std::string& file_path,
-    InputFormat format,
-    uint16_t pid,
-    unsigned int timeout_ms)
-{
-    std::vector<DiscoveredEnsemble> results;
+namespace {
+
+// Convert parser ensemble to public discovery result
+DiscoveredEnsemble toDiscovered(const StreamKey& key, const lsdvb::DABEnsemble& ens) {
+    DiscoveredEnsemble de;
+    de.ip = key.ip;
+    de.port = key.port;
+    de.eid = ens.eid;
+    de.label = ens.label;
+
+    // Copy service info
+    for (const auto& svc : ens.services) {
+        DiscoveredService ds;
+        ds.sid = svc.sid;
+        ds.label = svc.label;
+        ds.bitrate = svc.bitrate;
+        ds.subchannel_id = static_cast<uint8_t>(svc.subchannel_id);
+        ds.dabplus = svc.dabplus;
+        de.services.push_back(ds);
+    }
+    return de;
+}
 
-    std::ifstream file(file_path, std::ios::binary);
-    if (!file) {
-        return results;  // Empty result on file open failure
+// Payload of a TS packet (after any adaptation field), nullptr if none
+const uint8_t* tsPayload(const uint8_t* ts, size_t& len) {
+    size_t offset = TS_HEADER_SIZE;
+    if (!(ts[3] & 0x10)) return nullptr;
+    if (ts[3] & 0x20) {
+        offset += 1 + ts[4];
     }
+    if (offset >= TS_PACKET_SIZE) return nullptr;
+    len = TS_PACKET_SIZE - offset;
+    return ts + offset;
+}
 
-    // Create ensemble manager
+// Shared pipeline for file and fd discovery:
+// InputSource -> UdpExtractor -> EnsembleManager -> results (+ progressive callback)
+struct DiscoverySession {
+    const DiscoveryOptions& options;
+    std::vector<DiscoveredEnsemble> results;
     EnsembleManager manager;
+    UdpExtractor udp_extractor;
+    std::unique_ptr<InputSource> source;
+    EnsembleFormat ensemble_format{EnsembleFormat::MPE};
+    Clock clock;
+    TsSync clock_sync;  // Media time: the sources keep their TS packets internal
+    bool stopped{false};  // Callback asked to stop
+
+    DiscoverySession(InputFormat format, uint16_t pid, const DiscoveryOptions& opts)
+        : options(opts)
+        , udp_extractor([this](uint32_t ip, uint16_t port, const uint8_t* payload, size_t len) {
+              manager.processUdp(ip, port, payload, len);
+          })
+        , clock(opts.clock_mode)
+    {
+        // Media time follows the DFLC of the EDI streams
+        if (options.clock) {
+            clock.setFunction(options.clock);
+        } else if (clock.isMedia()) {
+            manager.setEtiCallback([this](const StreamKey& key, const uint8_t*, size_t, uint16_t dflc) {
+                clock.onEtiFrame((static_cast<uint64_t>(key.ip) << 16) | key.port, dflc);
+            });
+        }
 
-    // Track discovered ensembles (with full service info)
-    manager.setCompleteCallback([&results](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
-        DiscoveredEnsemble de;
-        de.ip = key.ip;
-        de.port = key.port;
-        de.eid = ens.eid;
-        de.label = ens.label;
-
-        // Copy service info
-        for (const auto& svc : ens.services) {
-            DiscoveredService ds;
-            ds.sid = svc.sid;
-            ds.label = svc.label;
-            ds.bitrate = svc.bitrate;
-            ds.subchannel_id = static_cast<uint8_t>(svc.subchannel_id);
-            ds.dabplus = svc.dabplus;
-            de.services.push_back(ds);
+        // Basic-ready reports are only needed for progressive callers
+        if (options.on_ensemble && options.report_basic_ready) {
+            manager.setBasicReadyCallback([this](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
+                DiscoveredEnsemble de = toDiscovered(key, ens);
+                de.format = ensemble_format;
+                notify(de, false);
+            });
         }
-        results.push_back(de);
-    });
 
-    // Create UDP extractor
-    UdpExtractor udp_extractor([&](uint32_t ip, uint16_t port,
-                                    const uint8_t* payload, size_t len) {
-        manager.processUdp(ip, port, payload, len);
-    });
+        // Track discovered ensembles (with full service info)
+        manager.setCompleteCallback([this](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
+            results.push_back(toDiscovered(key, ens));
+            results.back().format = ensemble_format;
+            notify(results.back(), true);
+        });
 
-    // Create appropriate input source
-    std::unique_ptr<InputSource> source;
+        switch (format) {
+            case InputFormat::GSE:
+                source = std::make_unique<GseTsSource>();
+                ensemble_format = EnsembleFormat::GSE;
+                break;
+            case InputFormat::BBF:
+                source = std::make_unique<BbfTsSource>();
+                ensemble_format = EnsembleFormat::BBF;
+                break;
+            case InputFormat::MPE:
+                source = std::make_unique<MpeTsSource>(pid);
+                break;
+        }
 
-    switch (format) {
-        case InputFormat::GSE:
-            source = std::make_unique<GseTsSource>();
-            break;
-        case InputFormat::BBF:
-            source = std::make_unique<BbfTsSource>();
-            break;
-        case InputFormat::MPE:
-            source = std::make_unique<MpeTsSource>(pid);
-            break;
+        // Connect source to UDP extractor
+        source->setIpCallback([this](const uint8_t* ip_data, size_t len) {
+            udp_extractor.process(ip_data, len, clock);
+        });
     }
 
-    // Connect source to UDP extractor
-    source->setIpCallback([&](const uint8_t* ip_data, size_t len) {
-        udp_extractor.process(ip_data, len);
-    });
+    void feed(const uint8_t* data, size_t len) {
+        if (clock.isMedia()) {
+            clock_sync.feed(data, len, [this](const uint8_t* ts) { clock.onTsPacket(ts); });
+        }
+        source->feed(data, len);
+    }
+
+    void notify(const DiscoveredEnsemble& de, bool complete) {
+        if (options.on_ensemble && !stopped && !options.on_ensemble(de, complete)) {
+            stopped = true;
+        }
+    }
+
+    // Stop requested by callback/stop_token, or all discovered streams complete
+    bool finished() const {
+        if (stopped || options.stop_token.stop_requested()) {
+            return true;
+        }
+        return manager.allComplete() && manager.getCompleteCount() > 0;
+    }
+
+    void flush() {
+        // Flush BBF source if applicable
+        if (auto* bbf = dynamic_cast<BbfTsSource*>(source.get())) {
+            bbf->flush();
+        }
+    }
+};
+
+} // namespace
+
+std::vector<DiscoveredEnsemble> discoverEnsembles(
+    const std::string& file_path,
+    InputFormat format,
+    uint16_t pid,
+    unsigned int timeout_ms)
+{
+    return discoverEnsembles(file_path, format, pid, timeout_ms, DiscoveryOptions{});
+}
+
+std::vector<DiscoveredEnsemble> discoverEnsembles(
+    const std::string& file_path,
+    InputFormat format,
+    uint16_t pid,
+    unsigned int timeout_ms,
+    const DiscoveryOptions& options)
+{
+    std::ifstream file(file_path, std::ios::binary);
+    if (!file) {
+        return {};  // Empty result on file open failure
+    }
+
+    DiscoverySession session(format, pid, options);
 
     // Process file with timeout
-    auto start_time = std::chrono::steady_clock::now();
+    session.clock.start();
     std::vector<uint8_t> buffer(65536);
 
     while (file.read(reinterpret_cast<char*>(buffer.data()), buffer.size()) || file.gcount()) {
         size_t bytes_read = file.gcount();
-        source->feed(buffer.data(), bytes_read);
+        session.feed(buffer.data(), bytes_read);
 
         // Check timeout
-        auto elapsed = std::chrono::steady_clock::now() - start_time;
-        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
-        if (static_cast<unsigned int>(elapsed_ms) >= timeout_ms) {
+        if (session.clock.elapsedMs() >= timeout_ms) {
             break;
         }
 
-        // Early exit if all discovered streams are complete
-        if (manager.allComplete() && manager.getCompleteCount() > 0) {
+        // Early exit if all discovered streams are complete (or cancelled)
+        if (session.finished()) {
             break;
         }
     }
 
-    // Flush BBF source if applicable
-    if (format == InputFormat::BBF) {
-        if (auto* bbf = dynamic_cast<BbfTsSource*>(source.get())) {
-            bbf->flush();
-        }
+    if (!session.stopped) {
+        session.flush();
     }
 
-    return results;
+    return std::move(session.results);
 }
 
 std::vector<DiscoveredEnsemble> discoverEnsemblesFromFd(
@@ -113,102 +202,54 @@ std::vector<DiscoveredEnsemble> discoverEnsemblesFromFd(
     uint16_t pid,
     unsigned int timeout_ms)
 {
-    std::vector<DiscoveredEnsemble> results;
+    return discoverEnsemblesFromFd(fd, format, pid, timeout_ms, DiscoveryOptions{});
+}
 
+std::vector<DiscoveredEnsemble> discoverEnsemblesFromFd(
+    int fd,
+    InputFormat format,
+    uint16_t pid,
+    unsigned int timeout_ms,
+    const DiscoveryOptions& options)
+{
     if (fd < 0) {
-        return results;
+        return {};
     }
 
-    // Create ensemble manager
-    EnsembleManager manager;
-
-    // Track discovered ensembles (with full service info)
-    manager.setCompleteCallback([&results](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
-        DiscoveredEnsemble de;
-        de.ip = key.ip;
-        de.port = key.port;
-        de.eid = ens.eid;
-        de.label = ens.label;
-
-        // Copy service info
-        for (const auto& svc : ens.services) {
-            DiscoveredService ds;
-            ds.sid = svc.sid;
-            ds.label = svc.label;
-            ds.bitrate = svc.bitrate;
-            ds.subchannel_id = static_cast<uint8_t>(svc.subchannel_id);
-            ds.dabplus = svc.dabplus;
-            de.services.push_back(ds);
-        }
-        results.push_back(de);
-    });
-
-    // Create UDP extractor
-    UdpExtractor udp_extractor([&](uint32_t ip, uint16_t port,
-                                    const uint8_t* payload, size_t len) {
-        manager.processUdp(ip, port, payload, len);
-    });
-
-    // Create appropriate input source
-    std::unique_ptr<InputSource> source;
+    DiscoverySession session(format, pid, options);
 
-    switch (format) {
-        case InputFormat::GSE:
-            source = std::make_unique<GseTsSource>();
-            break;
-        case InputFormat::BBF:
-            source = std::make_unique<BbfTsSource>();
-            break;
-        case InputFormat::MPE:
-            source = std::make_unique<MpeTsSource>(pid);
-            break;
+    // Reader thread batches reads from the fd; this loop only parses
+    DvrReader reader(fd);
+    if (!reader.start()) {
+        return {};
     }
 
-    // Connect source to UDP extractor
-    source->setIpCallback([&](const uint8_t* ip_data, size_t len) {
-        udp_extractor.process(ip_data, len);
-    });
-
-    // Process fd with timeout
-    auto start_time = std::chrono::steady_clock::now();
-    std::vector<uint8_t> buffer(65536);
+    session.clock.start();
 
-    while (true) {
-        // Check timeout
-        auto elapsed = std::chrono::steady_clock::now() - start_time;
-        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
-        if (static_cast<unsigned int>(elapsed_ms) >= timeout_ms) {
+    while (!reader.finished()) {
+        uint64_t elapsed_ms = session.clock.elapsedMs();
+        if (elapsed_ms >= timeout_ms) {
             break;
         }
+        uint64_t remaining_ms = timeout_ms - elapsed_ms;
+        unsigned int wait_ms = remaining_ms > 100 ? 100 : static_cast<unsigned int>(remaining_ms);
 
-        // Poll for data
-        struct pollfd pfd = { .fd = fd, .events = POLLIN, .revents = 0 };
-        int remaining_ms = timeout_ms - static_cast<unsigned int>(elapsed_ms);
-        int poll_timeout = (remaining_ms > 100) ? 100 : remaining_ms;
-
-        if (poll(&pfd, 1, poll_timeout) > 0 && (pfd.revents & POLLIN)) {
-            ssize_t bytes_read = read(fd, buffer.data(), buffer.size());
-            if (bytes_read > 0) {
-                source->feed(buffer.data(), static_cast<size_t>(bytes_read));
-            } else if (bytes_read == 0) {
-                break;  // EOF
-            }
-        }
+        reader.consume([&session](const uint8_t* data, size_t len) {
+            session.feed(data, len);
+        }, wait_ms);
 
-        // Early exit if all discovered streams are complete
-        if (manager.allComplete() && manager.getCompleteCount() > 0) {
+        // Early exit if all discovered streams are complete (or cancelled)
+        if (session.finished()) {
             break;
         }
     }
+    reader.stop();
 
-    // Flush BBF source if applicable
-    if (format == InputFormat::BBF) {
-        if (auto* bbf = dynamic_cast<BbfTsSource*>(source.get())) {
-            bbf->flush();
-        }
+    if (!session.stopped) {
+        session.flush();
     }
 
-    return results;
+    return std::move(session.results);
 }
 
 // =============================================================================
@@ -216,47 +257,132 @@ std::vector<DiscoveredEnsemble> discoverEnsemblesFromFd(
 // =============================================================================
 
 struct EnsembleDiscovery::Impl {
+    // Fail-fast limits for feedTsPacket() / feedPayload()
+    static constexpr size_t MPE_SECTION_PACKETS = 64;    // Packets without an MPE section
+    static constexpr size_t GSE_PACKETS = 64;            // Packets without a GSE packet
+    static constexpr size_t GSE_IP_PACKETS = 32;         // GSE packets without IPv4
+    static constexpr size_t BBF_HEADER_ERRORS = 8;       // Packets without the pseudo-TS header
+    static constexpr size_t BBF_START_PACKETS = 64;      // Packets without a BBFrame start
+    static constexpr size_t BBF_IP_FRAMES = 16;          // BBFrames without IPv4
+    static constexpr size_t ETINA_SYNC_BYTES = 16 * 1024;   // Payload without E1 sync
+    static constexpr size_t ETINA_FRAME_BYTES = 64 * 1024;  // Payload without an ETI frame
+    static constexpr size_t TSNI_PUSI_BYTES = 16 * 1024;    // Payload without PUSI
+    static constexpr size_t TSNI_SEQ_PUSIS = 8;             // PUSIs without a frame sequence
+
     EnsembleManager manager;
     UdpExtractor udp_extractor;
     std::vector<DiscoveredEnsemble> results;
 
     unsigned int early_timeout_ms;
     unsigned int total_timeout_ms;
-    std::chrono::steady_clock::time_point start_time;
+    Clock clock;
 
     bool multicast_seen{false};
     bool done{false};
     bool failed{false};
 
+    // Input format for feedTsPacket() / feedPayload()
+    EnsembleFormat format{EnsembleFormat::MPE};
+    uint16_t pid{0};
+    bool format_set{false};
+    TsSync ts_sync;
+    std::unique_ptr<MpeTsSource> mpe_source;
+    std::unique_ptr<GseTsSource> gse_source;
+    std::unique_ptr<BbfTsSource> bbf_source;
+    EtinaPipelineState etina;
+    TsniFramer tsni;
+
+    // Evidence for the fail-fast rules
+    size_t payload_count{0};
+    size_t payload_bytes{0};
+    size_t eti_frame_count{0};
+    size_t bbf_header_errors{0};
+    bool ip_seen{false};
+
+    // Progressive reporting
+    EnsembleFoundCallback ensemble_callback;
+    bool report_basic_ready{false};
+    std::atomic<bool> cancelled{false};
+
     Impl(unsigned int early_ms, unsigned int total_ms)
         : udp_extractor([this](uint32_t ip, uint16_t port, const uint8_t* payload, size_t len) {
               onUdp(ip, port, payload, len);
           })
         , early_timeout_ms(early_ms)
         , total_timeout_ms(total_ms)
-        , start_time(std::chrono::steady_clock::now())
     {
+        clock.start();
+
+        manager.setBasicReadyCallback([this](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
+            if (report_basic_ready) {
+                notify(discovered(key, ens), false);
+            }
+        });
+
         // Set up ensemble complete callback
         manager.setCompleteCallback([this](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
-            DiscoveredEnsemble de;
-            de.ip = key.ip;
-            de.port = key.port;
-            de.eid = ens.eid;
-            de.label = ens.label;
-
-            for (const auto& svc : ens.services) {
-                DiscoveredService ds;
-                ds.sid = svc.sid;
-                ds.label = svc.label;
-                ds.bitrate = svc.bitrate;
-                ds.subchannel_id = static_cast<uint8_t>(svc.subchannel_id);
-                ds.dabplus = svc.dabplus;
-                de.services.push_back(ds);
-            }
-            results.push_back(de);
+            results.push_back(discovered(key, ens));
+            notify(results.back(), true);
         });
     }
 
+    void setFormat(EnsembleFormat fmt, uint16_t target_pid) {
+        format = fmt;
+        pid = target_pid;
+        format_set = true;
+
+        auto on_ip = [this](const uint8_t* ip_data, size_t len) {
+            ip_seen = true;
+            udp_extractor.process(ip_data, len, clock);
+        };
+        switch (format) {
+            case EnsembleFormat::MPE:
+                mpe_source = std::make_unique<MpeTsSource>(pid);
+                mpe_source->setIpCallback(on_ip);
+                break;
+            case EnsembleFormat::GSE:
+                gse_source = std::make_unique<GseTsSource>();
+                gse_source->setIpCallback(on_ip);
+                break;
+            case EnsembleFormat::BBF:
+                bbf_source = std::make_unique<BbfTsSource>();
+                bbf_source->setIpCallback(on_ip);
+                break;
+            case EnsembleFormat::ETI_NA:
+            case EnsembleFormat::TSNI:
+                break;
+        }
+    }
+
+    DiscoveredEnsemble discovered(const StreamKey& key, const lsdvb::DABEnsemble& ens) const {
+        DiscoveredEnsemble de = toDiscovered(key, ens);
+        if (!format_set) {
+            return de;
+        }
+        de.format = format;
+        de.pid = pid;
+        if (format == EnsembleFormat::ETI_NA) {
+            // Keyed by PID, no IP
+            de.ip = 0;
+            de.port = 0;
+            de.is_etina = true;
+            de.etina_info.padding_bytes = etina.offset.detected_offset;
+            de.etina_info.sync_bit_offset = etina.e1.bit_offset;
+            de.etina_info.inverted = etina.e1.inverted;
+        } else if (format == EnsembleFormat::TSNI) {
+            de.ip = 0;
+            de.port = 0;
+            de.is_tsni = true;
+        }
+        return de;
+    }
+
+    void notify(const DiscoveredEnsemble& de, bool complete) {
+        if (ensemble_callback && !done && !ensemble_callback(de, complete)) {
+            done = true;  // Caller found what it was looking for
+        }
+    }
+
     void onUdp(uint32_t ip, uint16_t port, const uint8_t* payload, size_t len) {
         // Check for multicast IP (224.x.x.x - 239.x.x.x)
         uint8_t first_octet = (ip >> 24) & 0xFF;
@@ -266,19 +392,157 @@ struct EnsembleDiscovery::Impl {
         }
     }
 
+    void onEtiFrame(const uint8_t* eti, size_t len) {
+        eti_frame_count++;
+        manager.processEtiFrame(pid, eti, len);
+    }
+
+    void onPayload(const uint8_t* payload, size_t len, bool pusi) {
+        payload_count++;
+        payload_bytes += len;
+
+        switch (format) {
+            case EnsembleFormat::MPE:
+                mpe_source->feedPayload(payload, len, pusi);
+                break;
+            case EnsembleFormat::GSE:
+                gse_source->feedPayload(payload, len);
+                break;
+            case EnsembleFormat::BBF:
+                checkBbfHeader(payload, len);
+                bbf_source->feedPayload(payload, len);
+                break;
+            case EnsembleFormat::ETI_NA:
+                etina_feed_payload(etina, payload, len, [this](const uint8_t* eti, size_t eti_len) {
+                    onEtiFrame(eti, eti_len);
+                });
+                break;
+            case EnsembleFormat::TSNI:
+                tsni.feedPayload(payload, len, pusi, [this](const uint8_t* eti, size_t eti_len) {
+                    if (tsni.isConfirmed()) {
+                        onEtiFrame(eti, eti_len);
+                    }
+                });
+                break;
+        }
+    }
+
+    // Every packet of a BBF pseudo-TS starts with 00 80 00 and a length
+    void checkBbfHeader(const uint8_t* payload, size_t len) {
+        if (len < 4 || payload[0] != 0x00 || payload[1] != 0x80 || payload[2] != 0x00 || payload[3] > len - 4) {
+            bbf_header_errors++;
+        }
+    }
+
+    void onTsPacket(const uint8_t* ts) {
+        if (clock.isMedia()) {
+            clock.onTsPacket(ts);
+        }
+        if ((((ts[1] & 0x1F) << 8) | ts[2]) != pid) {
+            return;
+        }
+
+        // The IP sources check continuity themselves
+        switch (format) {
+            case EnsembleFormat::MPE:
+                payload_count++;
+                mpe_source->feedPacket(ts);
+                return;
+            case EnsembleFormat::GSE:
+                payload_count++;
+                gse_source->feedPacket(ts);
+                return;
+            case EnsembleFormat::BBF:
+                payload_count++;
+                checkBbfHeader(ts + TS_HEADER_SIZE, TS_PACKET_SIZE - TS_HEADER_SIZE);
+                bbf_source->feedPacket(ts);
+                return;
+            case EnsembleFormat::ETI_NA:
+            case EnsembleFormat::TSNI:
+                break;
+        }
+
+        size_t len = 0;
+        const uint8_t* payload = tsPayload(ts, len);
+        if (payload) {
+            onPayload(payload, len, (ts[1] >> 6) & 1);
+        }
+    }
+
+    // The fed PID evidently carries no DAB
+    bool noDab() const {
+        switch (format) {
+            case EnsembleFormat::MPE:
+                return payload_count >= MPE_SECTION_PACKETS && mpe_source->getMpeSectionCount() == 0;
+            case EnsembleFormat::GSE: {
+                size_t gse = gse_source->getGsePacketCount();
+                return (payload_count >= GSE_PACKETS && gse == 0) ||
+                       (gse >= GSE_IP_PACKETS && !ip_seen);
+            }
+            case EnsembleFormat::BBF: {
+                size_t frames = bbf_source->getBbfFrameCount();
+                return (bbf_header_errors >= BBF_HEADER_ERRORS && !ip_seen) ||
+                       (payload_count >= BBF_START_PACKETS && frames == 0) ||
+                       (frames >= BBF_IP_FRAMES && !ip_seen);
+            }
+            case EnsembleFormat::ETI_NA:
+                return (payload_bytes >= ETINA_SYNC_BYTES && !etina.e1.sync_found) ||
+                       (payload_bytes >= ETINA_FRAME_BYTES && eti_frame_count == 0);
+            case EnsembleFormat::TSNI:
+                return (payload_bytes >= TSNI_PUSI_BYTES && tsni.getPusiCount() == 0) ||
+                       (tsni.getPusiCount() >= TSNI_SEQ_PUSIS && !tsni.isConfirmed());
+        }
+        return false;
+    }
+
+    // Before a feed call: true (with the result) if discovery has ended
+    bool ended(int& result) {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            done = true;
+        }
+        if (done) {
+            result = results.empty() ? -1 : 1;
+            return true;
+        }
+        return false;
+    }
+
+    // After a feed call
+    int status(bool check_format) {
+        // Stopped from ensemble callback
+        if (done) {
+            return 1;
+        }
+
+        // Check if all ensembles complete (ETI formats carry a single ensemble)
+        if ((manager.allComplete() && manager.getCompleteCount() > 0) ||
+            (eti_frame_count > 0 && !results.empty())) {
+            done = true;
+            return 1;
+        }
+
+        if (check_format && noDab()) {
+            failed = true;
+            done = true;
+            return -1;
+        }
+
+        // Check timeouts
+        return checkTimeout();
+    }
+
     int checkTimeout() {
-        auto elapsed = std::chrono::steady_clock::now() - start_time;
-        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+        uint64_t elapsed_ms = clock.elapsedMs();
 
-        // Early timeout: no multicast seen within early_timeout_ms
-        if (!multicast_seen && static_cast<unsigned int>(elapsed_ms) >= early_timeout_ms) {
+        // Early timeout: no multicast (or ETI frame) seen within early_timeout_ms
+        if (!multicast_seen && eti_frame_count == 0 && elapsed_ms >= early_timeout_ms) {
             failed = true;
             done = true;
             return -1;
         }
 
         // Total timeout
-        if (static_cast<unsigned int>(elapsed_ms) >= total_timeout_ms) {
+        if (elapsed_ms >= total_timeout_ms) {
             done = true;
             return results.empty() ? -1 : 1;
         }
@@ -296,21 +560,91 @@ EnsembleDiscovery::~EnsembleDiscovery() = default;
 
 int EnsembleDiscovery::feedIpPacket(const uint8_t* ip_data, size_t len)
 {
-    if (impl_->done) {
-        return impl_->results.empty() ? -1 : 1;
+    int result;
+    if (impl_->ended(result)) {
+        return result;
     }
 
     // Process IP packet
-    impl_->udp_extractor.process(ip_data, len);
+    if (impl_->clock.isMedia()) {
+        impl_->clock.onBytes(len);
+    }
+    impl_->udp_extractor.process(ip_data, len, impl_->clock);
 
-    // Check if all ensembles complete
-    if (impl_->manager.allComplete() && impl_->manager.getCompleteCount() > 0) {
-        impl_->done = true;
-        return 1;
+    return impl_->status(false);
+}
+
+void EnsembleDiscovery::setFormat(EnsembleFormat format, uint16_t pid)
+{
+    impl_->setFormat(format, pid);
+}
+
+int EnsembleDiscovery::feedTsPacket(const uint8_t* data, size_t len)
+{
+    if (!impl_->format_set) {
+        return -1;
     }
 
-    // Check timeouts
-    return impl_->checkTimeout();
+    int result;
+    if (impl_->ended(result)) {
+        return result;
+    }
+
+    impl_->ts_sync.feed(data, len, [this](const uint8_t* ts) {
+        if (!impl_->done) {
+            impl_->onTsPacket(ts);
+        }
+    });
+
+    return impl_->status(true);
+}
+
+int EnsembleDiscovery::feedPayload(const uint8_t* payload, size_t len, bool pusi)
+{
+    if (!impl_->format_set) {
+        return -1;
+    }
+
+    int result;
+    if (impl_->ended(result)) {
+        return result;
+    }
+
+    if (impl_->clock.isMedia()) {
+        impl_->clock.onBytes(TS_PACKET_SIZE);  // One TS packet each
+    }
+    impl_->onPayload(payload, len, pusi);
+
+    return impl_->status(true);
+}
+
+void EnsembleDiscovery::setEnsembleCallback(EnsembleFoundCallback callback, bool report_basic_ready)
+{
+    impl_->ensemble_callback = std::move(callback);
+    impl_->report_basic_ready = report_basic_ready;
+}
+
+void EnsembleDiscovery::setClock(ClockMode mode)
+{
+    impl_->clock.setMode(mode);
+    if (impl_->clock.isMedia()) {
+        // Media time follows the DFLC of the EDI streams
+        impl_->manager.setEtiCallback([this](const StreamKey& key, const uint8_t*, size_t, uint16_t dflc) {
+            impl_->clock.onEtiFrame((static_cast<uint64_t>(key.ip) << 16) | key.port, dflc);
+        });
+    }
+    impl_->clock.start();
+}
+
+void EnsembleDiscovery::setClock(ClockFunction clock)
+{
+    impl_->clock.setFunction(std::move(clock));
+    impl_->clock.start();
+}
+
+void EnsembleDiscovery::cancel()
+{
+    impl_->cancelled.store(true, std::memory_order_relaxed);
 }
 
 std::vector<DiscoveredEnsemble> EnsembleDiscovery::getResults()
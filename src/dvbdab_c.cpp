@@ -5,15 +5,28 @@
 #include <dvbdab/ts_scanner.hpp>
 #include "parsers/eti_na_detector.hpp"
 #include "etina_pipeline.hpp"
+#include "sources/ts_sync.hpp"
+#include "sources/ts_history.hpp"
+#include "sources/dvr_reader.hpp"
+#include "thread_config.hpp"
+#include "flight_recorder.hpp"
+#include "eti_combiner.hpp"
+#include "clock.hpp"
+#include "subchannel_stats.hpp"
 #include "dab_parser.h"
 #include "output/dabplus_decoder.hpp"
+#include "output/mot_decoder.hpp"
 #include "output/dab_mp2_decoder.hpp"
 #include "output/ffmpeg_ts_muxer.hpp"
 #include <algorithm>
+#include <condition_variable>
 #include <cstring>
 #include <cstdlib>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
 
 using namespace dvbdab;
 
@@ -21,6 +34,56 @@ struct dvbdab_scanner {
     TsScanner scanner;
 };
 
+// Convert discovery result to C struct (services array allocated with calloc)
+static void fill_ensemble(dvbdab_ensemble_t& out, const DiscoveredEnsemble& ens)
+{
+    out.eid = ens.eid;
+    strncpy(out.label, ens.label.c_str(), 16);
+    out.label[16] = '\0';
+    out.source_ip = ens.ip;
+    out.source_port = ens.port;
+    out.source_pid = ens.pid;
+    out.service_count = static_cast<int>(ens.services.size());
+
+    // Source type flags
+    out.is_etina = ens.is_etina ? 1 : 0;
+    out.is_tsni = ens.is_tsni ? 1 : 0;
+    out.is_gse = (ens.format == EnsembleFormat::GSE || ens.format == EnsembleFormat::BBF) ? 1 : 0;
+    switch (ens.format) {
+    case EnsembleFormat::MPE:    out.format = DVBDAB_FORMAT_MPE; break;
+    case EnsembleFormat::GSE:    out.format = DVBDAB_FORMAT_GSE; break;
+    case EnsembleFormat::BBF:    out.format = DVBDAB_FORMAT_BBF_TS; break;
+    case EnsembleFormat::ETI_NA: out.format = DVBDAB_FORMAT_ETI_NA; break;
+    case EnsembleFormat::TSNI:   out.format = DVBDAB_FORMAT_TSNI; break;
+    }
+    if (ens.is_etina) {
+        out.etina_padding = ens.etina_info.padding_bytes;
+        out.etina_bit_offset = ens.etina_info.sync_bit_offset;
+        out.etina_inverted = ens.etina_info.inverted ? 1 : 0;
+    }
+
+    if (out.service_count > 0) {
+        out.services = static_cast<dvbdab_service_t*>(
+            calloc(out.service_count, sizeof(dvbdab_service_t)));
+        if (!out.services) {
+            out.service_count = 0;
+            return;
+        }
+
+        for (int j = 0; j < out.service_count; j++) {
+            const auto& svc = ens.services[j];
+            auto& svc_out = out.services[j];
+
+            svc_out.sid = svc.sid;
+            strncpy(svc_out.label, svc.label.c_str(), 16);
+            svc_out.label[16] = '\0';
+            svc_out.bitrate = svc.bitrate;
+            svc_out.subchannel_id = svc.subchannel_id;
+            svc_out.dabplus = svc.dabplus ? 1 : 0;
+        }
+    }
+}
+
 extern "C" {
 
 dvbdab_scanner_t *dvbdab_scanner_create(void)
@@ -44,6 +107,24 @@ void dvbdab_scanner_set_timeout(dvbdab_scanner_t *scanner, unsigned int timeout_
     }
 }
 
+void dvbdab_scanner_set_clock(dvbdab_scanner_t *scanner, dvbdab_clock_mode_t mode)
+{
+    if (scanner) {
+        scanner->scanner.setClock(mode == DVBDAB_CLOCK_MEDIA ? ClockMode::Media : ClockMode::Wall);
+    }
+}
+
+void dvbdab_scanner_set_clock_callback(dvbdab_scanner_t *scanner,
+                                       dvbdab_clock_cb callback, void *opaque)
+{
+    if (!scanner) return;
+    if (callback) {
+        scanner->scanner.setClock([callback, opaque]() { return callback(opaque); });
+    } else {
+        scanner->scanner.setClock(ClockFunction{});
+    }
+}
+
 int dvbdab_scanner_feed(dvbdab_scanner_t *scanner, const uint8_t *data, size_t len)
 {
     if (!scanner || !data || len == 0) {
@@ -64,6 +145,35 @@ int dvbdab_scanner_had_traffic(dvbdab_scanner_t *scanner)
     return scanner->scanner.hadTraffic() ? 1 : 0;
 }
 
+void dvbdab_scanner_set_ensemble_callback(dvbdab_scanner_t *scanner,
+                                           dvbdab_ensemble_found_cb callback, void *opaque,
+                                           int report_basic_ready)
+{
+    if (!scanner) return;
+
+    if (!callback) {
+        scanner->scanner.setEnsembleCallback(nullptr);
+        return;
+    }
+
+    scanner->scanner.setEnsembleCallback(
+        [callback, opaque](const DiscoveredEnsemble& ens, bool complete) {
+            dvbdab_ensemble_t out{};
+            fill_ensemble(out, ens);
+            int ret = callback(opaque, &out, complete ? 1 : 0);
+            free(out.services);
+            return ret == 0;
+        },
+        report_basic_ready != 0);
+}
+
+void dvbdab_scanner_cancel(dvbdab_scanner_t *scanner)
+{
+    if (scanner) {
+        scanner->scanner.cancel();
+    }
+}
+
 dvbdab_results_t *dvbdab_scanner_get_results(dvbdab_scanner_t *scanner)
 {
     if (!scanner) return nullptr;
@@ -80,42 +190,7 @@ dvbdab_results_t *dvbdab_scanner_get_results(dvbdab_scanner_t *scanner)
             calloc(results->ensemble_count, sizeof(dvbdab_ensemble_t)));
 
         for (int i = 0; i < results->ensemble_count; i++) {
-            const auto& ens = ensembles[i];
-            auto& out = results->ensembles[i];
-
-            out.eid = ens.eid;
-            strncpy(out.label, ens.label.c_str(), 16);
-            out.label[16] = '\0';
-            out.source_ip = ens.ip;
-            out.source_port = ens.port;
-            out.source_pid = ens.pid;
-            out.service_count = static_cast<int>(ens.services.size());
-
-            // Source type flags
-            out.is_etina = ens.is_etina ? 1 : 0;
-            out.is_tsni = ens.is_tsni ? 1 : 0;
-            if (ens.is_etina) {
-                out.etina_padding = ens.etina_info.padding_bytes;
-                out.etina_bit_offset = ens.etina_info.sync_bit_offset;
-                out.etina_inverted = ens.etina_info.inverted ? 1 : 0;
-            }
-
-            if (out.service_count > 0) {
-                out.services = static_cast<dvbdab_service_t*>(
-                    calloc(out.service_count, sizeof(dvbdab_service_t)));
-
-                for (int j = 0; j < out.service_count; j++) {
-                    const auto& svc = ens.services[j];
-                    auto& svc_out = out.services[j];
-
-                    svc_out.sid = svc.sid;
-                    strncpy(svc_out.label, svc.label.c_str(), 16);
-                    svc_out.label[16] = '\0';
-                    svc_out.bitrate = svc.bitrate;
-                    svc_out.subchannel_id = svc.subchannel_id;
-                    svc_out.dabplus = svc.dabplus ? 1 : 0;
-                }
-            }
+            fill_ensemble(results->ensembles[i], ensembles[i]);
         }
     }
 
@@ -167,7 +242,6 @@ using dvbdab::TS_PACKET_SIZE;
 using dvbdab::TS_HEADER_SIZE;
 
 // TS packet helpers
-static inline bool etina_ts_is_sync(const uint8_t* ts) { return ts[0] == 0x47; }
 static inline bool etina_ts_has_payload(const uint8_t* ts) { return (ts[3] & 0x10) != 0; }
 static inline bool etina_ts_has_af(const uint8_t* ts) { return (ts[3] & 0x20) != 0; }
 static inline uint16_t etina_ts_get_pid(const uint8_t* ts) { return ((ts[1] & 0x1F) << 8) | ts[2]; }
@@ -191,46 +265,6 @@ static inline const uint8_t* etina_ts_get_payload(const uint8_t* ts, size_t* pay
 
 static inline bool etina_ts_pusi(const uint8_t* ts) { return (ts[1] >> 6) & 1; }
 
-// Generic TS packet processor - extracts payloads from matching PID
-// Callback signature: void(const uint8_t* payload, size_t payload_len, bool pusi)
-// Returns number of bytes consumed from buffer
-template<typename Callback>
-static size_t process_ts_payloads(std::vector<uint8_t>& ts_buffer, uint16_t target_pid, Callback&& callback) {
-    size_t offset = 0;
-    while (offset + TS_PACKET_SIZE <= ts_buffer.size()) {
-        const uint8_t* ts = ts_buffer.data() + offset;
-
-        // Find sync byte (handle lost sync)
-        if (!etina_ts_is_sync(ts)) {
-            offset++;
-            continue;
-        }
-
-        if (etina_ts_get_pid(ts) != target_pid) {
-            offset += TS_PACKET_SIZE;
-            continue;
-        }
-
-        size_t payload_len;
-        const uint8_t* payload = etina_ts_get_payload(ts, &payload_len);
-        if (!payload || payload_len == 0) {
-            offset += TS_PACKET_SIZE;
-            continue;
-        }
-
-        callback(payload, payload_len, etina_ts_pusi(ts));
-        offset += TS_PACKET_SIZE;
-    }
-    return offset;
-}
-
-// Helper to clean up processed data from buffer
-static void ts_buffer_consume(std::vector<uint8_t>& ts_buffer, size_t consumed) {
-    if (consumed > 0) {
-        ts_buffer.erase(ts_buffer.begin(), ts_buffer.begin() + consumed);
-    }
-}
-
 /* ============================================================================
  * Unified DAB Streaming Implementation
  * ============================================================================ */
@@ -238,8 +272,12 @@ static void ts_buffer_consume(std::vector<uint8_t>& ts_buffer, size_t consumed)
 #include "sources/mpe_ts_source.hpp"
 #include "sources/gse_ts_source.hpp"
 #include "sources/bbf_ts_source.hpp"
+#include "sources/edi_tcp_source.hpp"
+#include "sources/udp_ts_receiver.hpp"
 #include "ensemble_manager.hpp"
 #include "parsers/udp_extractor.hpp"
+#include "parsers/edi_framer.hpp"
+#include "parsers/tsni_framer.hpp"
 
 struct dvbdab_streamer {
     // Configuration
@@ -258,16 +296,34 @@ struct dvbdab_streamer {
     EtinaPipelineState etina_pipeline;
     bool etina_detected{false};  // True once pipeline is producing ETI frames
 
-    // Partial TS packet buffer for ETI-NA/TSNI (handles unaligned input chunks)
-    std::vector<uint8_t> ts_buffer;
+    // TS sync for ETI-NA/TSNI (handles unaligned input chunks)
+    TsSync ts_sync;
 
     // TSNI (TS NI V.11) state
-    std::vector<uint8_t> tsni_frame_buffer;  // Frame accumulation buffer
+    TsniFramer tsni_framer;
     bool tsni_detected{false};  // True once TSNI is producing ETI frames
-    static constexpr size_t TSNI_FRAME_SIZE = 6140;  // ETI-NI frame size
+
+    // Further ETI-NA/TSNI PIDs fed from this streamer's input, one pass over
+    // the TS for all of them (owned, see dvbdab_streamer_add_pid)
+    std::vector<dvbdab_streamer*> pid_streamers;
+    dvbdab_streamer* pid_parent{nullptr};
+
+    // Diversity: redundant inputs of this ensemble (owned, see
+    // dvbdab_streamer_add_input); their ETI frames and this streamer's own
+    // go through the combiner, which picks one copy per 24 ms frame
+    std::unique_ptr<EtiCombiner> combiner;
+    std::vector<dvbdab_streamer*> inputs;
+    uint32_t next_input_id{1};  // 0 is this streamer's own input
+    dvbdab_streamer* combine_target{nullptr};  // Set on an input handle
+    uint32_t combine_id{0};
 
     // UDP extraction (for MPE/GSE)
     std::unique_ptr<UdpExtractor> udp_extractor;
+    Clock clock;  // Wall time for fragment timeouts
+
+    // AF packet framing (for EDI byte streams)
+    EdiStreamFramer edi_framer;
+    size_t edi_connect_count{0};  // Connection the framer is synced to (EDI over TCP)
 
     // DAB parsing - EnsembleManager for all formats (MPE/GSE/ETI-NA)
     std::unique_ptr<EnsembleManager> manager;
@@ -276,6 +332,29 @@ struct dvbdab_streamer {
     std::map<uint8_t, std::unique_ptr<DabPlusDecoder>> dabplus_decoders;
     std::map<uint8_t, std::unique_ptr<DabMp2Decoder>> mp2_decoders;
 
+    // MOT (slideshow) output - X-PAD of DAB+ decoders and packet-mode services
+    dvbdab_mot_object_cb mot_cb{nullptr};
+    void* mot_opaque{nullptr};
+    struct PacketMot {
+        uint8_t subchannel_id;
+        uint32_t sid;
+        std::unique_ptr<MotDecoder> decoder;
+        std::unique_ptr<MscPacketAssembler> assembler;
+    };
+    std::vector<PacketMot> packet_mots;
+    std::vector<lsdvb::DABPacketComponent> packet_mot_components;  // FIC state packet_mots was built from
+    bool packet_mots_stale{true};     // Rebuild on the next ETI frame
+    std::set<uint32_t> mot_sids;      // Subscribed services (dvbdab_streamer_subscribe_mot)
+    bool mot_all{false};              // DVBDAB_MOT_ALL subscribed
+
+    // Raw subchannel subscriptions; bit n of the mask is set if subchannel n has one
+    struct SubchannelSub {
+        dvbdab_subchannel_cb cb{nullptr};
+        void* opaque{nullptr};
+    };
+    SubchannelSub subchannel_subs[64];
+    uint64_t subchannel_mask{0};
+
     // TS muxer (FFmpeg-based) - shared output stage
     std::unique_ptr<FfmpegTsMuxer> muxer;
 
@@ -295,8 +374,70 @@ struct dvbdab_streamer {
     int audio_frame_count{0};
     int eti_frame_count{0};
 
+    // Measured payload per subchannel (ETI dispatch and decoders)
+    SubchannelStats subchannel_stats;
+
     // Cached ensemble for get_ensemble
     lsdvb::DABEnsemble cached_ensemble;
+    StreamKey ensemble_key{};  // Stream it was taken from (refreshed on get_ensemble)
+
+    // Last frame counter (DFLC for EDI, else FCT), used to drop live frames
+    // repeating a history replay
+    uint16_t last_seq{0};
+    uint16_t last_seq_modulus{0};  // 0 = none seen yet
+    bool replay_overlap{false};    // Set by replay, cleared on first newer frame
+
+    // Serializes the API against the async worker. Recursive because output
+    // callbacks run inside feed and may call back into the API.
+    std::recursive_mutex api_mutex;
+
+    // Raw input recorder (optional)
+    std::unique_ptr<FlightRecorder> recorder;
+
+    // Async feed: fixed ring of queued buffers, consumed by one worker thread
+    struct AsyncBuffer {
+        std::vector<struct iovec> iov;  // Capacity reused between buffers
+        void* tag{nullptr};
+    };
+    std::vector<AsyncBuffer> async_ring;
+    size_t async_head{0};
+    size_t async_count{0};
+    bool async_running{false};
+    dvbdab_feed_done_cb async_done_cb{nullptr};
+    void* async_opaque{nullptr};
+    std::mutex async_mutex;
+    std::condition_variable async_cv;        // Buffer queued / stop
+    std::condition_variable async_idle_cv;   // Buffer consumed
+    std::thread async_thread;
+};
+
+struct dvbdab_history {
+    TsHistory history;
+    Clock clock;  // Wall time
+
+    dvbdab_history(unsigned int duration_ms, size_t max_bytes)
+        : history(duration_ms, max_bytes) {}
+};
+
+struct dvbdab_reader {
+    DvrReader reader;
+
+    dvbdab_reader(int fd, size_t ring_size, size_t dvr_buffer_size)
+        : reader(fd, ring_size, dvr_buffer_size) {}
+};
+
+struct dvbdab_udp_ts {
+    UdpTsReceiver receiver;
+
+    dvbdab_udp_ts(const char* address, uint16_t port, const char* interface, UdpTsReceiver::Mode mode)
+        : receiver(address ? address : "", port, interface ? interface : "", mode) {}
+};
+
+struct dvbdab_edi_tcp {
+    EdiTcpSource source;
+
+    dvbdab_edi_tcp(EdiTcpSource::Mode mode, const char* host, uint16_t port)
+        : source(mode, host ? host : "", port) {}
 };
 
 // Helper to configure muxer from ensemble
@@ -342,17 +483,139 @@ static void auto_start_services_if_ready(dvbdab_streamer* s) {
     }
 }
 
+// Pass a decoded MOT object to the C callback
+static void emit_mot_object(dvbdab_streamer* s, uint8_t subchannel_id, uint32_t sid,
+                            const MotObject& object) {
+    if (!s->mot_cb) return;
+
+    dvbdab_mot_object_t out;
+    out.sid = sid;
+    out.subchannel_id = subchannel_id;
+    out.transport_id = object.transport_id;
+    out.content_type = object.content_type;
+    out.content_subtype = object.content_subtype;
+    out.content_name = object.content_name.c_str();
+    out.data = object.body.data();
+    out.len = object.body.size();
+    s->mot_cb(s->mot_opaque, &out);
+}
+
+// MOT is decoded for a service while a callback is set and it is subscribed
+static bool mot_subscribed(const dvbdab_streamer* s, uint32_t sid) {
+    return s->mot_cb && (s->mot_all || s->mot_sids.count(sid) != 0);
+}
+
+// Subscribe a DAB+ decoder's X-PAD MOT to the streamer callback (or unsubscribe)
+static void apply_xpad_mot(dvbdab_streamer* s, uint8_t subchannel_id, DabPlusDecoder& decoder) {
+    auto it = s->subch_to_sid.find(subchannel_id);
+    uint32_t sid = it != s->subch_to_sid.end() ? it->second : 0;
+    if (!mot_subscribed(s, sid)) {
+        decoder.setMotCallback(nullptr);
+        return;
+    }
+    decoder.setMotCallback([s, subchannel_id, sid](const MotObject& object) {
+        emit_mot_object(s, subchannel_id, sid, object);
+    });
+}
+
+// MOT subscriptions or callback changed: update X-PAD decoders now, packet-mode
+// decoders on the next ETI frame
+static void apply_mot_subscriptions(dvbdab_streamer* s) {
+    for (auto& [subchannel_id, decoder] : s->dabplus_decoders) {
+        apply_xpad_mot(s, subchannel_id, *decoder);
+    }
+    s->packet_mots_stale = true;
+}
+
+static bool same_packet_components(const std::vector<lsdvb::DABPacketComponent>& a,
+                                   const std::vector<lsdvb::DABPacketComponent>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+        [](const lsdvb::DABPacketComponent& x, const lsdvb::DABPacketComponent& y) {
+            return x.sid == y.sid && x.scid == y.scid && x.subchannel_id == y.subchannel_id &&
+                   x.packet_addr == y.packet_addr && x.dscty == y.dscty && x.dg_flag == y.dg_flag;
+        });
+}
+
+// (Re)build packet-mode MOT decoders of subscribed services from the FIC
+// packet components
+static void setup_packet_mots(dvbdab_streamer* s) {
+    const auto& components = s->cached_ensemble.packet_components;
+    s->packet_mot_components = components;
+    s->packet_mots_stale = false;
+    s->packet_mots.clear();
+
+    for (const auto& pc : components) {
+        if (pc.dscty != 60 || !pc.dg_flag) continue;  // MOT in data groups only
+        if (!mot_subscribed(s, pc.sid)) continue;
+
+        dvbdab_streamer::PacketMot pm;
+        pm.subchannel_id = static_cast<uint8_t>(pc.subchannel_id);
+        pm.sid = pc.sid;
+        pm.decoder = std::make_unique<MotDecoder>();
+        pm.decoder->setCallback([s, subch = pm.subchannel_id, sid = pm.sid](const MotObject& object) {
+            emit_mot_object(s, subch, sid, object);
+        });
+        MotDecoder* decoder = pm.decoder.get();
+        pm.assembler = std::make_unique<MscPacketAssembler>(
+            static_cast<uint16_t>(pc.packet_addr),
+            [decoder](const uint8_t* dg, size_t len) { decoder->feedDataGroup(dg, len); });
+        s->packet_mots.push_back(std::move(pm));
+    }
+}
+
+// Pass the cumulative counters of the running decoders to the subchannel statistics
+static void sample_decoder_stats(dvbdab_streamer* s, SubchannelStats& stats) {
+    for (const auto& [scid, dec] : s->dabplus_decoders) {
+        SubchannelStats::DecoderTotals t;
+        t.au_count = dec->getValidAuCount() + dec->getCrcErrors();
+        t.au_errors = dec->getCrcErrors();
+        t.au_bytes = dec->getAuBytes();
+        t.pad_bytes = dec->getPadBytes();
+        t.superframes = dec->getSuperframeCount() + dec->getFireCodeErrors();
+        t.firecode_errors = dec->getFireCodeErrors();
+        stats.addDecoderTotals(scid, t);
+    }
+    for (const auto& [scid, dec] : s->mp2_decoders) {
+        SubchannelStats::DecoderTotals t;
+        t.au_count = dec->getMp2FrameCount() + dec->getCrcErrors();
+        t.au_errors = dec->getCrcErrors();
+        t.au_bytes = dec->getMp2Bytes();
+        t.pad_bytes = dec->getPadBytes();
+        stats.addDecoderTotals(scid, t);
+    }
+}
+
 // Shared ETI frame processing - used by all input formats (ETI-NA, MPE, GSE, TSNI)
 // All formats produce ETI frames that are processed identically here
 // Called via eti_callback from EnsembleManager for audio decoding
-static void process_eti_frame(dvbdab_streamer* s, const uint8_t* eti_ni, size_t len) {
-    if (!s->muxer_initialized) {
-        s->eti_frame_count++;
-        return;
+static void process_eti_frame(dvbdab_streamer* s, const uint8_t* eti_ni, size_t len, uint16_t dflc) {
+    // After a history replay, live data may start with frames already
+    // replayed: drop frames whose counter is not ahead of the last. EDI
+    // carries the full DFLC (0-4999, 120 s), ETI-NA/TSNI only the FCT
+    // (DFLC mod 250, 6 s); mixed counters are compared as FCT.
+    if (len >= 5) {
+        uint16_t seq = dflc ? dflc : eti_ni[4];
+        uint16_t modulus = dflc ? 5000 : 250;
+        if (s->replay_overlap && s->last_seq_modulus) {
+            uint16_t last = s->last_seq;
+            uint16_t cmp_modulus = modulus;
+            if (modulus != s->last_seq_modulus) {
+                cmp_modulus = 250;
+                last %= 250;
+            }
+            int ahead = (seq % cmp_modulus + cmp_modulus - last) % cmp_modulus;
+            if (ahead == 0 || ahead > cmp_modulus / 2) return;
+            s->replay_overlap = false;
+        }
+        s->last_seq = seq;
+        s->last_seq_modulus = modulus;
     }
-    if (len < 12) return;
 
     s->eti_frame_count++;
+    if (len < 12) return;
+
+    // EDI input provides the full DFLC, ETI-NI only the FCT
+    uint16_t cif_count = dflc ? dflc : eti_ni[4];
 
     // Parse ETI frame header
     uint8_t nst = eti_ni[5] & 0x7F;
@@ -374,6 +637,13 @@ static void process_eti_frame(dvbdab_streamer* s, const uint8_t* eti_ni, size_t
 
     size_t stream_offset = header_size + fic_size;
 
+    // Components change as FIG 0/2 and 0/3 arrive or on reconfiguration
+    if (s->muxer_initialized && s->mot_cb &&
+        (s->packet_mots_stale || !same_packet_components(s->packet_mot_components,
+                                                         s->cached_ensemble.packet_components))) {
+        setup_packet_mots(s);
+    }
+
     // Process each subchannel stream
     for (uint8_t i = 0; i < nst && i < 64; i++) {
         size_t stc_pos = 8 + i * 4;
@@ -385,6 +655,17 @@ static void process_eti_frame(dvbdab_streamer* s, const uint8_t* eti_ni, size_t
 
         if (stream_offset + stream_size > len) break;
 
+        s->subchannel_stats.addStream(scid, stream_size);
+
+        if (s->subchannel_mask & (uint64_t{1} << scid)) {
+            const auto& sub = s->subchannel_subs[scid];
+            sub.cb(sub.opaque, scid, eti_ni + stream_offset, stream_size, cif_count);
+        }
+        if (!s->muxer_initialized) {
+            stream_offset += stream_size;
+            continue;
+        }
+
         // Feed to DAB+ decoder if active
         auto dabplus_it = s->dabplus_decoders.find(scid);
         if (dabplus_it != s->dabplus_decoders.end()) {
@@ -397,8 +678,168 @@ static void process_eti_frame(dvbdab_streamer* s, const uint8_t* eti_ni, size_t
             mp2_it->second->feedFrame(eti_ni + stream_offset, stream_size);
         }
 
+        // Feed packet-mode MOT services carried in this subchannel
+        for (auto& pm : s->packet_mots) {
+            if (pm.subchannel_id == scid) {
+                pm.assembler->feed(eti_ni + stream_offset, stream_size);
+            }
+        }
+
         stream_offset += stream_size;
     }
+
+    s->subchannel_stats.endFrame([s](SubchannelStats& stats) { sample_decoder_stats(s, stats); });
+}
+
+// One TS payload of an ETI-NA/TSNI PID -> ETI-NI frames -> EnsembleManager
+static void feed_eti_payload(dvbdab_streamer* s, const uint8_t* payload, size_t len, bool pusi)
+{
+    if (s->config.format == DVBDAB_FORMAT_TSNI) {
+        // ETI-NI frames with incrementing sequence byte (0x69-0x9A)
+        s->tsni_framer.feedPayload(payload, len, pusi, [s](const uint8_t* eti_ni, size_t eti_len) {
+            s->tsni_detected = true;
+            s->manager->processEtiFrame(s->config.pid, eti_ni, eti_len);
+        });
+    } else {
+        etina_feed_payload(s->etina_pipeline, payload, len, [s](const uint8_t* eti_ni, size_t eti_len) {
+            s->etina_detected = true;
+            s->manager->processEtiFrame(s->config.pid, eti_ni, eti_len);
+        });
+    }
+}
+
+// ETI-NA/TSNI input: one pass over the TS, each payload goes to the
+// streamer of its PID (this one or one added with dvbdab_streamer_add_pid)
+static void feed_eti_ts(dvbdab_streamer* s, const uint8_t* data, size_t len)
+{
+    s->ts_sync.feed(data, len, [s](const uint8_t* ts) {
+        uint16_t pid = etina_ts_get_pid(ts);
+        dvbdab_streamer* target = nullptr;
+        if (pid == s->config.pid) {
+            target = s;
+        } else {
+            for (dvbdab_streamer* child : s->pid_streamers) {
+                if (child->config.pid == pid) {
+                    target = child;
+                    break;
+                }
+            }
+            if (!target) return;
+        }
+
+        size_t payload_len;
+        const uint8_t* payload = etina_ts_get_payload(ts, &payload_len);
+        if (!payload || payload_len == 0) {
+            return;
+        }
+
+        if (target == s) {
+            feed_eti_payload(s, payload, payload_len, etina_ts_pusi(ts));
+        } else {
+            // The PID's own handle may be used from other threads
+            std::lock_guard<std::recursive_mutex> child_lock(target->api_mutex);
+            feed_eti_payload(target, payload, payload_len, etina_ts_pusi(ts));
+        }
+    });
+}
+
+// Ensemble of a streamer's input reached basic ready
+static void ensemble_basic_ready(dvbdab_streamer* s, const lsdvb::DABEnsemble& ens)
+{
+    s->cached_ensemble = ens;
+    s->basic_ready = true;
+    if (s->muxer) {
+        setup_muxer_from_ensemble(s, ens);
+        auto_start_services_if_ready(s);
+    }
+
+    // An added input provides the ensemble until the streamer's own does
+    if (dvbdab_streamer* target = s->combine_target) {
+        std::lock_guard<std::recursive_mutex> lock(target->api_mutex);
+        if (!target->basic_ready) ensemble_basic_ready(target, ens);
+    }
+}
+
+// Ensemble of a streamer's input complete (all labels known)
+static void ensemble_complete(dvbdab_streamer* s, const StreamKey& key, const lsdvb::DABEnsemble& ens)
+{
+    s->cached_ensemble = ens;
+    s->ensemble_key = key;
+    s->complete = true;
+    // Update service labels in muxer now that we have all names
+    if (s->muxer) {
+        for (const auto& svc : ens.services) {
+            s->muxer->updateServiceLabel(static_cast<uint16_t>(svc.sid), svc.label);
+        }
+    }
+
+    if (dvbdab_streamer* target = s->combine_target) {
+        std::lock_guard<std::recursive_mutex> lock(target->api_mutex);
+        if (!target->complete) ensemble_complete(target, key, ens);
+    }
+}
+
+// Take over FIC changes since the ensemble was complete (reconfiguration:
+// services added, removed or moved to another subchannel)
+static void refresh_ensemble(dvbdab_streamer* s)
+{
+    if (!s->complete || !s->manager) return;
+    const lsdvb::DABEnsemble* current = s->manager->findEnsemble(s->ensemble_key);
+    if (current && !current->services.empty()) {
+        s->cached_ensemble = *current;
+    }
+}
+
+// ETI frame of a streamer's input: decoded directly, or through the
+// diversity combiner of the streamer when the ensemble has several inputs
+static void input_eti_frame(dvbdab_streamer* s, const uint8_t* data, size_t len, uint16_t dflc)
+{
+    dvbdab_streamer* target = s->combine_target ? s->combine_target : s;
+    if (!target->combiner) {
+        process_eti_frame(s, data, len, dflc);
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(target->api_mutex);
+    target->combiner->feed(s->combine_id, data, len, dflc);
+}
+
+// Async feed worker: consume queued buffers in order, report each one done
+static void async_worker(dvbdab_streamer* s)
+{
+    applyThreadConfig(ThreadRole::AsyncFeed);
+
+    std::unique_lock<std::mutex> lock(s->async_mutex);
+    while (true) {
+        s->async_cv.wait(lock, [s] { return s->async_count > 0 || !s->async_running; });
+        if (s->async_count == 0) break;  // Stopped and drained
+
+        // The slot stays counted while in use, so producers do not reuse it
+        auto& buf = s->async_ring[s->async_head];
+        lock.unlock();
+        dvbdab_streamer_feedv(s, buf.iov.data(), static_cast<int>(buf.iov.size()));
+        if (s->async_done_cb) {
+            s->async_done_cb(s->async_opaque, buf.tag);
+        }
+        lock.lock();
+
+        s->async_head = (s->async_head + 1) % s->async_ring.size();
+        s->async_count--;
+        s->async_idle_cv.notify_all();
+    }
+}
+
+// Stop the worker after it has consumed everything queued
+static void stop_async(dvbdab_streamer* s)
+{
+    {
+        std::lock_guard<std::mutex> lock(s->async_mutex);
+        if (!s->async_running) return;
+        s->async_running = false;
+    }
+    s->async_cv.notify_all();
+    if (s->async_thread.joinable()) {
+        s->async_thread.join();
+    }
 }
 
 extern "C" { // Resume C API
@@ -427,31 +868,20 @@ dvbdab_streamer_t *dvbdab_streamer_create(const dvbdab_streamer_config_t *config
             s->manager->setBasicReadyCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
                 // ETI-NA key: ip=pid, port=0
                 if (key.ip == static_cast<uint32_t>(s->config.pid) && key.port == 0) {
-                    s->cached_ensemble = ens;
-                    s->basic_ready = true;
-                    if (s->muxer) {
-                        setup_muxer_from_ensemble(s, ens);
-                        auto_start_services_if_ready(s);
-                    }
+                    ensemble_basic_ready(s, ens);
                 }
             });
 
             s->manager->setCompleteCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
                 if (key.ip == static_cast<uint32_t>(s->config.pid) && key.port == 0) {
-                    s->cached_ensemble = ens;
-                    s->complete = true;
-                    if (s->muxer) {
-                        for (const auto& svc : ens.services) {
-                            s->muxer->updateServiceLabel(static_cast<uint16_t>(svc.sid), svc.label);
-                        }
-                    }
+                    ensemble_complete(s, key, ens);
                 }
             });
 
             // ETI callback from EnsembleManager -> shared ETI processing for audio
-            s->manager->setEtiCallback([s](const StreamKey& key, const uint8_t* data, size_t len, uint16_t) {
+            s->manager->setEtiCallback([s](const StreamKey& key, const uint8_t* data, size_t len, uint16_t dflc) {
                 if (key.ip != static_cast<uint32_t>(s->config.pid) || key.port != 0) return;
-                process_eti_frame(s, data, len);
+                input_eti_frame(s, data, len, dflc);
             });
             break;
 
@@ -469,45 +899,34 @@ dvbdab_streamer_t *dvbdab_streamer_create(const dvbdab_streamer_config_t *config
 
             // Connect MpeTsSource -> UdpExtractor
             s->mpe_source->setIpCallback([s](const uint8_t* ip_data, size_t len) {
-                s->udp_extractor->process(ip_data, len);
+                s->udp_extractor->process(ip_data, len, s->clock);
             });
 
             // Set ensemble callbacks
             s->manager->setBasicReadyCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
                 if (key.ip == s->config.filter_ip && key.port == s->config.filter_port) {
-                    s->cached_ensemble = ens;
-                    s->basic_ready = true;
-                    if (s->muxer) {
-                        setup_muxer_from_ensemble(s, ens);
-                        auto_start_services_if_ready(s);
-                    }
+                    ensemble_basic_ready(s, ens);
                 }
             });
 
             s->manager->setCompleteCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
                 if (key.ip == s->config.filter_ip && key.port == s->config.filter_port) {
-                    s->cached_ensemble = ens;
-                    s->complete = true;
-                    // Update service labels in muxer now that we have all names
-                    if (s->muxer) {
-                        for (const auto& svc : ens.services) {
-                            s->muxer->updateServiceLabel(static_cast<uint16_t>(svc.sid), svc.label);
-                        }
-                    }
+                    ensemble_complete(s, key, ens);
                 }
             });
 
             // ETI callback from EnsembleManager -> shared ETI processing
-            s->manager->setEtiCallback([s](const StreamKey& key, const uint8_t* data, size_t len, uint16_t) {
+            s->manager->setEtiCallback([s](const StreamKey& key, const uint8_t* data, size_t len, uint16_t dflc) {
                 if (key.ip != s->config.filter_ip || key.port != s->config.filter_port) return;
-                process_eti_frame(s, data, len);
+                input_eti_frame(s, data, len, dflc);
             });
             break;
 
         case DVBDAB_FORMAT_GSE:
             // GSE: TS -> GseTsSource -> IP -> UdpExtractor -> UDP -> EnsembleManager -> ETI
-            // Note: GseTsSource extracts from all GSE data, filtering by IP is done at EnsembleManager level
+            // Unrelated IP traffic is dropped in the GSE parser before reassembly
             s->gse_source = std::make_unique<GseTsSource>();
+            s->gse_source->setIpFilter(config->filter_ip, config->filter_port);
             s->manager = std::make_unique<EnsembleManager>();
 
             // Create UDP extractor
@@ -518,38 +937,26 @@ dvbdab_streamer_t *dvbdab_streamer_create(const dvbdab_streamer_config_t *config
 
             // Connect GseTsSource -> UdpExtractor
             s->gse_source->setIpCallback([s](const uint8_t* ip_data, size_t len) {
-                s->udp_extractor->process(ip_data, len);
+                s->udp_extractor->process(ip_data, len, s->clock);
             });
 
             // Set ensemble callbacks
             s->manager->setBasicReadyCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
                 if (key.ip == s->config.filter_ip && key.port == s->config.filter_port) {
-                    s->cached_ensemble = ens;
-                    s->basic_ready = true;
-                    if (s->muxer) {
-                        setup_muxer_from_ensemble(s, ens);
-                        auto_start_services_if_ready(s);
-                    }
+                    ensemble_basic_ready(s, ens);
                 }
             });
 
             s->manager->setCompleteCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
                 if (key.ip == s->config.filter_ip && key.port == s->config.filter_port) {
-                    s->cached_ensemble = ens;
-                    s->complete = true;
-                    // Update service labels in muxer now that we have all names
-                    if (s->muxer) {
-                        for (const auto& svc : ens.services) {
-                            s->muxer->updateServiceLabel(static_cast<uint16_t>(svc.sid), svc.label);
-                        }
-                    }
+                    ensemble_complete(s, key, ens);
                 }
             });
 
             // ETI callback from EnsembleManager -> shared ETI processing
-            s->manager->setEtiCallback([s](const StreamKey& key, const uint8_t* data, size_t len, uint16_t) {
+            s->manager->setEtiCallback([s](const StreamKey& key, const uint8_t* data, size_t len, uint16_t dflc) {
                 if (key.ip != s->config.filter_ip || key.port != s->config.filter_port) return;
-                process_eti_frame(s, data, len);
+                input_eti_frame(s, data, len, dflc);
             });
             break;
 
@@ -557,6 +964,7 @@ dvbdab_streamer_t *dvbdab_streamer_create(const dvbdab_streamer_config_t *config
             // BBF-in-PseudoTS: Raw BBFrames from DMX_SET_FE_STREAM -> IP -> EnsembleManager
             // This is for GSE data delivered via the special demux mode
             s->bbf_source = std::make_unique<BbfTsSource>();
+            s->bbf_source->setIpFilter(config->filter_ip, config->filter_port);
             s->manager = std::make_unique<EnsembleManager>();
 
             // Create UDP extractor
@@ -567,37 +975,26 @@ dvbdab_streamer_t *dvbdab_streamer_create(const dvbdab_streamer_config_t *config
 
             // Connect BbfTsSource -> UdpExtractor
             s->bbf_source->setIpCallback([s](const uint8_t* ip_data, size_t len) {
-                s->udp_extractor->process(ip_data, len);
+                s->udp_extractor->process(ip_data, len, s->clock);
             });
 
             // Set ensemble callbacks
             s->manager->setBasicReadyCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
                 if (key.ip == s->config.filter_ip && key.port == s->config.filter_port) {
-                    s->cached_ensemble = ens;
-                    s->basic_ready = true;
-                    if (s->muxer) {
-                        setup_muxer_from_ensemble(s, ens);
-                        auto_start_services_if_ready(s);
-                    }
+                    ensemble_basic_ready(s, ens);
                 }
             });
 
             s->manager->setCompleteCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
                 if (key.ip == s->config.filter_ip && key.port == s->config.filter_port) {
-                    s->cached_ensemble = ens;
-                    s->complete = true;
-                    if (s->muxer) {
-                        for (const auto& svc : ens.services) {
-                            s->muxer->updateServiceLabel(static_cast<uint16_t>(svc.sid), svc.label);
-                        }
-                    }
+                    ensemble_complete(s, key, ens);
                 }
             });
 
             // ETI callback from EnsembleManager -> shared ETI processing
-            s->manager->setEtiCallback([s](const StreamKey& key, const uint8_t* data, size_t len, uint16_t) {
+            s->manager->setEtiCallback([s](const StreamKey& key, const uint8_t* data, size_t len, uint16_t dflc) {
                 if (key.ip != s->config.filter_ip || key.port != s->config.filter_port) return;
-                process_eti_frame(s, data, len);
+                input_eti_frame(s, data, len, dflc);
             });
             break;
 
@@ -605,36 +1002,47 @@ dvbdab_streamer_t *dvbdab_streamer_create(const dvbdab_streamer_config_t *config
             // TSNI: TS -> parse sections with incrementing table_id -> ETI-NI -> EnsembleManager -> audio
             // Similar to ETI-NA but with different encapsulation (PUSI + pointer + sequence byte)
             s->manager = std::make_unique<EnsembleManager>();
-            s->tsni_frame_buffer.reserve(s->TSNI_FRAME_SIZE + 188);
 
             // Set ensemble callbacks - for TSNI the key is (pid, 0) like ETI-NA
             s->manager->setBasicReadyCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
                 if (key.ip == static_cast<uint32_t>(s->config.pid) && key.port == 0) {
-                    s->cached_ensemble = ens;
-                    s->basic_ready = true;
-                    if (s->muxer) {
-                        setup_muxer_from_ensemble(s, ens);
-                        auto_start_services_if_ready(s);
-                    }
+                    ensemble_basic_ready(s, ens);
                 }
             });
 
             s->manager->setCompleteCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
                 if (key.ip == static_cast<uint32_t>(s->config.pid) && key.port == 0) {
-                    s->cached_ensemble = ens;
-                    s->complete = true;
-                    if (s->muxer) {
-                        for (const auto& svc : ens.services) {
-                            s->muxer->updateServiceLabel(static_cast<uint16_t>(svc.sid), svc.label);
-                        }
-                    }
+                    ensemble_complete(s, key, ens);
                 }
             });
 
             // ETI callback from EnsembleManager -> shared ETI processing for audio
-            s->manager->setEtiCallback([s](const StreamKey& key, const uint8_t* data, size_t len, uint16_t) {
+            s->manager->setEtiCallback([s](const StreamKey& key, const uint8_t* data, size_t len, uint16_t dflc) {
                 if (key.ip != static_cast<uint32_t>(s->config.pid) || key.port != 0) return;
-                process_eti_frame(s, data, len);
+                input_eti_frame(s, data, len, dflc);
+            });
+            break;
+
+        case DVBDAB_FORMAT_EDI:
+            // EDI: AF byte stream -> EdiStreamFramer -> AF packets -> EnsembleManager -> ETI
+            // AF packets go straight to the AF layer (no PF); the key is (filter_ip, filter_port)
+            s->manager = std::make_unique<EnsembleManager>();
+
+            s->manager->setBasicReadyCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
+                if (key.ip == s->config.filter_ip && key.port == s->config.filter_port) {
+                    ensemble_basic_ready(s, ens);
+                }
+            });
+
+            s->manager->setCompleteCallback([s](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
+                if (key.ip == s->config.filter_ip && key.port == s->config.filter_port) {
+                    ensemble_complete(s, key, ens);
+                }
+            });
+
+            s->manager->setEtiCallback([s](const StreamKey& key, const uint8_t* data, size_t len, uint16_t dflc) {
+                if (key.ip != s->config.filter_ip || key.port != s->config.filter_port) return;
+                input_eti_frame(s, data, len, dflc);
             });
             break;
 
@@ -652,6 +1060,30 @@ dvbdab_streamer_t *dvbdab_streamer_create(const dvbdab_streamer_config_t *config
 void dvbdab_streamer_destroy(dvbdab_streamer_t *streamer)
 {
     if (streamer) {
+        // Before taking the parent's lock: the worker may be waiting for it
+        stop_async(streamer);
+
+        // A PID or input handle is detached from its parent first, so the
+        // parent's feed (or combiner) no longer reaches it
+        std::unique_lock<std::recursive_mutex> parent_lock;
+        if (streamer->pid_parent) {
+            dvbdab_streamer* parent = streamer->pid_parent;
+            parent_lock = std::unique_lock<std::recursive_mutex>(parent->api_mutex);
+            auto& children = parent->pid_streamers;
+            children.erase(std::remove(children.begin(), children.end(), streamer), children.end());
+        } else if (streamer->combine_target) {
+            dvbdab_streamer* parent = streamer->combine_target;
+            parent_lock = std::unique_lock<std::recursive_mutex>(parent->api_mutex);
+            auto& inputs = parent->inputs;
+            inputs.erase(std::remove(inputs.begin(), inputs.end(), streamer), inputs.end());
+        }
+
+        for (dvbdab_streamer* child : std::vector<dvbdab_streamer*>(streamer->pid_streamers)) {
+            dvbdab_streamer_destroy(child);
+        }
+        for (dvbdab_streamer* input : std::vector<dvbdab_streamer*>(streamer->inputs)) {
+            dvbdab_streamer_destroy(input);
+        }
         if (streamer->muxer) {
             streamer->muxer->finalize();
         }
@@ -659,11 +1091,96 @@ void dvbdab_streamer_destroy(dvbdab_streamer_t *streamer)
     }
 }
 
+dvbdab_streamer_t *dvbdab_streamer_add_pid(dvbdab_streamer_t *streamer,
+                                           const dvbdab_streamer_config_t *config)
+{
+    if (!streamer || !config) return nullptr;
+
+    auto is_eti = [](dvbdab_format_t format) {
+        return format == DVBDAB_FORMAT_ETI_NA || format == DVBDAB_FORMAT_TSNI;
+    };
+    if (!is_eti(streamer->config.format) || !is_eti(config->format)) return nullptr;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+    if (streamer->pid_parent) return nullptr;  // Add to the streamer that is fed
+    if (config->pid == streamer->config.pid) return nullptr;
+    for (dvbdab_streamer* child : streamer->pid_streamers) {
+        if (child->config.pid == config->pid) return nullptr;
+    }
+
+    dvbdab_streamer* child = dvbdab_streamer_create(config);
+    if (!child) return nullptr;
+    try {
+        streamer->pid_streamers.push_back(child);
+    } catch (...) {
+        dvbdab_streamer_destroy(child);
+        return nullptr;
+    }
+    child->pid_parent = streamer;
+    return child;
+}
+
+dvbdab_streamer_t *dvbdab_streamer_add_input(dvbdab_streamer_t *streamer,
+                                             const dvbdab_streamer_config_t *config)
+{
+    if (!streamer || !config) return nullptr;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+    if (streamer->combine_target || streamer->pid_parent) return nullptr;
+
+    dvbdab_streamer* input = dvbdab_streamer_create(config);
+    if (!input) return nullptr;
+    try {
+        if (!streamer->combiner) {
+            streamer->combiner = std::make_unique<EtiCombiner>();
+            streamer->combiner->setOutputCallback([streamer](const uint8_t* frame, size_t len, uint16_t dflc) {
+                process_eti_frame(streamer, frame, len, dflc);
+            });
+        }
+        streamer->inputs.push_back(input);
+    } catch (...) {
+        dvbdab_streamer_destroy(input);
+        return nullptr;
+    }
+    input->combine_target = streamer;
+    input->combine_id = streamer->next_input_id++;
+
+    // The ensemble may already be known from this input's data
+    if (input->basic_ready && !streamer->basic_ready) {
+        ensemble_basic_ready(streamer, input->cached_ensemble);
+    }
+    return input;
+}
+
+int dvbdab_streamer_get_combiner_stats(dvbdab_streamer_t *streamer, dvbdab_combiner_stats_t *stats)
+{
+    if (!streamer || !stats) return -1;
+
+    dvbdab_streamer* target = streamer->combine_target ? streamer->combine_target : streamer;
+    std::lock_guard<std::recursive_mutex> lock(target->api_mutex);
+    if (!target->combiner) return -1;
+
+    const EtiCombiner& c = *target->combiner;
+    memset(stats, 0, sizeof(*stats));
+    stats->output_count = c.getOutputCount();
+    stats->missing_count = c.getMissingCount();
+    stats->late_count = c.getLateCount();
+    stats->misaligned_count = c.getMisalignedCount();
+    stats->unusable_count = c.getUnusableCount();
+    stats->switch_count = c.getSwitchCount();
+    stats->input_frames = c.getSourceFrameCount(streamer->combine_id);
+    stats->input_selected = c.getSourceSelectedCount(streamer->combine_id);
+    stats->input_count = static_cast<int>(target->inputs.size()) + 1;
+    return 0;
+}
+
 void dvbdab_streamer_set_output(dvbdab_streamer_t *streamer,
                                  dvbdab_ts_output_cb callback, void *opaque)
 {
     if (!streamer) return;
 
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+
     streamer->output_cb = callback;
     streamer->output_opaque = opaque;
 
@@ -683,25 +1200,19 @@ int dvbdab_streamer_feed(dvbdab_streamer_t *streamer, const uint8_t *data, size_
 {
     if (!streamer || !data || len == 0) return -1;
 
-    switch (streamer->config.format) {
-    case DVBDAB_FORMAT_ETI_NA: {
-        streamer->ts_buffer.insert(streamer->ts_buffer.end(), data, data + len);
-
-        size_t consumed = process_ts_payloads(streamer->ts_buffer, streamer->config.pid,
-            [streamer](const uint8_t* payload, size_t payload_len, bool /*pusi*/) {
-                // Feed to modular pipeline, get ETI frames via callback
-                etina_feed_payload(streamer->etina_pipeline, payload, payload_len,
-                    [streamer](const uint8_t* eti_ni, size_t len) {
-                        if (!streamer->manager) return;
-                        streamer->etina_detected = true;
-                        streamer->manager->processEtiFrame(streamer->config.pid, eti_ni, len);
-                    });
-            });
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
 
-        ts_buffer_consume(streamer->ts_buffer, consumed);
-        break;
+    if (streamer->recorder) {
+        streamer->recorder->record(data, len);
     }
 
+    switch (streamer->config.format) {
+    case DVBDAB_FORMAT_ETI_NA:
+    case DVBDAB_FORMAT_TSNI:
+        if (!streamer->manager) return -1;
+        feed_eti_ts(streamer, data, len);
+        break;
+
     case DVBDAB_FORMAT_MPE:
         if (!streamer->mpe_source) return -1;
         streamer->mpe_source->feed(data, len);
@@ -717,72 +1228,127 @@ int dvbdab_streamer_feed(dvbdab_streamer_t *streamer, const uint8_t *data, size_
         streamer->bbf_source->feed(data, len);
         break;
 
-    case DVBDAB_FORMAT_TSNI: {
-        // TSNI: TS NI V.11 format - ETI-NI frames with incrementing sequence byte (0x69-0x9A)
+    case DVBDAB_FORMAT_EDI:
         if (!streamer->manager) return -1;
+        streamer->edi_framer.feed(data, len, [streamer](const uint8_t* af, size_t af_len) {
+            streamer->manager->processUdp(streamer->config.filter_ip, streamer->config.filter_port,
+                                          af, af_len);
+        });
+        break;
+    }
 
-        streamer->ts_buffer.insert(streamer->ts_buffer.end(), data, data + len);
-
-        size_t consumed = process_ts_payloads(streamer->ts_buffer, streamer->config.pid,
-            [streamer](const uint8_t* payload, size_t payload_len, bool pusi) {
-                if (pusi && payload_len > 1) {
-                    // Frame boundary - output previous frame if we have data
-                    if (streamer->tsni_frame_buffer.size() >= 4) {
-                        uint8_t seq_byte = streamer->tsni_frame_buffer[0];
-                        std::vector<uint8_t> frame;
-                        frame.reserve(streamer->TSNI_FRAME_SIZE);
-
-                        // ETI-NI sync: ff 07 3a b6 (even) or ff f8 c5 49 (odd)
-                        if (seq_byte % 2 == 0) {
-                            frame.insert(frame.end(), {0xff, 0x07, 0x3a, 0xb6});
-                        } else {
-                            frame.insert(frame.end(), {0xff, 0xf8, 0xc5, 0x49});
-                        }
-                        frame.insert(frame.end(), streamer->tsni_frame_buffer.begin(),
-                                     streamer->tsni_frame_buffer.end());
-
-                        if (frame.size() < streamer->TSNI_FRAME_SIZE) {
-                            frame.resize(streamer->TSNI_FRAME_SIZE, 0x55);
-                        }
-
-                        streamer->tsni_detected = true;
-                        streamer->manager->processEtiFrame(streamer->config.pid, frame.data(), frame.size());
-                    }
-
-                    // Start new frame - skip pointer_field (byte 0)
-                    streamer->tsni_frame_buffer.clear();
-                    streamer->tsni_frame_buffer.insert(streamer->tsni_frame_buffer.end(),
-                                                       payload + 1, payload + payload_len);
-                } else if (!streamer->tsni_frame_buffer.empty()) {
-                    // Continuation - append payload to frame buffer
-                    streamer->tsni_frame_buffer.insert(streamer->tsni_frame_buffer.end(),
-                                                       payload, payload + payload_len);
-                }
-            });
+    return 0;
+}
 
-        ts_buffer_consume(streamer->ts_buffer, consumed);
-        break;
+int dvbdab_streamer_feedv(dvbdab_streamer_t *streamer, const struct iovec *iov, int iovcnt)
+{
+    if (!streamer || (!iov && iovcnt > 0) || iovcnt < 0) return -1;
+
+    // TS sync carries packets split across buffers, so each piece is fed as is
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+    for (int i = 0; i < iovcnt; i++) {
+        if (iov[i].iov_len == 0) continue;
+        dvbdab_streamer_feed(streamer, static_cast<const uint8_t*>(iov[i].iov_base), iov[i].iov_len);
     }
+    return 0;
+}
+
+void dvbdab_streamer_signal_discontinuity(dvbdab_streamer_t *streamer)
+{
+    if (!streamer) return;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+    if (streamer->mpe_source) streamer->mpe_source->markDiscontinuity();
+    if (streamer->gse_source) streamer->gse_source->markDiscontinuity();
+    if (streamer->bbf_source) streamer->bbf_source->markDiscontinuity();
+    // The TSNI frame being collected has a hole; ETI-NA resyncs on its own
+    streamer->tsni_framer.clearFrame();
+    for (dvbdab_streamer* child : streamer->pid_streamers) {
+        std::lock_guard<std::recursive_mutex> child_lock(child->api_mutex);
+        child->tsni_framer.clearFrame();
     }
+}
 
+int dvbdab_streamer_async_start(dvbdab_streamer_t *streamer, size_t max_queued,
+                                 dvbdab_feed_done_cb callback, void *opaque)
+{
+    if (!streamer) return -1;
+
+    std::lock_guard<std::mutex> lock(streamer->async_mutex);
+    if (streamer->async_running) return -1;
+
+    try {
+        streamer->async_ring.resize(max_queued > 0 ? max_queued : 64);
+        streamer->async_head = 0;
+        streamer->async_count = 0;
+        streamer->async_done_cb = callback;
+        streamer->async_opaque = opaque;
+        streamer->async_running = true;
+        streamer->async_thread = std::thread(async_worker, streamer);
+    } catch (...) {
+        streamer->async_running = false;
+        return -1;
+    }
+    return 0;
+}
+
+int dvbdab_streamer_feedv_async(dvbdab_streamer_t *streamer, const struct iovec *iov,
+                                 int iovcnt, void *tag)
+{
+    if (!streamer || (!iov && iovcnt > 0) || iovcnt < 0) return -1;
+
+    std::lock_guard<std::mutex> lock(streamer->async_mutex);
+    if (!streamer->async_running) return -1;
+    if (streamer->async_count == streamer->async_ring.size()) return 1;  // Queue full
+
+    size_t slot = (streamer->async_head + streamer->async_count) % streamer->async_ring.size();
+    auto& buf = streamer->async_ring[slot];
+    try {
+        buf.iov.assign(iov, iov + iovcnt);
+    } catch (...) {
+        return -1;
+    }
+    buf.tag = tag;
+    streamer->async_count++;
+    streamer->async_cv.notify_one();
     return 0;
 }
 
+void dvbdab_streamer_async_flush(dvbdab_streamer_t *streamer)
+{
+    if (!streamer) return;
+
+    std::unique_lock<std::mutex> lock(streamer->async_mutex);
+    streamer->async_idle_cv.wait(lock, [streamer] { return streamer->async_count == 0; });
+}
+
+void dvbdab_streamer_async_stop(dvbdab_streamer_t *streamer)
+{
+    if (!streamer) return;
+    stop_async(streamer);
+}
+
 int dvbdab_streamer_is_ready(dvbdab_streamer_t *streamer)
 {
     if (!streamer) return 0;
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
     return streamer->complete ? 1 : 0;
 }
 
 int dvbdab_streamer_is_basic_ready(dvbdab_streamer_t *streamer)
 {
     if (!streamer) return 0;
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
     return streamer->basic_ready ? 1 : 0;
 }
 
 dvbdab_ensemble_t *dvbdab_streamer_get_ensemble(dvbdab_streamer_t *streamer)
 {
-    if (!streamer || streamer->cached_ensemble.services.empty()) return nullptr;
+    if (!streamer) return nullptr;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+    refresh_ensemble(streamer);
+    if (streamer->cached_ensemble.services.empty()) return nullptr;
 
     auto result = static_cast<dvbdab_ensemble_t*>(calloc(1, sizeof(dvbdab_ensemble_t)));
     if (!result) return nullptr;
@@ -798,6 +1364,8 @@ dvbdab_ensemble_t *dvbdab_streamer_get_ensemble(dvbdab_streamer_t *streamer)
     result->is_etina = (streamer->config.format == DVBDAB_FORMAT_ETI_NA) ? 1 : 0;
     result->is_gse = (streamer->config.format == DVBDAB_FORMAT_GSE ||
                       streamer->config.format == DVBDAB_FORMAT_BBF_TS) ? 1 : 0;
+    result->is_tsni = (streamer->config.format == DVBDAB_FORMAT_TSNI) ? 1 : 0;
+    result->format = streamer->config.format;
 
     if (result->service_count > 0) {
         result->services = static_cast<dvbdab_service_t*>(
@@ -834,6 +1402,8 @@ dvbdab_ensemble_t *dvbdab_streamer_get_all_ensembles(dvbdab_streamer_t *streamer
         return nullptr;
     }
 
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+
     auto all_ensembles = streamer->manager->getAllEnsembles();
     *count = static_cast<int>(all_ensembles.size());
 
@@ -860,6 +1430,7 @@ dvbdab_ensemble_t *dvbdab_streamer_get_all_ensembles(dvbdab_streamer_t *streamer
         out.is_gse = (streamer->config.format == DVBDAB_FORMAT_GSE ||
                       streamer->config.format == DVBDAB_FORMAT_BBF_TS) ? 1 : 0;
         out.is_etina = 0;
+        out.format = streamer->config.format;
 
         if (out.service_count > 0) {
             out.services = static_cast<dvbdab_service_t*>(
@@ -895,6 +1466,8 @@ int dvbdab_streamer_start_service(dvbdab_streamer_t *streamer, uint8_t subchanne
 {
     if (!streamer) return -1;
 
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+
     // Find service info
     const lsdvb::DABService* svc = nullptr;
     for (const auto& s : streamer->cached_ensemble.services) {
@@ -910,7 +1483,8 @@ int dvbdab_streamer_start_service(dvbdab_streamer_t *streamer, uint8_t subchanne
         if (streamer->dabplus_decoders.find(subchannel_id) == streamer->dabplus_decoders.end()) {
             auto decoder = std::make_unique<DabPlusDecoder>(svc->bitrate);
 
-            decoder->setCallback([streamer, subchannel_id](const uint8_t* data, size_t len) {
+            decoder->setFrameCallback([streamer, subchannel_id](const uint8_t* data, size_t len,
+                                                                const uint8_t* au, size_t au_len) {
                 streamer->audio_frame_count++;
                 if (!streamer->muxer || len < 7) return;
 
@@ -930,9 +1504,10 @@ int dvbdab_streamer_start_service(dvbdab_streamer_t *streamer, uint8_t subchanne
                 int64_t pts = streamer->pts_counter[it->second];
                 streamer->pts_counter[it->second] += (int64_t)1024 * 90000 / sample_rate;
 
-                streamer->muxer->feedAudioFrame(subchannel_id, data, len, pts);
+                streamer->muxer->feedAudioFrame(subchannel_id, data, len, au, au_len, pts);
             });
 
+            apply_xpad_mot(streamer, subchannel_id, *decoder);
             streamer->dabplus_decoders[subchannel_id] = std::move(decoder);
         }
     } else {
@@ -976,10 +1551,76 @@ int dvbdab_streamer_start_service(dvbdab_streamer_t *streamer, uint8_t subchanne
     return 0;
 }
 
+void dvbdab_streamer_set_mot_callback(dvbdab_streamer_t *streamer,
+                                       dvbdab_mot_object_cb callback, void *opaque)
+{
+    if (!streamer) return;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+
+    streamer->mot_cb = callback;
+    streamer->mot_opaque = opaque;
+    streamer->packet_mots.clear();
+    apply_mot_subscriptions(streamer);
+}
+
+void dvbdab_streamer_subscribe_mot(dvbdab_streamer_t *streamer, uint32_t sid)
+{
+    if (!streamer) return;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+
+    if (sid == DVBDAB_MOT_ALL) {
+        streamer->mot_all = true;
+    } else {
+        streamer->mot_sids.insert(sid);
+    }
+    apply_mot_subscriptions(streamer);
+}
+
+void dvbdab_streamer_unsubscribe_mot(dvbdab_streamer_t *streamer, uint32_t sid)
+{
+    if (!streamer) return;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+
+    if (sid == DVBDAB_MOT_ALL) {
+        streamer->mot_all = false;
+        streamer->mot_sids.clear();
+    } else {
+        streamer->mot_sids.erase(sid);
+    }
+    apply_mot_subscriptions(streamer);
+}
+
+int dvbdab_streamer_subscribe_subchannel(dvbdab_streamer_t *streamer, uint8_t subchannel_id,
+                                         dvbdab_subchannel_cb callback, void *opaque)
+{
+    if (!streamer || !callback || subchannel_id >= 64) return -1;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+
+    streamer->subchannel_subs[subchannel_id] = {callback, opaque};
+    streamer->subchannel_mask |= uint64_t{1} << subchannel_id;
+    return 0;
+}
+
+void dvbdab_streamer_unsubscribe_subchannel(dvbdab_streamer_t *streamer, uint8_t subchannel_id)
+{
+    if (!streamer || subchannel_id >= 64) return;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+
+    streamer->subchannel_subs[subchannel_id] = {};
+    streamer->subchannel_mask &= ~(uint64_t{1} << subchannel_id);
+}
+
 int dvbdab_streamer_stop_service(dvbdab_streamer_t *streamer, uint8_t subchannel_id)
 {
     if (!streamer) return -1;
 
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+
     streamer->dabplus_decoders.erase(subchannel_id);
     streamer->mp2_decoders.erase(subchannel_id);
 
@@ -1008,6 +1649,8 @@ int dvbdab_streamer_start_all(dvbdab_streamer_t *streamer)
 {
     if (!streamer) return -1;
 
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+
     // Set flag to auto-start when ensemble becomes ready
     streamer->auto_start_all = true;
 
@@ -1019,4 +1662,420 @@ int dvbdab_streamer_start_all(dvbdab_streamer_t *streamer)
     return 0;  // Will start later when ensemble is ready
 }
 
+dvbdab_history_t *dvbdab_history_create(unsigned int duration_ms, size_t max_bytes_per_pid)
+{
+    try {
+        return new dvbdab_history(
+            duration_ms ? duration_ms : TsHistory::DEFAULT_DURATION_MS,
+            max_bytes_per_pid ? max_bytes_per_pid : TsHistory::DEFAULT_MAX_BYTES);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void dvbdab_history_destroy(dvbdab_history_t *history)
+{
+    delete history;
+}
+
+void dvbdab_history_add_pid(dvbdab_history_t *history, uint16_t pid)
+{
+    if (history) history->history.addPid(pid);
+}
+
+void dvbdab_history_remove_pid(dvbdab_history_t *history, uint16_t pid)
+{
+    if (history) history->history.removePid(pid);
+}
+
+void dvbdab_history_feed(dvbdab_history_t *history, const uint8_t *data, size_t len)
+{
+    if (!history || !data) return;
+    history->history.feed(data, len, history->clock);
+}
+
+int dvbdab_streamer_replay_history(dvbdab_streamer_t *streamer,
+                                    const dvbdab_history_t *history)
+{
+    if (!streamer || !history) return -1;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+
+    size_t packets = history->history.replay(streamer->config.pid,
+        [streamer](const uint8_t* data, size_t len) {
+            dvbdab_streamer_feed(streamer, data, len);
+        });
+    if (packets > 0) {
+        streamer->replay_overlap = true;
+    }
+    return static_cast<int>(packets);
+}
+
+int dvbdab_streamer_enable_recorder(dvbdab_streamer_t *streamer,
+                                    const dvbdab_recorder_config_t *config)
+{
+    if (!streamer || !config || !config->directory) return -1;
+
+    // Only the TS sources of MPE/GSE/BBF count continuity errors
+    dvbdab_streamer* s = streamer;
+    bool has_cc = s->config.format == DVBDAB_FORMAT_MPE || s->config.format == DVBDAB_FORMAT_GSE ||
+                  s->config.format == DVBDAB_FORMAT_BBF_TS;
+    if (config->cc_errors && !has_cc) return -1;
+
+    // Allocating and touching the rings takes a while; feeds continue meanwhile
+    std::unique_ptr<FlightRecorder> recorder;
+    try {
+        recorder = std::make_unique<FlightRecorder>(
+            config->directory,
+            config->prefix ? config->prefix : "dvbdab",
+            s->config.format == DVBDAB_FORMAT_EDI ? ".edi" : ".ts",
+            config->duration_ms ? config->duration_ms : FlightRecorder::DEFAULT_DURATION_MS,
+            config->post_trigger_ms ? config->post_trigger_ms : FlightRecorder::DEFAULT_POST_TRIGGER_MS,
+            config->max_bytes);
+        recorder->setCheckInterval(config->check_interval_ms);
+
+        // Triggers read the counters for their baseline, so under the lock
+        std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+        recorder->addTrigger("cc", config->cc_errors, [s]() -> uint64_t {
+            size_t count = 0;
+            if (s->mpe_source) count += s->mpe_source->getDiscontinuityCount();
+            if (s->gse_source) count += s->gse_source->getDiscontinuityCount();
+            if (s->bbf_source) count += s->bbf_source->getDiscontinuityCount();
+            return count;
+        });
+        recorder->addTrigger("fib-crc", config->fib_crc_errors, [s]() -> uint64_t {
+            return s->manager ? s->manager->getFibCrcErrorCount() : 0;
+        });
+        recorder->addTrigger("pf-expired", config->pf_expired, [s]() -> uint64_t {
+            return s->manager ? s->manager->getPfExpiredCount() : 0;
+        });
+        recorder->addTrigger("superframe", config->superframe_resyncs, [s]() -> uint64_t {
+            size_t count = 0;
+            for (const auto& [id, dec] : s->dabplus_decoders) {
+                count += dec->getSyncLossCount();
+            }
+            return count;
+        });
+
+        recorder.swap(streamer->recorder);
+    } catch (...) {
+        return -1;
+    }
+    // The previous recorder (if any) finishes its dump here, outside the lock
+    return 0;
+}
+
+void dvbdab_streamer_disable_recorder(dvbdab_streamer_t *streamer)
+{
+    if (!streamer) return;
+
+    std::unique_ptr<FlightRecorder> recorder;
+    {
+        std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+        recorder = std::move(streamer->recorder);
+    }
+    // Pending dump is written and joined without blocking feeds
+    recorder.reset();
+}
+
+int dvbdab_streamer_trigger_recorder(dvbdab_streamer_t *streamer, const char *reason)
+{
+    if (!streamer) return -1;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+    if (!streamer->recorder) return -1;
+    return streamer->recorder->trigger(reason ? reason : "manual") ? 0 : -1;
+}
+
+int dvbdab_streamer_get_recorder_stats(dvbdab_streamer_t *streamer, dvbdab_recorder_stats_t *stats)
+{
+    if (!streamer || !stats) return -1;
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+    if (!streamer->recorder) return -1;
+
+    const FlightRecorder& r = *streamer->recorder;
+    stats->trigger_count = r.getTriggerCount();
+    stats->skipped_count = r.getSkippedTriggerCount();
+    stats->dump_count = r.getDumpCount();
+    stats->busy = r.isBusy() ? 1 : 0;
+    stats->error = r.getError();
+    return 0;
+}
+
+int dvbdab_streamer_get_subchannel_stats(dvbdab_streamer_t *streamer, unsigned int window_s,
+                                          dvbdab_ensemble_stats_t *ensemble,
+                                          dvbdab_subchannel_stats_t *subchannels,
+                                          int max_subchannels)
+{
+    if (!streamer || (subchannels && max_subchannels < 0)) return -1;
+    if (window_s == 0) window_s = 10;
+    window_s = std::min<unsigned int>(window_s, SubchannelStats::BUCKET_COUNT);
+
+    std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+    const SubchannelStats& stats = streamer->subchannel_stats;
+    const lsdvb::DABEnsemble& ens = streamer->cached_ensemble;
+    unsigned int window_ms = window_s * 1000;
+    unsigned int duration_ms = stats.getWindowDuration(window_ms);
+
+    // Subchannels signalled in the FIC or carried in the window
+    std::map<int, const lsdvb::DABSubchannel*> signalled;
+    int cu_used = 0;
+    for (const auto& sub : ens.subchannels) {
+        signalled[sub.subchannel_id] = &sub;
+        cu_used += sub.size;
+    }
+    uint64_t mask = stats.getSeenMask(window_ms);
+    for (const auto& [id, sub] : signalled) {
+        if (id >= 0 && id < 64) mask |= uint64_t{1} << id;
+    }
+
+    auto kbps = [duration_ms](uint64_t bytes) {
+        return duration_ms ? bytes * 8.0 / duration_ms : 0.0;
+    };
+
+    int count = 0;
+    int written = 0;
+    double carried_kbps = 0;
+    for (uint8_t id = 0; id < 64; id++) {
+        if (!(mask & (uint64_t{1} << id))) continue;
+        count++;
+
+        SubchannelStats::Window w = stats.getWindow(id, window_ms);
+        carried_kbps += kbps(w.bytes);
+        if (!subchannels || written >= max_subchannels) continue;
+
+        dvbdab_subchannel_stats_t& out = subchannels[written++];
+        std::memset(&out, 0, sizeof(out));
+        out.subchannel_id = id;
+        auto it = signalled.find(id);
+        if (it != signalled.end()) {
+            out.dabplus = it->second->dabplus ? 1 : 0;
+            out.start_cu = it->second->start_addr;
+            out.size_cu = it->second->size;
+            out.signalled_kbps = it->second->bitrate;
+        }
+        for (const auto& svc : ens.services) {
+            if (svc.subchannel_id == id) {
+                out.sid = svc.sid;
+                break;
+            }
+        }
+
+        out.carried_kbps = kbps(w.bytes);
+        out.cif_count = w.cifs;
+        out.decoded = w.decoded ? 1 : 0;
+        out.au_kbps = kbps(w.decoder.au_bytes);
+        out.pad_kbps = kbps(w.decoder.pad_bytes);
+        out.au_count = w.decoder.au_count;
+        out.au_crc_errors = w.decoder.au_errors;
+        out.au_error_rate = w.decoder.au_count ?
+            static_cast<double>(w.decoder.au_errors) / w.decoder.au_count : 0.0;
+        out.superframe_count = w.decoder.superframes;
+        out.firecode_errors = w.decoder.firecode_errors;
+        out.firecode_error_rate = w.decoder.superframes ?
+            static_cast<double>(w.decoder.firecode_errors) / w.decoder.superframes : 0.0;
+    }
+
+    if (ensemble) {
+        ensemble->window_ms = duration_ms;
+        ensemble->cu_used = cu_used;
+        ensemble->cu_capacity = DVBDAB_ENSEMBLE_CU;
+        ensemble->cu_usage = static_cast<double>(cu_used) / DVBDAB_ENSEMBLE_CU;
+        ensemble->carried_kbps = carried_kbps;
+        ensemble->subchannel_count = count;
+    }
+    return written;
+}
+
+dvbdab_reader_t *dvbdab_reader_create(int fd, size_t ring_size, size_t dvr_buffer_size)
+{
+    if (fd < 0) return nullptr;
+
+    try {
+        auto r = new dvbdab_reader(fd,
+                                   ring_size ? ring_size : DvrReader::DEFAULT_RING_SIZE,
+                                   dvr_buffer_size ? dvr_buffer_size : DvrReader::DEFAULT_DVR_BUFFER_SIZE);
+        if (!r->reader.start()) {
+            delete r;
+            return nullptr;
+        }
+        return r;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void dvbdab_reader_destroy(dvbdab_reader_t *reader)
+{
+    delete reader;
+}
+
+long dvbdab_reader_feed_streamer(dvbdab_reader_t *reader, dvbdab_streamer_t *streamer,
+                                 unsigned int timeout_ms)
+{
+    if (!reader || !streamer) return -1;
+
+    size_t fed = reader->reader.consume([streamer](const uint8_t* data, size_t len) {
+        dvbdab_streamer_feed(streamer, data, len);
+    }, timeout_ms);
+    if (fed == 0 && reader->reader.finished()) return -1;
+    return static_cast<long>(fed);
+}
+
+void dvbdab_reader_get_stats(const dvbdab_reader_t *reader, dvbdab_reader_stats_t *stats)
+{
+    if (!reader || !stats) return;
+
+    const DvrReader& r = reader->reader;
+    stats->bytes_read = r.getBytesRead();
+    stats->read_count = r.getReadCount();
+    stats->overflow_count = r.getOverflowCount();
+    stats->ring_full_count = r.getRingFullCount();
+    stats->rate = r.getRate();
+    stats->read_size = r.getReadSize();
+    stats->dvr_buffer_size = r.getDvrBufferSize();
+    stats->error = r.getError();
+}
+
+dvbdab_udp_ts_t *dvbdab_udp_ts_open(const char *address, uint16_t port,
+                                    const char *interface, dvbdab_udp_ts_mode_t mode)
+{
+    if (port == 0) return nullptr;
+
+    UdpTsReceiver::Mode m = UdpTsReceiver::Mode::Auto;
+    switch (mode) {
+    case DVBDAB_UDP_TS_AUTO:   m = UdpTsReceiver::Mode::Auto; break;
+    case DVBDAB_UDP_TS_RING:   m = UdpTsReceiver::Mode::Ring; break;
+    case DVBDAB_UDP_TS_SOCKET: m = UdpTsReceiver::Mode::Socket; break;
+    default: return nullptr;
+    }
+
+    try {
+        auto rx = new dvbdab_udp_ts(address, port, interface, m);
+        if (!rx->receiver.open()) {
+            delete rx;
+            return nullptr;
+        }
+        return rx;
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void dvbdab_udp_ts_destroy(dvbdab_udp_ts_t *rx)
+{
+    delete rx;
+}
+
+long dvbdab_udp_ts_feed_streamer(dvbdab_udp_ts_t *rx, dvbdab_streamer_t *streamer,
+                                 unsigned int timeout_ms)
+{
+    if (!rx || !streamer) return -1;
+
+    size_t fed = rx->receiver.consume([streamer](const struct iovec* iov, int iovcnt, bool discontinuity) {
+        if (discontinuity) dvbdab_streamer_signal_discontinuity(streamer);
+        dvbdab_streamer_feedv(streamer, iov, iovcnt);
+    }, timeout_ms);
+    return static_cast<long>(fed);
+}
+
+void dvbdab_udp_ts_get_stats(const dvbdab_udp_ts_t *rx, dvbdab_udp_ts_stats_t *stats)
+{
+    if (!rx || !stats) return;
+
+    const UdpTsReceiver& r = rx->receiver;
+    stats->datagram_count = r.getDatagramCount();
+    stats->rtp_count = r.getRtpCount();
+    stats->sequence_gaps = r.getSequenceGapCount();
+    stats->lost_datagrams = r.getLostDatagramCount();
+    stats->invalid_count = r.getInvalidCount();
+    stats->drop_count = r.getDropCount();
+    stats->ring = r.usesRing() ? 1 : 0;
+    stats->error = r.getError();
+}
+
+dvbdab_edi_tcp_t *dvbdab_edi_tcp_connect(const char *host, uint16_t port)
+{
+    if (!host || !*host || port == 0) return nullptr;
+
+    try {
+        return new dvbdab_edi_tcp(EdiTcpSource::Mode::Client, host, port);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+dvbdab_edi_tcp_t *dvbdab_edi_tcp_listen(const char *bind_addr, uint16_t port)
+{
+    if (port == 0) return nullptr;
+
+    try {
+        return new dvbdab_edi_tcp(EdiTcpSource::Mode::Server, bind_addr, port);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void dvbdab_edi_tcp_destroy(dvbdab_edi_tcp_t *tcp)
+{
+    delete tcp;
+}
+
+long dvbdab_edi_tcp_feed_streamer(dvbdab_edi_tcp_t *tcp, dvbdab_streamer_t *streamer,
+                                  unsigned int timeout_ms)
+{
+    if (!tcp || !streamer || streamer->config.format != DVBDAB_FORMAT_EDI) return -1;
+
+    size_t fed = tcp->source.consume([tcp, streamer](const uint8_t* data, size_t len) {
+        std::lock_guard<std::recursive_mutex> lock(streamer->api_mutex);
+        // A new connection starts at a packet boundary; drop the partial packet of the old one
+        if (streamer->edi_connect_count != tcp->source.getConnectCount()) {
+            streamer->edi_connect_count = tcp->source.getConnectCount();
+            streamer->edi_framer.reset();
+        }
+        dvbdab_streamer_feed(streamer, data, len);
+    }, timeout_ms);
+    return static_cast<long>(fed);
+}
+
+void dvbdab_edi_tcp_get_stats(const dvbdab_edi_tcp_t *tcp, dvbdab_edi_tcp_stats_t *stats)
+{
+    if (!tcp || !stats) return;
+
+    const EdiTcpSource& src = tcp->source;
+    stats->bytes_read = src.getBytesRead();
+    stats->rate = src.getRate();
+    stats->connect_count = src.getConnectCount();
+    stats->connected = src.isConnected() ? 1 : 0;
+    stats->error = src.getError();
+}
+
+int dvbdab_set_thread_config(dvbdab_thread_role_t role, const dvbdab_thread_config_t *config)
+{
+    ThreadRole r;
+    switch (role) {
+    case DVBDAB_THREAD_DVR_READER: r = ThreadRole::DvrReader; break;
+    case DVBDAB_THREAD_ASYNC_FEED: r = ThreadRole::AsyncFeed; break;
+    case DVBDAB_THREAD_UDP_SENDER: r = ThreadRole::UdpSender; break;
+    case DVBDAB_THREAD_RECORDER:   r = ThreadRole::Recorder; break;
+    default: return -1;
+    }
+
+    ThreadConfig cfg;
+    if (config) {
+        if (config->cpu_count < 0 || (config->cpu_count > 0 && !config->cpus)) return -1;
+        try {
+            cfg.cpus.assign(config->cpus, config->cpus + config->cpu_count);
+        } catch (...) {
+            return -1;
+        }
+        cfg.policy = config->policy;
+        cfg.priority = config->priority;
+        cfg.numa_node = config->numa_node;
+    }
+    setThreadConfig(r, cfg);
+    return 0;
+}
+
 } // extern "C"
@@ -3,9 +3,15 @@
 
 namespace dvbdab {
 
-EnsembleManager::EnsembleManager() = default;
+EnsembleManager::EnsembleManager()
+    : reassembler_([this](const uint8_t* ip_data, size_t len) {
+          routeIpPacket(ip_data, len);
+      })
+{
+}
 
 void EnsembleManager::reset() {
+    reassembler_.reset();
     parsers_.clear();
     etina_parsers_.clear();
     ensembles_.clear();
@@ -15,6 +21,30 @@ void EnsembleManager::reset() {
     complete_count_ = 0;
 }
 
+void EnsembleManager::subscribeSubchannel(uint8_t subchannel_id, SubchannelCifCallback callback) {
+    if (subchannel_id >= subchannel_callbacks_.size()) return;
+    if (!callback) {
+        unsubscribeSubchannel(subchannel_id);
+        return;
+    }
+    subchannel_callbacks_[subchannel_id] = std::move(callback);
+    subchannel_mask_ |= uint64_t{1} << subchannel_id;
+}
+
+void EnsembleManager::unsubscribeSubchannel(uint8_t subchannel_id) {
+    if (subchannel_id >= subchannel_callbacks_.size()) return;
+    subchannel_callbacks_[subchannel_id] = nullptr;
+    subchannel_mask_ &= ~(uint64_t{1} << subchannel_id);
+}
+
+void EnsembleManager::emitSubchannels(const StreamKey& key, const uint8_t* eti_ni, size_t len, uint16_t cif_count) {
+    forEachEtiSubchannel(eti_ni, len, [&](uint8_t scid, const uint8_t* data, size_t size) {
+        if (subchannel_mask_ & (uint64_t{1} << scid)) {
+            subchannel_callbacks_[scid](key, scid, data, size, cif_count);
+        }
+    });
+}
+
 lsdvb::DABStreamParser& EnsembleManager::getParser(const StreamKey& key) {
     auto it = parsers_.find(key);
     if (it != parsers_.end()) {
@@ -31,6 +61,9 @@ lsdvb::DABStreamParser& EnsembleManager::getParser(const StreamKey& key) {
         if (eti_callback_) {
             eti_callback_(key, data, len, dflc);
         }
+        if (subchannel_mask_) {
+            emitSubchannels(key, data, len, dflc);
+        }
     });
 
     auto& ref = *parser;
@@ -118,7 +151,16 @@ void EnsembleManager::processUdp(uint32_t dst_ip, uint16_t dst_port, const uint8
     }
 }
 
-void EnsembleManager::processIpPacket(const uint8_t* ip_data, size_t len) {
+void EnsembleManager::processIpPacket(const uint8_t* ip_data, size_t len, const Clock& clock) {
+    // UDP fragments are collected; the reassembled datagram is routed on completion
+    if (isIpv4Fragment(ip_data, len)) {
+        if (ip_data[9] == 17) reassembler_.process(ip_data, len, clock);
+        return;
+    }
+    routeIpPacket(ip_data, len);
+}
+
+void EnsembleManager::routeIpPacket(const uint8_t* ip_data, size_t len) {
     if (len < 28) return;  // Need at least IP + UDP header
 
     // Verify IPv4
@@ -164,6 +206,15 @@ std::map<StreamKey, lsdvb::DABEnsemble> EnsembleManager::getAllEnsembles() const
     return result;
 }
 
+const lsdvb::DABEnsemble* EnsembleManager::findEnsemble(const StreamKey& key) const {
+    if (key.port == 0) {
+        auto it = etina_parsers_.find(static_cast<uint16_t>(key.ip));
+        if (it != etina_parsers_.end()) return &it->second->get_ensemble();
+    }
+    auto it = parsers_.find(key);
+    return it != parsers_.end() ? &it->second->get_ensemble() : nullptr;
+}
+
 bool EnsembleManager::isComplete(const StreamKey& key) const {
     auto it = complete_flags_.find(key);
     return it != complete_flags_.end() && it->second;
@@ -178,6 +229,22 @@ bool EnsembleManager::allComplete() const {
     return true;
 }
 
+size_t EnsembleManager::getFibCrcErrorCount() const {
+    size_t count = 0;
+    for (const auto& [key, parser] : parsers_) {
+        count += parser->get_fib_crc_errors();
+    }
+    return count;
+}
+
+size_t EnsembleManager::getPfExpiredCount() const {
+    size_t count = 0;
+    for (const auto& [key, parser] : parsers_) {
+        count += parser->get_pf_expired_count();
+    }
+    return count;
+}
+
 void EnsembleManager::processEtiFrame(uint16_t pid, const uint8_t* eti_ni, size_t len) {
     // Use PID as key (ip=pid, port=0) for ETI-NA streams
     StreamKey key{static_cast<uint32_t>(pid), 0};
@@ -207,6 +274,11 @@ void EnsembleManager::processEtiFrame(uint16_t pid, const uint8_t* eti_ni, size_
         eti_callback_(key, eti_ni, len, 0);
     }
 
+    // ETI-NI only carries the FCT (DFLC mod 250)
+    if (subchannel_mask_ && len >= 5) {
+        emitSubchannels(key, eti_ni, len, eti_ni[4]);
+    }
+
     // Check for complete
     if (parser.is_complete() && !complete_flags_[key]) {
         complete_flags_[key] = true;
@@ -2,6 +2,8 @@
 
 #include <dvbdab/dvbdab.hpp>
 #include "../src/dab_parser.h"
+#include "parsers/ipv4_reassembler.hpp"
+#include <array>
 #include <map>
 #include <memory>
 #include <functional>
@@ -28,6 +30,35 @@ struct SubchannelChange {
 // Callback for subchannel mapping changes (for dynamic PMT updates)
 using SubchannelChangeCallback = std::function<void(const StreamKey& key, const std::vector<SubchannelChange>& changes)>;
 
+// Walk the subchannel streams (MST) of an ETI-NI frame:
+// fn(uint8_t subchannel_id, const uint8_t* data, size_t len) per stream
+template<typename Fn>
+void forEachEtiSubchannel(const uint8_t* eti_ni, size_t len, Fn&& fn) {
+    if (len < 12) return;
+
+    uint8_t nst = eti_ni[5] & 0x7F;
+    uint8_t ficf = (eti_ni[5] >> 7) & 0x01;
+    uint8_t mid = (eti_ni[6] >> 3) & 0x03;
+
+    size_t fic_size = 0;
+    if (ficf) {
+        fic_size = mid == 2 ? 32 : mid == 3 ? 128 : 96;
+    }
+    size_t stream_offset = 4 + 4 + nst * 4 + 4 + fic_size;  // SYNC + FC + STC + EOH + FIC
+
+    for (uint8_t i = 0; i < nst && i < 64; i++) {
+        size_t stc_pos = 8 + i * 4;
+        if (stc_pos + 4 > len) break;
+
+        uint8_t scid = (eti_ni[stc_pos] >> 2) & 0x3F;
+        size_t stream_size = (((eti_ni[stc_pos + 2] & 0x03) << 8) | eti_ni[stc_pos + 3]) * 8;
+        if (stream_offset + stream_size > len) break;
+
+        fn(scid, eti_ni + stream_offset, stream_size);
+        stream_offset += stream_size;
+    }
+}
+
 // Manages multiple DAB ensembles, routing UDP packets by destination ip:port
 class EnsembleManager {
 public:
@@ -48,6 +79,12 @@ public:
         eti_callback_ = std::move(callback);
     }
 
+    // Subscribe to the raw MSC data of a subchannel (0-63) in every stream;
+    // data is passed straight out of the ETI frame and is only valid during
+    // the call. Replaces any previous subscription for that subchannel.
+    void subscribeSubchannel(uint8_t subchannel_id, SubchannelCifCallback callback);
+    void unsubscribeSubchannel(uint8_t subchannel_id);
+
     // Set callback for subchannel mapping changes (for dynamic PMT updates)
     void setSubchannelChangeCallback(SubchannelChangeCallback callback) {
         subchannel_change_callback_ = std::move(callback);
@@ -57,8 +94,9 @@ public:
     // Routes to the appropriate per-stream parser
     void processUdp(uint32_t dst_ip, uint16_t dst_port, const uint8_t* payload, size_t len);
 
-    // Process a raw IPv4 packet (extracts UDP and routes)
-    void processIpPacket(const uint8_t* ip_data, size_t len);
+    // Process a raw IPv4 packet (reassembles fragments, extracts UDP and routes;
+    // clock: time base for fragment timeouts)
+    void processIpPacket(const uint8_t* ip_data, size_t len, const Clock& clock);
 
     // Process a raw ETI-NI frame directly (for ETI-NA where we already have ETI frames)
     void processEtiFrame(uint16_t pid, const uint8_t* eti_ni, size_t len);
@@ -69,6 +107,9 @@ public:
     // Get all ensembles (complete or not) - for iterating all discovered streams
     std::map<StreamKey, lsdvb::DABEnsemble> getAllEnsembles() const;
 
+    // Current FIC state of one stream (EDI or ETI-NA key), nullptr if unknown
+    const lsdvb::DABEnsemble* findEnsemble(const StreamKey& key) const;
+
     // Check if a specific stream is complete
     bool isComplete(const StreamKey& key) const;
 
@@ -81,6 +122,10 @@ public:
     // Get count of total streams seen
     size_t getStreamCount() const { return parsers_.size(); }
 
+    // Error counters summed over all streams
+    size_t getFibCrcErrorCount() const;
+    size_t getPfExpiredCount() const;
+
     // Reset all state
     void reset();
 
@@ -88,6 +133,9 @@ private:
     // Get or create parser for a stream
     lsdvb::DABStreamParser& getParser(const StreamKey& key);
 
+    // Pass the subscribed subchannel streams of an ETI-NI frame to their callbacks
+    void emitSubchannels(const StreamKey& key, const uint8_t* eti_ni, size_t len, uint16_t cif_count);
+
     std::map<StreamKey, std::unique_ptr<lsdvb::DABStreamParser>> parsers_;
     std::map<StreamKey, lsdvb::DABEnsemble> ensembles_;
     std::map<StreamKey, bool> basic_ready_flags_;
@@ -98,12 +146,22 @@ private:
     EtiFrameCallback eti_callback_;
     SubchannelChangeCallback subchannel_change_callback_;
 
+    // Raw subchannel subscriptions; bit n of the mask is set if subchannel n has one
+    std::array<SubchannelCifCallback, 64> subchannel_callbacks_;
+    uint64_t subchannel_mask_{0};
+
     // Track previous subchannel mappings for change detection
     std::map<StreamKey, std::map<uint32_t, uint8_t>> last_subchannel_map_;  // key -> (sid -> subchannel_id)
 
     // ETI-NA parsers (keyed by PID) - for direct ETI-NI frame processing
     std::map<uint16_t, std::unique_ptr<lsdvb::DABParser>> etina_parsers_;
 
+    // Complete IPv4 datagram -> UDP -> processUdp()
+    void routeIpPacket(const uint8_t* ip_data, size_t len);
+
+    // Fragment reassembly for processIpPacket()
+    Ipv4Reassembler reassembler_;
+
     size_t complete_count_{0};
 };
 
@@ -0,0 +1,268 @@
+// ETI diversity combiner - best-of-N frame selection for redundant feeds
+
+#include "eti_combiner.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace dvbdab {
+
+// CRC-16 CCITT (same polynomial/init as EDI and ETI-NI header/EOF CRCs)
+static uint16_t eti_crc16(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc ^ 0xFFFF;
+}
+
+static inline bool crc_matches(const uint8_t* data, size_t len, const uint8_t* stored) {
+    return eti_crc16(data, len) == ((stored[0] << 8) | stored[1]);
+}
+
+static inline bool tist_valid(uint32_t tist) {
+    return (tist & 0xFFFFFF) != 0xFFFFFF;
+}
+
+EtiFrameQuality etiFrameQuality(const uint8_t* frame, size_t len) {
+    EtiFrameQuality q;
+    if (!frame || len < 12) return q;
+
+    // FSYNC (byte 0 is ERR, 0xFF = no error)
+    bool odd = frame[1] == 0xF8 && frame[2] == 0xC5 && frame[3] == 0x49;
+    bool even = frame[1] == 0x07 && frame[2] == 0x3A && frame[3] == 0xB6;
+    if (!odd && !even) return q;
+
+    // FC
+    q.fct = frame[4];
+    if (q.fct >= 250) return q;
+    bool ficf = (frame[5] & 0x80) != 0;
+    int nst = frame[5] & 0x7F;
+    uint8_t mid = (frame[6] >> 3) & 0x03;
+    uint16_t fl = ((frame[6] & 0x07) << 8) | frame[7];
+
+    // EOH: MNSC + header CRC over FC, STC and MNSC
+    size_t eoh = 8 + static_cast<size_t>(nst) * 4;
+    if (eoh + 4 > len) return q;
+    if (!crc_matches(frame + 4, eoh + 2 - 4, frame + eoh + 2)) return q;
+    q.usable = true;
+
+    // STC: start addresses inside the 864 CU CIF, FL consistent with stream lengths
+    size_t mst_start = eoh + 4;
+    size_t fic_len = ficf ? (mid == 3 ? 128 : 96) : 0;
+    size_t words = static_cast<size_t>(nst) + 1 + fic_len / 4;
+    bool sad_ok = true;
+    for (int i = 0; i < nst; i++) {
+        const uint8_t* stc = frame + 8 + i * 4;
+        uint16_t sad = ((stc[0] & 0x03) << 8) | stc[1];
+        uint16_t stl = ((stc[2] & 0x03) << 8) | stc[3];
+        if (sad >= 864) sad_ok = false;
+        words += static_cast<size_t>(stl) * 2;
+    }
+    size_t eof = 8 + static_cast<size_t>(fl) * 4;
+    q.stc_ok = sad_ok && words == fl && eof + 4 <= len;
+
+    // FIBs (30 bytes + CRC each)
+    if (mst_start + fic_len <= len) {
+        q.fib_total = static_cast<int>(fic_len / 32);
+        for (int i = 0; i < q.fib_total; i++) {
+            const uint8_t* fib = frame + mst_start + i * 32;
+            if (crc_matches(fib, 30, fib + 30)) {
+                q.fib_ok++;
+            }
+        }
+    }
+
+    // EOF: CRC over FIC + all subchannels, then TIST
+    if (q.stc_ok) {
+        q.mst_crc_ok = crc_matches(frame + mst_start, eof - mst_start, frame + eof);
+        if (eof + 8 <= len) {
+            const uint8_t* t = frame + eof + 4;
+            q.tist = (static_cast<uint32_t>(t[0]) << 24) | (t[1] << 16) | (t[2] << 8) | t[3];
+        }
+    }
+
+    // MST CRC guarantees every subchannel; FIBs matter for service info
+    q.score = (q.mst_crc_ok ? 32 : 0) + q.fib_ok * 4 + (q.stc_ok ? 8 : 0) +
+              (frame[0] == 0xFF ? 1 : 0);
+    return q;
+}
+
+EtiCombiner::EtiCombiner(unsigned int max_delay_frames)
+    : max_delay_(max_delay_frames)
+    , slots_(max_delay_frames + 1)
+{
+}
+
+void EtiCombiner::reset() {
+    for (auto& slot : slots_) {
+        slot.filled = false;
+        slot.score = -1;
+    }
+    sources_.clear();
+    synced_ = false;
+    head_seq_ = 0;
+    next_out_seq_ = 0;
+    dflc_offset_ = 0;
+    has_last_source_ = false;
+    output_count_ = 0;
+    missing_count_ = 0;
+    late_count_ = 0;
+    misaligned_count_ = 0;
+    unusable_count_ = 0;
+    switch_count_ = 0;
+}
+
+EtiCombiner::Source& EtiCombiner::getSource(uint32_t id) {
+    for (auto& src : sources_) {
+        if (src.id == id) return src;
+    }
+    sources_.push_back(Source{});
+    sources_.back().id = id;
+    return sources_.back();
+}
+
+void EtiCombiner::feed(uint32_t source_id, const uint8_t* frame, size_t len, uint16_t dflc) {
+    Source& src = getSource(source_id);
+    src.frames++;
+
+    if (len > slots_[0].frame.size()) {
+        unusable_count_++;
+        return;
+    }
+
+    EtiFrameQuality q = etiFrameQuality(frame, len);
+    if (!q.usable) {
+        unusable_count_++;
+        return;
+    }
+
+    // Map FCT (0-249) onto the running slot sequence, nearest to the head
+    int64_t seq;
+    if (!synced_) {
+        synced_ = true;
+        seq = q.fct;
+        head_seq_ = seq;
+        next_out_seq_ = seq;
+    } else {
+        int delta = (q.fct - static_cast<int>(head_seq_ % 250) + 250) % 250;
+        if (delta >= 125) delta -= 250;
+        seq = head_seq_ + delta;
+    }
+
+    // Learn DFLC numbering from EDI sources (DFLC mod 250 == FCT)
+    if (dflc != 0 && dflc % 250 == q.fct) {
+        dflc_offset_ = static_cast<int>(((dflc - seq) % 5000 + 5000) % 5000);
+    }
+
+    src.last_seq = std::max(src.last_seq, seq);
+
+    if (seq < next_out_seq_) {
+        // Slot already output - this feed lags more than the latency bound
+        late_count_++;
+        src.last_seq = seq;
+        return;
+    }
+
+    // Keep the ring within bounds before touching the slot for seq
+    while (seq - next_out_seq_ >= static_cast<int64_t>(slots_.size())) {
+        emit(next_out_seq_);
+    }
+    if (seq > head_seq_) {
+        head_seq_ = seq;
+    }
+
+    Slot& slot = slotFor(seq);
+    if (slot.filled && tist_valid(slot.tist) && tist_valid(q.tist) && slot.tist != q.tist) {
+        // Same FCT but different timestamp - not the same multiplex frame
+        misaligned_count_++;
+    } else {
+        // Prefer the currently selected source on equal quality (no needless switching)
+        bool better = !slot.filled || q.score > slot.score ||
+                      (q.score == slot.score && has_last_source_ &&
+                       source_id == last_source_ && slot.source_id != last_source_);
+        if (better) {
+            std::memcpy(slot.frame.data(), frame, len);
+            slot.len = len;
+            slot.filled = true;
+            slot.score = q.score;
+            slot.source_id = source_id;
+            slot.tist = q.tist;
+        }
+    }
+
+    emitReady();
+}
+
+bool EtiCombiner::sourcesDelivered(int64_t seq) const {
+    for (const auto& src : sources_) {
+        // Sources lagging beyond the latency bound don't hold back output
+        bool active = src.last_seq >= head_seq_ - static_cast<int64_t>(max_delay_);
+        if (active && src.last_seq < seq) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void EtiCombiner::emitReady() {
+    while (next_out_seq_ <= head_seq_) {
+        bool expired = head_seq_ - next_out_seq_ >= static_cast<int64_t>(max_delay_);
+        if (!expired && !sourcesDelivered(next_out_seq_)) {
+            break;
+        }
+        emit(next_out_seq_);
+    }
+}
+
+void EtiCombiner::emit(int64_t seq) {
+    Slot& slot = slotFor(seq);
+    next_out_seq_ = seq + 1;
+
+    if (!slot.filled) {
+        missing_count_++;
+        return;
+    }
+
+    if (has_last_source_ && slot.source_id != last_source_) {
+        switch_count_++;
+    }
+    has_last_source_ = true;
+    last_source_ = slot.source_id;
+    getSource(slot.source_id).selected++;
+    output_count_++;
+
+    slot.filled = false;
+    slot.score = -1;
+
+    if (callback_) {
+        uint16_t dflc = static_cast<uint16_t>((seq + dflc_offset_) % 5000);
+        callback_(slot.frame.data(), slot.len, dflc);
+    }
+}
+
+size_t EtiCombiner::getSourceFrameCount(uint32_t source_id) const {
+    for (const auto& src : sources_) {
+        if (src.id == source_id) return src.frames;
+    }
+    return 0;
+}
+
+size_t EtiCombiner::getSourceSelectedCount(uint32_t source_id) const {
+    for (const auto& src : sources_) {
+        if (src.id == source_id) return src.selected;
+    }
+    return 0;
+}
+
+void EtiCombiner::flush() {
+    if (!synced_) return;
+    while (next_out_seq_ <= head_seq_) {
+        emit(next_out_seq_);
+    }
+}
+
+} // namespace dvbdab
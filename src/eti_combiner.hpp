@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace dvbdab {
+
+// Combined ETI output (same signature as per-stream ETI callbacks)
+using CombinedEtiCallback = std::function<void(const uint8_t* frame, size_t len, uint16_t dflc)>;
+
+// Quality of a single ETI-NI frame (used to pick the best copy per 24ms slot)
+struct EtiFrameQuality {
+    bool usable{false};       // Sync + FC + header CRC OK
+    int score{0};             // Higher is better
+    uint8_t fct{0};           // Frame count (0-249)
+    uint32_t tist{0xFFFFFF};  // Timestamp (0xFFFFFF = not present)
+    int fib_ok{0};            // FIBs with valid CRC
+    int fib_total{0};         // FIBs in frame
+    bool mst_crc_ok{false};   // EOF CRC over FIC + subchannels
+    bool stc_ok{false};       // Subchannel table within 864 CUs and FL consistent
+};
+
+// Evaluate an ETI-NI frame (6144 bytes, or 6140 without TIST padding)
+EtiFrameQuality etiFrameQuality(const uint8_t* frame, size_t len);
+
+// Diversity combiner for redundant feeds of the same ensemble.
+//
+// Several sources (e.g. the same EID via two satellites, or MPE + ETI-NA)
+// feed ETI frames; frames are aligned on FCT (and DFLC when available),
+// cross-checked with TIST, and for every 24ms slot the copy with the best
+// quality (header CRC, FIB CRCs, subchannel table, MST CRC) is output.
+// A slot is output as soon as every active source delivered it, and at the
+// latest max_delay_frames after the newest frame seen - that bounds the added
+// latency. Sources lagging further behind are ignored until they catch up.
+//
+// Usage:
+//   EtiCombiner combiner(10);
+//   combiner.setOutputCallback(...);
+//   manager_a.setEtiCallback([&](const StreamKey&, const uint8_t* f, size_t n, uint16_t d) {
+//       combiner.feed(0, f, n, d);
+//   });
+//   manager_b.setEtiCallback([&](...) { combiner.feed(1, f, n, d); });
+class EtiCombiner {
+public:
+    // max_delay_frames: added latency bound in 24ms frames (also the maximum
+    // delay difference between feeds that can still be combined)
+    explicit EtiCombiner(unsigned int max_delay_frames = 10);
+
+    void setOutputCallback(CombinedEtiCallback callback) { callback_ = std::move(callback); }
+
+    // Feed an ETI frame from a source (source_id chosen by caller, e.g. feed index)
+    // dflc = Data Flow Counter if known (EDI), 0 if not (ETI-NA, TSNI)
+    void feed(uint32_t source_id, const uint8_t* frame, size_t len, uint16_t dflc);
+
+    // Output all pending slots (e.g. at end of input)
+    void flush();
+
+    // Reset all state (sources, alignment, statistics)
+    void reset();
+
+    // Statistics
+    size_t getOutputCount() const { return output_count_; }      // Frames output
+    size_t getMissingCount() const { return missing_count_; }    // Slots no source delivered
+    size_t getLateCount() const { return late_count_; }          // Frames dropped (slot already output)
+    size_t getMisalignedCount() const { return misaligned_count_; }  // Frames dropped on TIST mismatch
+    size_t getUnusableCount() const { return unusable_count_; }  // Frames dropped (bad sync/header)
+    size_t getSwitchCount() const { return switch_count_; }      // Changes of selected source
+
+    // Per-source statistics (0 for unknown source_id)
+    size_t getSourceFrameCount(uint32_t source_id) const;     // Frames received
+    size_t getSourceSelectedCount(uint32_t source_id) const;  // Frames chosen for output
+
+private:
+    struct Slot {
+        std::array<uint8_t, 6144> frame{};
+        size_t len{0};
+        bool filled{false};
+        int score{-1};
+        uint32_t source_id{0};
+        uint32_t tist{0xFFFFFF};
+    };
+
+    struct Source {
+        uint32_t id{0};
+        int64_t last_seq{-1};  // Newest slot delivered
+        size_t frames{0};
+        size_t selected{0};
+    };
+
+    Source& getSource(uint32_t id);
+    Slot& slotFor(int64_t seq) { return slots_[static_cast<size_t>(seq % slots_.size())]; }
+    bool sourcesDelivered(int64_t seq) const;
+    void emit(int64_t seq);
+    void emitReady();
+
+    CombinedEtiCallback callback_;
+    unsigned int max_delay_;
+    std::vector<Slot> slots_;
+    std::vector<Source> sources_;
+
+    bool synced_{false};
+    int64_t head_seq_{0};      // Newest slot seen
+    int64_t next_out_seq_{0};  // Next slot to output
+    int dflc_offset_{0};       // (DFLC - seq) mod 5000, learned from sources reporting DFLC
+    bool has_last_source_{false};
+    uint32_t last_source_{0};  // Source of the previously output frame
+
+    size_t output_count_{0};
+    size_t missing_count_{0};
+    size_t late_count_{0};
+    size_t misaligned_count_{0};
+    size_t unusable_count_{0};
+    size_t switch_count_{0};
+};
+
+} // namespace dvbdab
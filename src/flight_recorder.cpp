@@ -0,0 +1,222 @@
+#include "flight_recorder.hpp"
+#include "thread_config.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace dvbdab {
+
+namespace {
+
+bool writeAll(int fd, const uint8_t* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Keep file names to [A-Za-z0-9_.]
+std::string fileNamePart(const std::string& s) {
+    std::string out = s.empty() ? std::string("manual") : s;
+    for (char& c : out) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '.') c = '-';
+    }
+    return out;
+}
+
+} // namespace
+
+FlightRecorder::FlightRecorder(std::string directory, std::string prefix, std::string suffix,
+                               unsigned int duration_ms, unsigned int post_trigger_ms, size_t max_bytes)
+    : directory_(std::move(directory))
+    , prefix_(std::move(prefix))
+    , suffix_(std::move(suffix))
+    , duration_(duration_ms)
+    , post_trigger_(post_trigger_ms)
+    , capacity_(max_bytes > 0 ? max_bytes : DEFAULT_MAX_BYTES)
+    , index_(INDEX_SIZE)
+{
+    // Touch the rings now so recording never page faults
+    for (Ring& ring : rings_) {
+        ring.data = std::make_unique_for_overwrite<uint8_t[]>(capacity_);
+        std::memset(ring.data.get(), 0, capacity_);
+    }
+}
+
+FlightRecorder::~FlightRecorder() {
+    flush();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void FlightRecorder::addTrigger(std::string reason, uint64_t threshold, std::function<uint64_t()> counter) {
+    if (threshold == 0 || !counter) return;
+    uint64_t last = counter();
+    triggers_.push_back({std::move(reason), threshold, std::move(counter), last});
+}
+
+void FlightRecorder::setCheckInterval(unsigned int interval_ms) {
+    check_interval_ = std::chrono::milliseconds(interval_ms > 0 ? interval_ms : DEFAULT_CHECK_INTERVAL_MS);
+}
+
+void FlightRecorder::record(const uint8_t* data, size_t len) {
+    if (len == 0) return;
+
+    Clock::time_point now = Clock::now();
+    Ring& ring = rings_[active_];
+
+    if (index_count_ == 0 ||
+        now - index_[(index_head_ + index_count_ - 1) % INDEX_SIZE].time >= std::chrono::milliseconds(INDEX_INTERVAL_MS)) {
+        if (index_count_ == INDEX_SIZE) {
+            index_head_ = (index_head_ + 1) % INDEX_SIZE;
+            index_count_--;
+        }
+        index_[(index_head_ + index_count_) % INDEX_SIZE] = {ring.written, now};
+        index_count_++;
+    }
+
+    // Only the newest capacity_ bytes can be kept
+    if (len > capacity_) {
+        ring.written += len - capacity_;
+        data += len - capacity_;
+        len = capacity_;
+    }
+    size_t pos = static_cast<size_t>(ring.written % capacity_);
+    size_t first = std::min(len, capacity_ - pos);
+    std::memcpy(ring.data.get() + pos, data, first);
+    if (first < len) {
+        std::memcpy(ring.data.get(), data + first, len - first);
+    }
+    ring.written += len;
+
+    if (pending_) {
+        if (now - trigger_time_ >= post_trigger_) freeze();
+    } else if (!triggers_.empty() && now >= next_check_) {
+        checkTriggers(now);
+    }
+}
+
+void FlightRecorder::checkTriggers(Clock::time_point now) {
+    next_check_ = now + check_interval_;
+
+    const std::string* fired = nullptr;
+    for (Trigger& t : triggers_) {
+        uint64_t value = t.counter();
+        // Counters may restart (e.g. a decoder was recreated)
+        if (value >= t.last && value - t.last >= t.threshold && !fired) {
+            fired = &t.reason;
+        }
+        t.last = value;
+    }
+    if (fired) {
+        trigger(*fired);
+    }
+}
+
+bool FlightRecorder::trigger(const std::string& reason) {
+    trigger_count_++;
+    if (isBusy()) {
+        skipped_trigger_count_++;
+        return false;
+    }
+
+    pending_ = true;
+    pending_reason_ = reason;
+    pending_number_ = trigger_count_;
+    trigger_time_ = Clock::now();
+    if (post_trigger_.count() == 0) {
+        freeze();
+    }
+    return true;
+}
+
+void FlightRecorder::flush() {
+    if (pending_) freeze();
+}
+
+void FlightRecorder::freeze() {
+    pending_ = false;
+
+    // Window: duration_ before the trigger, from an indexed record() boundary
+    Ring& ring = rings_[active_];
+    uint64_t end = ring.written;
+    uint64_t min_pos = end > capacity_ ? end - capacity_ : 0;
+    Clock::time_point start_time = trigger_time_ - duration_;
+    uint64_t start = end;
+    for (size_t i = 0; i < index_count_; i++) {
+        const IndexEntry& e = index_[(index_head_ + i) % INDEX_SIZE];
+        if (e.pos >= min_pos && e.time >= start_time) {
+            start = e.pos;
+            break;
+        }
+    }
+    if (start == end) return;
+
+    char stamp[32];
+    std::time_t t = std::time(nullptr);
+    struct tm tm{};
+    localtime_r(&t, &tm);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+    std::string path = directory_ + "/" + prefix_ + "-" + stamp + "-" + std::to_string(pending_number_) +
+                       "-" + fileNamePart(pending_reason_) + suffix_;
+
+    // The writer owns this ring until it is done; recording continues in the other
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    writing_.store(true);
+    writer_ = std::thread(&FlightRecorder::write, this, &ring, start, end, std::move(path));
+
+    active_ ^= 1;
+    rings_[active_].written = 0;
+    index_head_ = 0;
+    index_count_ = 0;
+}
+
+void FlightRecorder::write(const Ring* ring, uint64_t start, uint64_t end, std::string path) {
+    applyThreadConfig(ThreadRole::Recorder);
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    bool ok = fd >= 0;
+    if (ok) {
+        size_t pos = static_cast<size_t>(start % capacity_);
+        size_t len = static_cast<size_t>(end - start);
+        size_t first = std::min(len, capacity_ - pos);
+        ok = writeAll(fd, ring->data.get() + pos, first) &&
+             writeAll(fd, ring->data.get(), len - first);
+    }
+    if (!ok) {
+        error_.store(errno);
+    }
+    if (fd >= 0 && close(fd) < 0 && ok) {
+        error_.store(errno);
+        ok = false;
+    }
+
+    if (ok) {
+        {
+            std::lock_guard<std::mutex> lock(path_mutex_);
+            last_path_ = std::move(path);
+        }
+        dump_count_.fetch_add(1);
+    }
+    writing_.store(false);
+}
+
+std::string FlightRecorder::getLastDumpPath() const {
+    std::lock_guard<std::mutex> lock(path_mutex_);
+    return last_path_;
+}
+
+} // namespace dvbdab
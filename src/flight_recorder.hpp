@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dvbdab {
+
+// Always-on recorder of raw input, dumped to disk around anomalies
+//
+// Input is copied into a preallocated ring (one memcpy per record(), two at
+// the wrap). A trigger - from trigger() or from a counter crossing its
+// threshold - keeps recording for post_trigger_ms, then hands the ring to a
+// writer thread and continues in a second, equally sized ring. The dump
+// covers duration_ms before the trigger and post_trigger_ms after it, within
+// max_bytes, starting at a record() boundary so TS packets stay aligned.
+// While a dump is pending or being written further triggers are skipped.
+//
+// Not thread safe apart from the writer: record() and trigger() must be
+// called from the same thread (or under the caller's lock).
+class FlightRecorder {
+public:
+    static constexpr unsigned int DEFAULT_DURATION_MS = 5000;
+    static constexpr unsigned int DEFAULT_POST_TRIGGER_MS = 1000;
+    static constexpr size_t DEFAULT_MAX_BYTES = 32 * 1024 * 1024;  // Per ring (two are allocated)
+    static constexpr unsigned int DEFAULT_CHECK_INTERVAL_MS = 1000;
+    static constexpr unsigned int INDEX_INTERVAL_MS = 10;    // Time resolution of the window start
+    static constexpr size_t INDEX_SIZE = 4096;               // Index entries (40 s at 10 ms)
+
+    // Dumps are written to <directory>/<prefix>-<YYYYmmdd-HHMMSS>-<n>-<reason><suffix>
+    FlightRecorder(std::string directory, std::string prefix = "dvbdab", std::string suffix = ".ts",
+                   unsigned int duration_ms = DEFAULT_DURATION_MS,
+                   unsigned int post_trigger_ms = DEFAULT_POST_TRIGGER_MS,
+                   size_t max_bytes = DEFAULT_MAX_BYTES);
+    ~FlightRecorder();  // Writes a pending dump and waits for the writer
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // Dump when counter() grows by at least threshold between two checks
+    // (every check_interval_ms, evaluated in record()). reason names the dump.
+    void addTrigger(std::string reason, uint64_t threshold, std::function<uint64_t()> counter);
+    void setCheckInterval(unsigned int interval_ms);
+
+    // Append raw input
+    void record(const uint8_t* data, size_t len);
+
+    // Request a dump. Returns false if one is already pending or being written.
+    bool trigger(const std::string& reason);
+
+    // Hand a pending dump to the writer now instead of after post_trigger_ms
+    void flush();
+
+    bool isBusy() const { return pending_ || writing_.load(); }
+
+    // Statistics
+    size_t getTriggerCount() const { return trigger_count_; }
+    size_t getSkippedTriggerCount() const { return skipped_trigger_count_; }
+    size_t getDumpCount() const { return dump_count_.load(); }
+    int getError() const { return error_.load(); }  // errno of the last failed dump, 0 if none
+    std::string getLastDumpPath() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Ring {
+        std::unique_ptr<uint8_t[]> data;
+        uint64_t written{0};  // Bytes written since the ring became active
+    };
+
+    struct IndexEntry {
+        uint64_t pos;
+        Clock::time_point time;
+    };
+
+    struct Trigger {
+        std::string reason;
+        uint64_t threshold;
+        std::function<uint64_t()> counter;
+        uint64_t last;
+    };
+
+    void checkTriggers(Clock::time_point now);
+    void freeze();
+    void write(const Ring* ring, uint64_t start, uint64_t end, std::string path);
+
+    std::string directory_;
+    std::string prefix_;
+    std::string suffix_;
+    std::chrono::milliseconds duration_;
+    std::chrono::milliseconds post_trigger_;
+    size_t capacity_;
+
+    Ring rings_[2];
+    int active_{0};
+
+    // Positions of record() calls, at most one per INDEX_INTERVAL_MS
+    std::vector<IndexEntry> index_;
+    size_t index_head_{0};   // Oldest entry
+    size_t index_count_{0};
+
+    std::vector<Trigger> triggers_;
+    std::chrono::milliseconds check_interval_{DEFAULT_CHECK_INTERVAL_MS};
+    Clock::time_point next_check_{};
+
+    // Pending dump
+    bool pending_{false};
+    std::string pending_reason_;
+    size_t pending_number_{0};  // Trigger count at the trigger, for the file name
+    Clock::time_point trigger_time_{};
+
+    std::thread writer_;
+    std::atomic<bool> writing_{false};
+
+    size_t trigger_count_{0};
+    size_t skipped_trigger_count_{0};
+    std::atomic<size_t> dump_count_{0};
+    std::atomic<int> error_{0};
+    mutable std::mutex path_mutex_;
+    std::string last_path_;
+};
+
+} // namespace dvbdab
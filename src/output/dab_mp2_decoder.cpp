@@ -2,6 +2,7 @@
 // DAB audio uses raw MP2 frames without any superframe wrapper
 
 #include "dab_mp2_decoder.hpp"
+#include <algorithm>
 #include <cstring>
 #include <cstdio>
 
@@ -73,10 +74,17 @@ DabMp2Decoder::DabMp2Decoder(int bitrate)
 void DabMp2Decoder::reset() {
     synced_ = false;
     sync_offset_ = 0;
+    aligned_ = false;
+    aligned_size_ = 0;
     buffer_.clear();
     frame_count_ = 0;
     mp2_frame_count_ = 0;
     sync_errors_ = 0;
+    crc_errors_ = 0;
+    aligned_frame_count_ = 0;
+    mp2_bytes_ = 0;
+    pad_bytes_ = 0;
+    xpad_len_ = 0;
 }
 
 bool DabMp2Decoder::isSync(const uint8_t* data) {
@@ -133,8 +141,151 @@ int DabMp2Decoder::parseHeader(const uint8_t* header) {
     return frame_size;
 }
 
+// MPEG audio CRC-16 (polynomial 0x8005) over the low nbits of value
+static inline void crcUpdate(uint16_t& crc, uint32_t value, int nbits) {
+    for (int i = nbits - 1; i >= 0; i--) {
+        bool bit = (((value >> i) & 1) != 0) != ((crc & 0x8000) != 0);
+        crc = static_cast<uint16_t>(crc << 1);
+        if (bit) crc ^= 0x8005;
+    }
+}
+
+void DabMp2Decoder::tryAlign(const uint8_t* data, size_t len) {
+    if (len < 4 || parseHeader(data) != static_cast<int>(len)) return;
+
+    // Only 48 kHz MPEG-1 Layer II maps one frame to one 24 ms subchannel frame
+    if (params_.version != 1 || params_.layer != 2 || params_.sample_rate != 48000) return;
+
+    aligned_ = true;
+    aligned_size_ = len;
+    aligned_header1_ = data[1];
+    aligned_header2_ = data[2] & 0xFE;
+#ifdef DAB_MP2_DEBUG
+    fprintf(stderr, "[MP2] Aligned fast path: %zu bytes per frame\n", len);
+#endif
+}
+
+bool DabMp2Decoder::checkLayer2Crc(const uint8_t* frame, size_t len) const {
+    int mode = (frame[3] >> 6) & 3;
+    int mode_ext = (frame[3] >> 4) & 3;
+    int nch = (mode == 3) ? 1 : 2;
+
+    // Bit allocation table (ISO 11172-3 B.2a / B.2c, 48 kHz)
+    bool low_rate = params_.bitrate / nch < 56;
+    int sblimit = low_rate ? 8 : 27;
+    int bound = (mode == 1) ? (mode_ext + 1) * 4 : sblimit;
+    if (bound > sblimit) bound = sblimit;
+
+    // Header CRC area is at most 27 * 2 * (4 + 2) bits
+    if (len < 6 + 41) return false;
+
+    const uint8_t* p = frame + 6;
+    size_t bit_pos = 0;
+    auto read = [&](int nbits) {
+        uint32_t v = 0;
+        for (int i = 0; i < nbits; i++, bit_pos++) {
+            v = (v << 1) | ((p[bit_pos >> 3] >> (7 - (bit_pos & 7))) & 1);
+        }
+        return v;
+    };
+    auto nbal = [low_rate](int sb) {
+        if (low_rate) return sb < 2 ? 4 : 3;
+        return sb < 11 ? 4 : (sb < 23 ? 3 : 2);
+    };
+
+    uint16_t crc = 0xFFFF;
+    crcUpdate(crc, (frame[2] << 8) | frame[3], 16);
+
+    uint8_t allocation[2][32];
+    for (int sb = 0; sb < sblimit; sb++) {
+        int bits = nbal(sb);
+        for (int ch = 0; ch < nch; ch++) {
+            if (sb >= bound && ch > 0) {
+                allocation[ch][sb] = allocation[0][sb];  // Joint stereo: shared
+                continue;
+            }
+            uint32_t a = read(bits);
+            crcUpdate(crc, a, bits);
+            allocation[ch][sb] = static_cast<uint8_t>(a);
+        }
+    }
+    for (int sb = 0; sb < sblimit; sb++) {
+        for (int ch = 0; ch < nch; ch++) {
+            if (allocation[ch][sb]) {
+                crcUpdate(crc, read(2), 2);
+            }
+        }
+    }
+
+    return crc == ((frame[4] << 8) | frame[5]);
+}
+
+void DabMp2Decoder::countFrame(const uint8_t* frame, size_t len) {
+    mp2_bytes_ += len;
+
+    // Frame end (ETSI EN 300 401 7.4): ... X-PAD, ScF-CRC, F-PAD (2 bytes).
+    // ScF-CRC is 4 bytes at 48 kHz from 56 kbit/s per channel, else 2.
+    int nch = params_.channel_mode == 3 ? 1 : 2;
+    size_t scf_crc_len = (params_.sample_rate == 48000 && params_.bitrate / nch >= 56) ? 4 : 2;
+    if (len < 2 + scf_crc_len) return;
+
+    const uint8_t* fpad = frame + len - 2;
+    size_t xpad_end = len - 2 - scf_crc_len;
+    size_t pad = 2;
+    switch ((fpad[0] >> 4) & 0x03) {
+    case 1:  // Short X-PAD
+        pad += 4;
+        break;
+    case 2:  // Variable X-PAD: CI list (read backwards) gives the subfield lengths
+        if (fpad[1] & 0x02) {
+            static const uint8_t lengths[8] = {4, 6, 8, 12, 16, 24, 32, 48};
+            size_t xpad = 0;
+            for (size_t i = 0; i < 4 && i < xpad_end; i++) {
+                uint8_t ci = frame[xpad_end - 1 - i];
+                xpad++;
+                if ((ci & 0x1F) == 0) break;  // End marker
+                xpad += lengths[ci >> 5];
+            }
+            xpad_len_ = xpad;
+        }
+        pad += std::min(xpad_len_, xpad_end);
+        break;
+    default:
+        break;
+    }
+    pad_bytes_ += pad;
+}
+
 int DabMp2Decoder::feedFrame(const uint8_t* data, size_t len) {
     frame_count_++;
+
+    // Aligned fast path: the subchannel frame is the MP2 frame. Entered when
+    // the buffered path consumed the previous subchannel frame exactly.
+    if (!aligned_ && mp2_frame_count_ > 0 && buffer_.empty()) {
+        tryAlign(data, len);
+    }
+    if (aligned_) {
+        if (len == aligned_size_ && data[0] == 0xFF && data[1] == aligned_header1_ &&
+            (data[2] & 0xFE) == aligned_header2_) {
+            // Protection bit is part of aligned_header1_ (0 = CRC present)
+            if (!(aligned_header1_ & 1) && !checkLayer2Crc(data, len)) {
+                crc_errors_++;
+                return 0;
+            }
+            if (callback_) {
+                callback_(data, len);
+            }
+            countFrame(data, len);
+            mp2_frame_count_++;
+            aligned_frame_count_++;
+            return 1;
+        }
+        // Frame size/header changed or misaligned - resync on the buffered path
+        aligned_ = false;
+        synced_ = false;
+        sync_errors_++;
+    }
+
     int frames_extracted = 0;
 
     // Append to buffer
@@ -192,6 +343,7 @@ int DabMp2Decoder::feedFrame(const uint8_t* data, size_t len) {
         if (callback_) {
             callback_(buffer_.data() + pos, frame_size);
         }
+        countFrame(buffer_.data() + pos, frame_size);
         mp2_frame_count_++;
         frames_extracted++;
 
@@ -1,6 +1,13 @@
 #pragma once
 // DAB MP2 Decoder - extracts MPEG-1 Layer II frames from DAB subchannel data
 // DAB audio (non-DAB+) uses raw MP2 frames without any wrapper
+//
+// At 48 kHz an MP2 frame is exactly one 24 ms subchannel frame. Once a
+// subchannel frame was consumed exactly and the next one starts with a header
+// whose frame size equals the subchannel frame size, the decoder switches to an aligned
+// fast path: each subchannel frame is checked (fixed header bytes + header
+// CRC) and passed to the callback in place, without buffering or sync search.
+// Any mismatch falls back to the buffered path (also used for 24 kHz).
 
 #include <cstdint>
 #include <cstddef>
@@ -47,6 +54,11 @@ public:
     size_t getFrameCount() const { return frame_count_; }
     size_t getMp2FrameCount() const { return mp2_frame_count_; }
     size_t getSyncErrors() const { return sync_errors_; }
+    size_t getCrcErrors() const { return crc_errors_; }          // Frames dropped on header CRC (aligned path)
+    size_t getAlignedFrameCount() const { return aligned_frame_count_; }
+    uint64_t getMp2Bytes() const { return mp2_bytes_; }   // Emitted MP2 frames, PAD included
+    uint64_t getPadBytes() const { return pad_bytes_; }   // F-PAD and X-PAD within emitted frames
+    bool isAligned() const { return aligned_; }
 
 private:
     // Parse MP2 header and return frame size, or 0 if invalid
@@ -55,11 +67,26 @@ private:
     // Check if bytes form valid MP2 sync
     static bool isSync(const uint8_t* data);
 
+    // Enter the aligned fast path if this subchannel frame is one MP2 frame
+    void tryAlign(const uint8_t* data, size_t len);
+
+    // Layer II CRC over header, bit allocation and scfsi (48 kHz MPEG-1)
+    bool checkLayer2Crc(const uint8_t* frame, size_t len) const;
+
+    // Count an emitted MP2 frame and the PAD at its end
+    void countFrame(const uint8_t* frame, size_t len);
+
     int bitrate_;
     size_t frame_size_;           // Expected subchannel frame size
     bool synced_ = false;
     size_t sync_offset_ = 0;      // Offset within accumulated data to next frame
 
+    // Aligned fast path state
+    bool aligned_ = false;
+    size_t aligned_size_ = 0;     // MP2 frame size == subchannel frame size
+    uint8_t aligned_header1_ = 0; // Version/layer/protection byte
+    uint8_t aligned_header2_ = 0; // Bitrate/sample rate/padding (private bit masked)
+
     // Buffer for incomplete frames
     std::vector<uint8_t> buffer_;
 
@@ -70,6 +97,11 @@ private:
     size_t frame_count_ = 0;
     size_t mp2_frame_count_ = 0;
     size_t sync_errors_ = 0;
+    size_t crc_errors_ = 0;
+    size_t aligned_frame_count_ = 0;
+    uint64_t mp2_bytes_ = 0;
+    uint64_t pad_bytes_ = 0;
+    size_t xpad_len_ = 0;         // Last variable X-PAD length (continued without CI list)
 };
 
 } // namespace dvbdab
@@ -116,6 +116,12 @@ void DabPlusDecoder::setDLPlusCallback(DLPlusUpdateCallback cb) {
     }
 }
 
+void DabPlusDecoder::setMotCallback(MotUpdateCallback cb) {
+    if (pad_decoder_) {
+        pad_decoder_->setMotCallback(std::move(cb));
+    }
+}
+
 const std::string& DabPlusDecoder::getDLSText() const {
     static const std::string empty;
     return pad_decoder_ ? pad_decoder_->getDLSText() : empty;
@@ -129,6 +135,11 @@ void DabPlusDecoder::reset() {
     superframe_count_ = 0;
     au_count_ = 0;
     crc_errors_ = 0;
+    sync_loss_count_ = 0;
+    firecode_errors_ = 0;
+    valid_au_count_ = 0;
+    au_bytes_ = 0;
+    pad_bytes_ = 0;
     if (pad_decoder_) {
         pad_decoder_->reset();
     }
@@ -157,6 +168,18 @@ bool DabPlusDecoder::checkAuCrc(const uint8_t* buf, size_t len) {
     return crc == 0;
 }
 
+// Length of the DSE carrying the PAD at the start of an AU (0 if none),
+// ETSI TS 102 563: element_id 4, count, optional esc_count
+static size_t dseLength(const uint8_t* au, size_t len) {
+    if (len < 2 || (au[0] >> 5) != 4) return 0;
+    size_t n = 2 + au[1];
+    if (au[1] == 255) {
+        if (len < 3) return 0;
+        n += 1 + au[2];
+    }
+    return n <= len ? n : 0;
+}
+
 void DabPlusDecoder::buildAdtsHeader(uint8_t* header, size_t au_len) {
     // Sample rate index: 32k=0x5, 16k=0x8, 48k=0x3, 24k=0x6
     static const uint8_t sample_rate_table[4] = {0x5, 0x8, 0x3, 0x6};
@@ -224,10 +247,14 @@ bool DabPlusDecoder::feedFrame(const uint8_t* data, size_t len) {
             // Keep looking for sync
             return false;
         }
-    } else if (frame_index_ == 0 && !fire_ok && frame_count_ > 10) {
-        // Lost sync - resync
-        synced_ = false;
-        return false;
+    } else if (frame_index_ == 0 && !fire_ok) {
+        firecode_errors_++;
+        if (frame_count_ > 10) {
+            // Lost sync - resync
+            synced_ = false;
+            sync_loss_count_++;
+            return false;
+        }
     }
 
     // Accumulate frame
@@ -386,6 +413,9 @@ void DabPlusDecoder::processSuperframe() {
 
         // AU data length excluding CRC
         size_t au_data_len = au_size[i] - 2;
+        valid_au_count_++;
+        au_bytes_ += au_data_len;
+        pad_bytes_ += dseLength(sf + au_start[i], au_data_len);
 
         // Extract PAD from raw AU using FDK-AAC (like dablin)
         // FDK-AAC with TT_MP4_RAW expects raw AU data, not ADTS
@@ -393,6 +423,14 @@ void DabPlusDecoder::processSuperframe() {
             pad_decoder_->processPad(sf + au_start[i], au_data_len);
         }
 
+        // Emit ADTS header + AU in place (no copy)
+        if (frame_callback_ && au_data_len > 0) {
+            buildAdtsHeader(adts_header_.data(), au_data_len);
+            frame_callback_(adts_header_.data(), adts_header_.size(), sf + au_start[i], au_data_len);
+            au_count_++;
+            continue;
+        }
+
         // Build ADTS frame and emit
         if (callback_ && au_data_len > 0 && au_data_len < output_buf_.size() - 7) {
             buildAdtsHeader(output_buf_.data(), au_data_len);
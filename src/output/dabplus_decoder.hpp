@@ -18,8 +18,14 @@ class PadDecoder;
 // Callback for decoded AAC frames with ADTS headers
 using AacFrameCallback = std::function<void(const uint8_t* data, size_t len)>;
 
-// Forward declare DL Plus types
+// Scatter-gather variant: ADTS header and AU passed separately. The AU points
+// into the decoder's superframe buffer and is only valid during the call.
+using AdtsFrameCallback = std::function<void(const uint8_t* header, size_t header_len,
+                                             const uint8_t* au, size_t au_len)>;
+
+// Forward declare DL Plus / MOT types
 struct DLPlusTag;
+struct MotObject;
 
 // Callback for DLS text updates
 using DLSUpdateCallback = std::function<void(const std::string& text)>;
@@ -27,6 +33,9 @@ using DLSUpdateCallback = std::function<void(const std::string& text)>;
 // Callback for DL Plus updates (text + parsed tags)
 using DLPlusUpdateCallback = std::function<void(const std::string& text, const std::vector<DLPlusTag>& tags)>;
 
+// Callback for MOT objects from X-PAD (slideshow images)
+using MotUpdateCallback = std::function<void(const MotObject& object)>;
+
 // DAB+ stream parameters from superframe header
 struct DabPlusParams {
     bool dac_rate;          // 0=32kHz, 1=48kHz
@@ -45,12 +54,19 @@ public:
     // Set callback for decoded AAC frames
     void setCallback(AacFrameCallback cb) { callback_ = std::move(cb); }
 
+    // Set scatter-gather callback (takes precedence over setCallback).
+    // Avoids copying each AU into a contiguous ADTS frame.
+    void setFrameCallback(AdtsFrameCallback cb) { frame_callback_ = std::move(cb); }
+
     // Set callback for DLS text updates
     void setDLSCallback(DLSUpdateCallback cb);
 
     // Set callback for DL Plus updates (includes parsed artist/title tags)
     void setDLPlusCallback(DLPlusUpdateCallback cb);
 
+    // Set callback for MOT objects (slideshow); MOT decoding only runs while set
+    void setMotCallback(MotUpdateCallback cb);
+
     // Get current DLS text (if any)
     const std::string& getDLSText() const;
 
@@ -69,6 +85,11 @@ public:
     size_t getSuperframeCount() const { return superframe_count_; }
     size_t getAuCount() const { return au_count_; }
     size_t getCrcErrors() const { return crc_errors_; }
+    size_t getSyncLossCount() const { return sync_loss_count_; }  // Superframe sync lost after lock
+    size_t getFireCodeErrors() const { return firecode_errors_; }  // Superframe starts failing FireCode while synced
+    size_t getValidAuCount() const { return valid_au_count_; }     // AUs passing the CRC (emitted or not)
+    uint64_t getAuBytes() const { return au_bytes_; }               // Valid AU payload (without CRC), PAD included
+    uint64_t getPadBytes() const { return pad_bytes_; }             // PAD (DSE) within valid AUs
 
 private:
     // FireCode CRC check (bytes 0-1 vs bytes 2-10)
@@ -93,6 +114,7 @@ private:
 
     DabPlusParams params_{};
     AacFrameCallback callback_;
+    AdtsFrameCallback frame_callback_;
     DLSUpdateCallback dls_callback_;
     DLPlusUpdateCallback dlplus_callback_;
 
@@ -104,9 +126,15 @@ private:
     size_t superframe_count_ = 0;
     size_t au_count_ = 0;
     size_t crc_errors_ = 0;
+    size_t sync_loss_count_ = 0;
+    size_t firecode_errors_ = 0;
+    size_t valid_au_count_ = 0;
+    uint64_t au_bytes_ = 0;
+    uint64_t pad_bytes_ = 0;
 
-    // Output buffer for ADTS frame
+    // Output buffer for ADTS frame (contiguous callback only)
     std::array<uint8_t, 2048> output_buf_;
+    std::array<uint8_t, 7> adts_header_;
 };
 
 } // namespace dvbdab
@@ -286,6 +286,12 @@ bool FfmpegTsMuxer::initialize() {
 }
 
 void FfmpegTsMuxer::feedAudioFrame(uint8_t subchannel_id, const uint8_t* data, size_t len, int64_t pts) {
+    feedAudioFrame(subchannel_id, data, len, nullptr, 0, pts);
+}
+
+void FfmpegTsMuxer::feedAudioFrame(uint8_t subchannel_id, const uint8_t* header, size_t header_len,
+                                   const uint8_t* payload, size_t payload_len, int64_t pts) {
+    size_t len = header_len + payload_len;
     if (!initialized_ || len == 0) {
         return;
     }
@@ -313,6 +319,17 @@ void FfmpegTsMuxer::feedAudioFrame(uint8_t subchannel_id, const uint8_t* data, s
 
     AVStream* stream = fmt_ctx_->streams[stream_idx];
 
+    // Gather pieces into the reused packet buffer (FFmpeg needs padding after data)
+    if (frame_buf_.size() < len + AV_INPUT_BUFFER_PADDING_SIZE) {
+        frame_buf_.resize(len + AV_INPUT_BUFFER_PADDING_SIZE);
+    }
+    memcpy(frame_buf_.data(), header, header_len);
+    if (payload_len > 0) {
+        memcpy(frame_buf_.data() + header_len, payload, payload_len);
+    }
+    memset(frame_buf_.data() + len, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+    const uint8_t* data = frame_buf_.data();
+
     // For ADTS, detect sample rate from first frame and update stream if needed
     int sample_rate = 48000;
     if (len >= 7 && data[0] == 0xFF && (data[1] & 0xF0) == 0xF0) {
@@ -322,18 +339,15 @@ void FfmpegTsMuxer::feedAudioFrame(uint8_t subchannel_id, const uint8_t* data, s
         }
     }
 
-    // Create packet
-    AVPacket* pkt = av_packet_alloc();
-    if (!pkt) {
-        return;
-    }
-
-    // Allocate and copy data
-    if (av_new_packet(pkt, static_cast<int>(len)) < 0) {
-        av_packet_free(&pkt);
-        return;
+    if (!frame_pkt_) {
+        frame_pkt_ = av_packet_alloc();
+        if (!frame_pkt_) {
+            return;
+        }
     }
-    memcpy(pkt->data, data, len);
+    AVPacket* pkt = frame_pkt_;
+    pkt->data = frame_buf_.data();
+    pkt->size = static_cast<int>(len);
 
     pkt->stream_index = stream_idx;
     pkt->pts = pts;
@@ -351,7 +365,7 @@ void FfmpegTsMuxer::feedAudioFrame(uint8_t subchannel_id, const uint8_t* data, s
         }
     }
 
-    av_packet_free(&pkt);
+    av_packet_unref(pkt);  // Reset fields for reuse (data is ours)
 }
 
 void FfmpegTsMuxer::updateMetadata(uint8_t subchannel_id, const FfmpegMetadata& metadata) {
@@ -1099,6 +1113,10 @@ void FfmpegTsMuxer::finalize() {
         fmt_ctx_ = nullptr;
     }
 
+    if (frame_pkt_) {
+        av_packet_free(&frame_pkt_);
+    }
+
     if (avio_ctx_) {
         avio_context_free(&avio_ctx_);
         avio_ctx_ = nullptr;
@@ -61,6 +61,11 @@ public:
     // Data should be complete ADTS frame(s)
     void feedAudioFrame(uint8_t subchannel_id, const uint8_t* data, size_t len, int64_t pts);
 
+    // Feed audio frame given as two pieces (e.g. ADTS header + AU), which are
+    // gathered directly into the reused packet buffer
+    void feedAudioFrame(uint8_t subchannel_id, const uint8_t* header, size_t header_len,
+                        const uint8_t* payload, size_t payload_len, int64_t pts);
+
     // Update metadata for a service (from DL Plus)
     // This will inject timed ID3 metadata into the TS stream
     void updateMetadata(uint8_t subchannel_id, const FfmpegMetadata& metadata);
@@ -130,6 +135,10 @@ private:
     AVIOContext* avio_ctx_{nullptr};
     uint8_t* avio_buffer_{nullptr};
 
+    // Reused audio packet (not ref-counted - av_write_frame does not take ownership)
+    AVPacket* frame_pkt_{nullptr};
+    std::vector<uint8_t> frame_buf_;
+
     uint16_t tsid_{1};
     std::string ensemble_name_{"DAB Ensemble"};
 
@@ -0,0 +1,396 @@
+// MOT (Multimedia Object Transfer) decoder
+// References: ETSI EN 301 234, ETSI EN 300 401 5.3, ETSI TS 101 499
+
+#include "mot_decoder.hpp"
+#include <cstring>
+
+namespace dvbdab {
+
+// MSC data group / packet CRC (CRC-16 CCITT, stored inverted)
+static bool checkCrc(const uint8_t* data, size_t len) {
+    if (len < 2) return false;
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len - 2; i++) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    crc ^= 0xFFFF;
+    return crc == ((data[len - 2] << 8) | data[len - 1]);
+}
+
+static uint64_t fnv1a(const uint8_t* data, size_t len) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// =============================================================================
+// MotDecoder
+// =============================================================================
+
+void MotDecoder::Segments::clear() {
+    std::vector<uint8_t>().swap(data);  // Release memory, counted against the limit
+    received.clear();
+    segment_size = 0;
+    received_count = 0;
+    last_segment = -1;
+    total = 0;
+}
+
+MotDecoder::MotDecoder(size_t memory_limit)
+    : memory_limit_(memory_limit)
+{
+}
+
+void MotDecoder::reset() {
+    for (auto& p : pending_) {
+        if (p.active) dropPending(p);
+    }
+    history_count_ = 0;
+    history_pos_ = 0;
+}
+
+MotDecoder::Pending* MotDecoder::findPending(uint16_t tid) {
+    for (auto& p : pending_) {
+        if (p.active && p.transport_id == tid) return &p;
+    }
+    return nullptr;
+}
+
+MotDecoder::Pending* MotDecoder::allocatePending(uint16_t tid) {
+    Pending* slot = nullptr;
+    for (auto& p : pending_) {
+        if (!p.active) {
+            slot = &p;
+            break;
+        }
+        if (!slot || p.last_update < slot->last_update) {
+            slot = &p;
+        }
+    }
+    if (slot->active) {
+        dropped_count_++;  // All slots busy - evict least recently updated
+        dropPending(*slot);
+    }
+    slot->active = true;
+    slot->transport_id = tid;
+    slot->last_update = ++update_counter_;
+    return slot;
+}
+
+void MotDecoder::dropPending(Pending& p) {
+    memory_used_ -= p.header.data.size() + p.body.data.size();
+    p.header.clear();
+    p.body.clear();
+    p.active = false;
+}
+
+const MotDecoder::Completed* MotDecoder::findCompleted(uint16_t tid) const {
+    for (size_t i = 0; i < history_count_; i++) {
+        if (history_[i].transport_id == tid) return &history_[i];
+    }
+    return nullptr;
+}
+
+void MotDecoder::feedDataGroup(const uint8_t* dg, size_t len) {
+    if (len < 2) return;
+
+    // MSC data group header (EN 300 401 5.3.3.1)
+    bool ext_flag = (dg[0] & 0x80) != 0;
+    bool crc_flag = (dg[0] & 0x40) != 0;
+    bool segment_flag = (dg[0] & 0x20) != 0;
+    bool user_access_flag = (dg[0] & 0x10) != 0;
+    uint8_t dg_type = dg[0] & 0x0F;
+
+    if (crc_flag) {
+        if (!checkCrc(dg, len)) {
+            crc_error_count_++;
+            return;
+        }
+        len -= 2;
+    }
+
+    // Header mode only: 3 = MOT header, 4 = MOT body
+    if (dg_type != 3 && dg_type != 4) return;
+    if (!segment_flag || !user_access_flag) return;
+
+    size_t pos = ext_flag ? 4 : 2;
+
+    // Session header: segment field
+    if (pos + 2 > len) return;
+    bool last = (dg[pos] & 0x80) != 0;
+    int segment_number = ((dg[pos] & 0x7F) << 8) | dg[pos + 1];
+    pos += 2;
+
+    // Session header: user access field (transport ID required)
+    if (pos + 1 > len) return;
+    bool tid_flag = (dg[pos] & 0x10) != 0;
+    size_t ua_len = dg[pos] & 0x0F;
+    pos++;
+    if (!tid_flag || ua_len < 2 || pos + ua_len > len) return;
+    uint16_t tid = (dg[pos] << 8) | dg[pos + 1];
+    pos += ua_len;
+
+    // MOT segmentation header: repetition count (3) + segment size (13)
+    if (pos + 2 > len) return;
+    size_t segment_size = ((dg[pos] & 0x1F) << 8) | dg[pos + 1];
+    pos += 2;
+    if (segment_size > len - pos) return;
+    const uint8_t* segment = dg + pos;
+
+    // Carousel repetition of an object already delivered - skip without copying
+    Pending* p = findPending(tid);
+    if (!p) {
+        if (const Completed* done = findCompleted(tid)) {
+            if (dg_type == 4) return;
+            if (segment_number == 0 && last && fnv1a(segment, segment_size) == done->header_hash) return;
+        }
+        p = allocatePending(tid);
+    }
+
+    Segments& seg = (dg_type == 3) ? p->header : p->body;
+    if (addSegment(*p, seg, segment_number, last, segment, segment_size)) {
+        tryComplete(*p);
+    }
+}
+
+bool MotDecoder::addSegment(Pending& p, Segments& seg, int segment_number, bool last,
+                            const uint8_t* data, size_t len) {
+    // All segments except the last have the same size
+    if (!last && seg.segment_size != len) {
+        if (seg.segment_size != 0) {
+            memory_used_ -= seg.data.size();
+            seg.clear();  // Inconsistent - restart this part of the object
+        }
+        seg.segment_size = len;
+    }
+    if (seg.segment_size == 0) {
+        if (segment_number != 0) return false;  // Can't place the last segment yet
+        seg.segment_size = len;
+    }
+
+    size_t index = static_cast<size_t>(segment_number);
+    if (index < seg.received.size() && seg.received[index]) {
+        return false;  // Already have it
+    }
+
+    size_t offset = index * seg.segment_size;
+    size_t end = offset + len;
+    size_t growth = end > seg.data.size() ? end - seg.data.size() : 0;
+
+    // Memory limit: evict other partial objects (least recently updated first)
+    while (memory_used_ + growth > memory_limit_) {
+        Pending* victim = nullptr;
+        for (auto& other : pending_) {
+            if (other.active && &other != &p &&
+                (!victim || other.last_update < victim->last_update)) {
+                victim = &other;
+            }
+        }
+        if (!victim) {
+            dropped_count_++;  // Object alone exceeds the limit
+            dropPending(p);
+            return false;
+        }
+        dropped_count_++;
+        dropPending(*victim);
+    }
+
+    if (growth > 0) {
+        seg.data.resize(end);
+        memory_used_ += growth;
+    }
+    std::memcpy(seg.data.data() + offset, data, len);
+
+    if (seg.received.size() <= index) {
+        seg.received.resize(index + 1, false);
+    }
+    seg.received[index] = true;
+    seg.received_count++;
+
+    if (last) {
+        seg.last_segment = segment_number;
+        seg.total = end;
+    }
+    p.last_update = ++update_counter_;
+    return true;
+}
+
+bool MotDecoder::parseHeader(const Pending& p, MotObject& object) const {
+    const uint8_t* h = p.header.data.data();
+    size_t len = p.header.total;
+    if (len < 7) return false;
+
+    // Header core (EN 301 234 6.1)
+    size_t body_size = (static_cast<size_t>(h[0]) << 20) | (h[1] << 12) | (h[2] << 4) | (h[3] >> 4);
+    size_t header_size = ((h[3] & 0x0F) << 9) | (h[4] << 1) | (h[5] >> 7);
+    object.content_type = (h[5] >> 1) & 0x3F;
+    object.content_subtype = static_cast<uint16_t>(((h[5] & 0x01) << 8) | h[6]);
+    if (body_size != p.body.total) return false;
+
+    // Header extension parameters
+    object.content_name.clear();
+    size_t end = header_size < len ? header_size : len;
+    size_t pos = 7;
+    while (pos < end) {
+        uint8_t pli = h[pos] >> 6;
+        uint8_t param_id = h[pos] & 0x3F;
+        pos++;
+
+        size_t data_len = 0;
+        switch (pli) {
+            case 0: data_len = 0; break;
+            case 1: data_len = 1; break;
+            case 2: data_len = 4; break;
+            case 3:
+                if (pos >= end) return true;
+                if (h[pos] & 0x80) {
+                    if (pos + 1 >= end) return true;
+                    data_len = ((h[pos] & 0x7F) << 8) | h[pos + 1];
+                    pos += 2;
+                } else {
+                    data_len = h[pos] & 0x7F;
+                    pos++;
+                }
+                break;
+        }
+        if (pos + data_len > end) break;
+
+        // ContentName: charset byte + name
+        if (param_id == 0x0C && data_len > 1) {
+            object.content_name.assign(reinterpret_cast<const char*>(h + pos + 1), data_len - 1);
+        }
+        pos += data_len;
+    }
+    return true;
+}
+
+void MotDecoder::tryComplete(Pending& p) {
+    if (!p.header.complete() || !p.body.complete()) return;
+
+    uint16_t tid = p.transport_id;
+    uint64_t header_hash = fnv1a(p.header.data.data(), p.header.total);
+    uint64_t body_hash = fnv1a(p.body.data.data(), p.body.total);
+
+    bool duplicate = false;
+    for (size_t i = 0; i < history_count_; i++) {
+        if (history_[i].body_hash == body_hash) {
+            duplicate = true;  // Same content (possibly under a new transport ID)
+            break;
+        }
+    }
+
+    // Record in history (replacing an entry for the same transport ID)
+    Completed* entry = nullptr;
+    for (size_t i = 0; i < history_count_; i++) {
+        if (history_[i].transport_id == tid) entry = &history_[i];
+    }
+    if (!entry) {
+        entry = &history_[history_pos_];
+        history_pos_ = (history_pos_ + 1) % HISTORY_SIZE;
+        if (history_count_ < HISTORY_SIZE) history_count_++;
+    }
+    entry->transport_id = tid;
+    entry->header_hash = header_hash;
+    entry->body_hash = body_hash;
+
+    if (duplicate) {
+        duplicate_count_++;
+        dropPending(p);
+        return;
+    }
+
+    if (!parseHeader(p, object_)) {
+        dropPending(p);
+        return;
+    }
+
+    object_.transport_id = tid;
+    object_.hash = body_hash;
+    memory_used_ -= p.body.data.size();
+    p.body.data.resize(p.body.total);
+    object_.body.swap(p.body.data);  // Hand over without copying
+    p.body.clear();                  // Previous object's buffer
+    dropPending(p);
+
+    object_count_++;
+    if (callback_) {
+        callback_(object_);
+    }
+}
+
+// =============================================================================
+// MscPacketAssembler
+// =============================================================================
+
+MscPacketAssembler::MscPacketAssembler(uint16_t packet_address, DataGroupCallback callback)
+    : address_(packet_address)
+    , callback_(std::move(callback))
+{
+}
+
+void MscPacketAssembler::reset() {
+    dg_.clear();
+    in_progress_ = false;
+    last_continuity_ = -1;
+}
+
+void MscPacketAssembler::feed(const uint8_t* data, size_t len) {
+    size_t pos = 0;
+    while (pos + 3 <= len) {
+        // Packet header (EN 300 401 5.3.2): length(2) continuity(2) first/last(2) address(10)
+        const uint8_t* pkt = data + pos;
+        size_t packet_size = ((pkt[0] >> 6) + 1) * 24;
+        if (pos + packet_size > len) break;
+        pos += packet_size;
+
+        uint16_t address = ((pkt[0] & 0x03) << 8) | pkt[1];
+        if (address == 0) continue;  // Padding packet
+        if (!checkCrc(pkt, packet_size)) {
+            crc_error_count_++;
+            continue;
+        }
+        if (address != address_) continue;
+        packet_count_++;
+
+        // Command packets carry no data group payload
+        if (pkt[2] & 0x80) continue;
+        size_t useful_len = pkt[2] & 0x7F;
+        if (3 + useful_len > packet_size - 2) continue;
+
+        int continuity = (pkt[0] >> 4) & 0x03;
+        bool first = (pkt[0] & 0x08) != 0;
+        bool last = (pkt[0] & 0x04) != 0;
+
+        if (last_continuity_ >= 0 && continuity != ((last_continuity_ + 1) & 0x03)) {
+            in_progress_ = false;  // Lost a packet - drop current data group
+        }
+        last_continuity_ = continuity;
+
+        if (first) {
+            dg_.clear();
+            in_progress_ = true;
+        }
+        if (!in_progress_) continue;
+
+        if (dg_.size() + useful_len > MAX_DATA_GROUP) {
+            in_progress_ = false;
+            continue;
+        }
+        dg_.insert(dg_.end(), pkt + 3, pkt + 3 + useful_len);
+
+        if (last) {
+            in_progress_ = false;
+            dg_count_++;
+            callback_(dg_.data(), dg_.size());
+        }
+    }
+}
+
+} // namespace dvbdab
@@ -0,0 +1,155 @@
+#pragma once
+// MOT (Multimedia Object Transfer) decoder for slideshow / station logos
+// References: ETSI EN 301 234 (MOT), ETSI EN 300 401 5.3 (data groups,
+// packet mode), ETSI TS 101 499 (SlideShow)
+//
+// Input is complete MSC data groups, either from X-PAD (PadDecoder, app
+// types 12/13) or from a packet-mode subchannel (MscPacketAssembler).
+// Header mode is supported (MOT header + body data groups, types 3/4),
+// which is what SlideShow uses.
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace dvbdab {
+
+// Completed MOT object
+struct MotObject {
+    uint16_t transport_id{0};
+    uint8_t content_type{0};      // 2 = image
+    uint16_t content_subtype{0};  // image: 1 = JPEG, 3 = PNG
+    std::string content_name;     // ContentName parameter (may be empty)
+    std::vector<uint8_t> body;
+    uint64_t hash{0};             // FNV-1a of body (for deduplication)
+};
+
+// Called with a reference to the decoder's object - valid until the next
+// object completes (copy if it is needed longer)
+using MotObjectCallback = std::function<void(const MotObject& object)>;
+
+// Called with one complete MSC data group
+using DataGroupCallback = std::function<void(const uint8_t* dg, size_t len)>;
+
+class MotDecoder {
+public:
+    // Memory for objects being reassembled (headers + bodies). Objects that
+    // do not fit are dropped; the least recently updated one is evicted first.
+    static constexpr size_t DEFAULT_MEMORY_LIMIT = 512 * 1024;
+
+    explicit MotDecoder(size_t memory_limit = DEFAULT_MEMORY_LIMIT);
+
+    void setCallback(MotObjectCallback cb) { callback_ = std::move(cb); }
+
+    // Feed one complete MSC data group (CRC is checked if present)
+    void feedDataGroup(const uint8_t* dg, size_t len);
+
+    // Drop all partial objects and the deduplication history
+    void reset();
+
+    // Last completed (non-duplicate) object, nullptr if none yet
+    const MotObject* getLastObject() const { return object_count_ ? &object_ : nullptr; }
+
+    // Statistics
+    size_t getObjectCount() const { return object_count_; }        // Objects delivered
+    size_t getDuplicateCount() const { return duplicate_count_; }  // Repeated objects suppressed
+    size_t getCrcErrorCount() const { return crc_error_count_; }   // Data groups failing CRC
+    size_t getDroppedCount() const { return dropped_count_; }      // Objects dropped (memory limit)
+    size_t getMemoryUsage() const { return memory_used_; }         // Bytes held by partial objects
+
+private:
+    // Segmented buffer (MOT header or body); all segments but the last have equal size
+    struct Segments {
+        std::vector<uint8_t> data;
+        std::vector<bool> received;
+        size_t segment_size{0};
+        size_t received_count{0};
+        int last_segment{-1};  // -1 = last segment not yet seen
+        size_t total{0};       // Valid once last segment seen
+
+        bool complete() const { return last_segment >= 0 && received_count == static_cast<size_t>(last_segment) + 1; }
+        void clear();
+    };
+
+    struct Pending {
+        bool active{false};
+        uint16_t transport_id{0};
+        Segments header;
+        Segments body;
+        uint64_t last_update{0};
+    };
+
+    struct Completed {
+        uint16_t transport_id{0};
+        uint64_t header_hash{0};
+        uint64_t body_hash{0};
+    };
+
+    static constexpr size_t MAX_PENDING = 4;
+    static constexpr size_t HISTORY_SIZE = 8;
+
+    Pending* findPending(uint16_t tid);
+    Pending* allocatePending(uint16_t tid);
+    void dropPending(Pending& p);
+    bool addSegment(Pending& p, Segments& seg, int segment_number, bool last,
+                    const uint8_t* data, size_t len);
+    void tryComplete(Pending& p);
+    bool parseHeader(const Pending& p, MotObject& object) const;
+    const Completed* findCompleted(uint16_t tid) const;
+
+    MotObjectCallback callback_;
+    size_t memory_limit_;
+    size_t memory_used_{0};
+    uint64_t update_counter_{0};
+
+    std::array<Pending, MAX_PENDING> pending_;
+    std::array<Completed, HISTORY_SIZE> history_{};
+    size_t history_count_{0};
+    size_t history_pos_{0};
+
+    MotObject object_;  // Handed out by reference
+
+    size_t object_count_{0};
+    size_t duplicate_count_{0};
+    size_t crc_error_count_{0};
+    size_t dropped_count_{0};
+};
+
+// Packet-mode data group reassembly for one packet address
+// (ETSI EN 300 401 5.3.2). Feed the subchannel data of each frame; complete
+// data groups are passed to the callback.
+class MscPacketAssembler {
+public:
+    MscPacketAssembler(uint16_t packet_address, DataGroupCallback callback);
+
+    // Feed one frame of packet-mode subchannel data (sequence of packets)
+    void feed(const uint8_t* data, size_t len);
+
+    void reset();
+
+    uint16_t getAddress() const { return address_; }
+
+    // Statistics
+    size_t getPacketCount() const { return packet_count_; }        // Packets for this address
+    size_t getCrcErrorCount() const { return crc_error_count_; }   // Packets failing CRC (any address)
+    size_t getDataGroupCount() const { return dg_count_; }
+
+private:
+    static constexpr size_t MAX_DATA_GROUP = 16384;
+
+    uint16_t address_;
+    DataGroupCallback callback_;
+
+    std::vector<uint8_t> dg_;
+    bool in_progress_{false};
+    int last_continuity_{-1};
+
+    size_t packet_count_{0};
+    size_t crc_error_count_{0};
+    size_t dg_count_{0};
+};
+
+} // namespace dvbdab
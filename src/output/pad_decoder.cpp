@@ -1,5 +1,5 @@
 // PAD (Programme Associated Data) decoder for DAB+
-// References: ETSI EN 300 401, ETSI TS 102 980, ETSI TS 102 563
+// References: ETSI EN 300 401, ETSI TS 102 980, ETSI TS 102 563, ETSI EN 301 234
 //
 // Key insight from dablin: X-PAD bytes in DAB+ DSE are stored in REVERSE order
 // and must be reversed before parsing.
@@ -26,9 +26,9 @@ static const size_t xpad_len_table[8] = {4, 6, 8, 12, 16, 24, 32, 48};
 // EBU Latin (charset 0) to UTF-8 conversion table
 // Based on ETSI TS 101 756 Annex C / ETSI EN 300 706 Table 36
 // Complete EBU Latin character set for DAB
-static std::string ebuLatinToUtf8(const char* src, size_t len) {
-    std::string result;
-    result.reserve(len * 2);  // UTF-8 may need more bytes
+// Writes into result (reusing its capacity)
+static void ebuLatinToUtf8(const char* src, size_t len, std::string& result) {
+    result.clear();
 
     for (size_t i = 0; i < len; i++) {
         uint8_t c = static_cast<uint8_t>(src[i]);
@@ -191,12 +191,40 @@ static std::string ebuLatinToUtf8(const char* src, size_t len) {
             }
         }
     }
-    return result;
+}
+
+// Max DLS size after conversion (128 chars, up to 3 UTF-8 bytes each)
+static constexpr size_t DLS_MAX_UTF8 = 128 * 3;
+
+// Max DL Plus tags per command (ETSI TS 102 980)
+static constexpr size_t DLPLUS_MAX_TAGS = 4;
+
+// X-PAD without CI continues the previous subfield: a data group start
+// (2 = DLS, 12 = MOT) continues with the matching continuation type
+static uint8_t continuationAppType(uint8_t app_type) {
+    if (app_type == 2) return 3;
+    if (app_type == 12) return 13;
+    return app_type;
+}
+
+static bool sameTags(const DLPlusTag* a, size_t count, const std::vector<DLPlusTag>& b) {
+    if (count != b.size()) return false;
+    for (size_t i = 0; i < count; i++) {
+        if (a[i].content_type != b[i].content_type ||
+            a[i].start_marker != b[i].start_marker ||
+            a[i].length_marker != b[i].length_marker) {
+            return false;
+        }
+    }
+    return true;
 }
 
 PadDecoder::PadDecoder() {
     // PAD decoder uses manual DSE parsing (like dablin's CheckForPAD)
     // No FDK-AAC initialization needed for PAD extraction
+    current_dls_.reserve(DLS_MAX_UTF8);
+    dls_scratch_.reserve(DLS_MAX_UTF8);
+    current_tags_.reserve(DLPLUS_MAX_TAGS);
     reset();
 }
 
@@ -219,11 +247,19 @@ void PadDecoder::reset() {
     xpad_app_type_ = 0;
     xpad_len_ = 0;
 
-    dg_buffer_.clear();
+    mot_dg_.clear();
+    mot_dg_expected_ = 0;
+    mot_dg_in_progress_ = false;
+    dgli_len_ = 0;
+    if (mot_decoder_) {
+        mot_decoder_->reset();
+    }
+
+    dg_len_ = 0;
     dg_in_progress_ = false;
     dg_type_ = 0;
 
-    dlplus_buffer_.clear();
+    dlplus_len_ = 0;
     dlplus_link_pending_ = false;
 
     std::memset(dls_buffer_.data(), 0, dls_buffer_.size());
@@ -233,12 +269,27 @@ void PadDecoder::reset() {
 
     current_dls_.clear();
     current_tags_.clear();
+    dlplus_reported_ = false;
 
     pad_count_ = 0;
     dls_count_ = 0;
     dlplus_count_ = 0;
 }
 
+void PadDecoder::setMotCallback(MotObjectCallback cb, size_t memory_limit) {
+    if (!cb) {
+        mot_decoder_.reset();
+        std::vector<uint8_t>().swap(mot_dg_);
+        mot_dg_in_progress_ = false;
+        return;
+    }
+    if (!mot_decoder_) {
+        mot_decoder_ = std::make_unique<MotDecoder>(memory_limit);
+        mot_dg_.reserve(MOT_DG_MAX_SIZE);
+    }
+    mot_decoder_->setCallback(std::move(cb));
+}
+
 void PadDecoder::processPad(const uint8_t* au_data, size_t au_len) {
     // Manually parse DSE from AU data like dablin does
     // The AU contains: [DSE header][PAD data (X-PAD reversed)][F-PAD (2 bytes)]
@@ -329,11 +380,9 @@ void PadDecoder::processPad(const uint8_t* au_data, size_t au_len) {
 
     if (actual_xpad_len == 0 || actual_xpad_len > xpad_len) return;
 
-    // Reverse X-PAD bytes (dablin: "undo reversed byte order")
-    std::vector<uint8_t> xpad(actual_xpad_len);
-    for (size_t i = 0; i < actual_xpad_len; i++) {
-        xpad[i] = pad_data[actual_xpad_len - 1 - i];
-    }
+    // X-PAD bytes are reversed (dablin: "undo reversed byte order") - read
+    // them in place through a reversing view instead of copying
+    XPadView xpad{pad_data, actual_xpad_len};
 
     // After reversal: CI(s) at start, data follows
 
@@ -352,9 +401,9 @@ void PadDecoder::processPad(const uint8_t* au_data, size_t au_len) {
         }
 #endif
 
-        xpad_app_type_ = app_type;
+        xpad_app_type_ = continuationAppType(app_type);
         if (app_type != 0) {
-            processXPad(xpad.data() + 1, 3, app_type);  // Data starts after CI
+            processXPad(xpad.sub(1, 3), app_type);  // Data starts after CI
         }
         return;
     }
@@ -366,21 +415,22 @@ void PadDecoder::processPad(const uint8_t* au_data, size_t au_len) {
 
         // Parse CI entries (up to 4) - dablin approach
         size_t ci_count = 0;
-        std::vector<uint8_t> cis;
+        std::array<uint8_t, 4> cis;
+        size_t cis_len = 0;
         for (size_t i = 0; i < 4 && i < actual_xpad_len; i++) {
             uint8_t ci = xpad[i];
             ci_count++;
             if ((ci & 0x1F) == 0) break;  // End marker
-            cis.push_back(ci);
+            cis[cis_len++] = ci;
         }
 
         // Data starts after CIs
         size_t data_offset = ci_count;
-        const uint8_t* data_ptr = xpad.data() + data_offset;
         size_t data_remaining = actual_xpad_len - data_offset;
 
         // Process each CI's data subfield
-        for (auto ci : cis) {
+        for (size_t c = 0; c < cis_len; c++) {
+            uint8_t ci = cis[c];
             uint8_t len_idx = (ci >> 5) & 0x07;
             uint8_t app_type = ci & 0x1F;
             size_t subfield_len = xpad_len_table[len_idx];
@@ -396,12 +446,12 @@ void PadDecoder::processPad(const uint8_t* au_data, size_t au_len) {
             }
 #endif
 
-            xpad_app_type_ = app_type;
+            xpad_app_type_ = continuationAppType(app_type);
             if (app_type != 0 && subfield_len > 0) {
-                processXPad(data_ptr, subfield_len, app_type);
+                processXPad(xpad.sub(data_offset, subfield_len), app_type);
             }
 
-            data_ptr += subfield_len;
+            data_offset += subfield_len;
             if (subfield_len <= data_remaining) {
                 data_remaining -= subfield_len;
             } else {
@@ -420,7 +470,7 @@ void PadDecoder::processPad(const uint8_t* au_data, size_t au_len) {
                         xpad_app_type_, actual_xpad_len);
             }
 #endif
-            processXPad(xpad.data(), actual_xpad_len, xpad_app_type_);
+            processXPad(xpad, xpad_app_type_);
         }
     }
 }
@@ -435,7 +485,9 @@ void PadDecoder::processFPad(uint8_t fpad_type, uint8_t ci_flag) {
     (void)ci_flag;
 }
 
-void PadDecoder::processXPad(const uint8_t* xpad, size_t len, uint8_t app_type) {
+void PadDecoder::processXPad(XPadView xpad, uint8_t app_type) {
+    size_t len = xpad.len;
+
     // X-PAD Application Types:
     // 0: Not used
     // 1: Data Group Length Indicator
@@ -446,12 +498,11 @@ void PadDecoder::processXPad(const uint8_t* xpad, size_t len, uint8_t app_type)
 
     if (app_type == 1) {
         // Data Group Length Indicator (DGLI)
-        // Tells us the expected total length of the Data Group
-        if (len >= 4) {
-            // DGLI format: 4 bytes giving the length
-            // Bits 0-1: RFU, Bits 2-13: Length (12 bits)
-            size_t dg_len = ((xpad[0] & 0x3F) << 6) | ((xpad[1] >> 2) & 0x3F);
-            xpad_len_ = dg_len;
+        // Tells us the expected total length of the next (MOT) Data Group
+        if (len >= 2) {
+            // DGLI format: Rfa (2 bits) + length (14 bits), followed by CRC
+            size_t dg_len = ((xpad[0] & 0x3F) << 8) | xpad[1];
+            dgli_len_ = dg_len;
 #ifdef PAD_DEBUG
             fprintf(stderr, "[PAD] DGLI: expected length=%zu\n", dg_len);
 #endif
@@ -461,15 +512,15 @@ void PadDecoder::processXPad(const uint8_t* xpad, size_t len, uint8_t app_type)
 
     if (app_type == 2) {
         // Data Group start - first, process any pending Data Group
-        if (dg_in_progress_ && dg_buffer_.size() >= 3) {
+        if (dg_in_progress_ && dg_len_ >= 3) {
 #ifdef PAD_DEBUG
-            fprintf(stderr, "[PAD] Processing completed DG: size=%zu\n", dg_buffer_.size());
+            fprintf(stderr, "[PAD] Processing completed DG: size=%zu\n", dg_len_);
 #endif
-            processDataGroup(dg_buffer_.data(), dg_buffer_.size());
+            processDataGroup(dg_buffer_.data(), dg_len_);
         }
 
         // Reset and start collecting new Data Group
-        dg_buffer_.clear();
+        dg_len_ = 0;
         dg_in_progress_ = true;
         xpad_len_ = 0;
     }
@@ -478,21 +529,24 @@ void PadDecoder::processXPad(const uint8_t* xpad, size_t len, uint8_t app_type)
         // Data Group segment (start or continuation)
 #ifdef PAD_DEBUG
         fprintf(stderr, "[PAD] DG segment: app_type=%d dg_in_progress=%d len=%zu buffer_size=%zu\n",
-                app_type, dg_in_progress_, len, dg_buffer_.size());
+                app_type, dg_in_progress_, len, dg_len_);
 #endif
         if (!dg_in_progress_) return;
         if (len == 0) return;
 
-        dg_buffer_.insert(dg_buffer_.end(), xpad, xpad + len);
+        // Copy in transmission order; bytes beyond capacity are dropped
+        size_t copy_len = std::min(len, dg_buffer_.size() - dg_len_);
+        xpad.copyTo(dg_buffer_.data() + dg_len_, copy_len);
+        dg_len_ += copy_len;
 
         // If we have expected length from DGLI and have reached it, process now
-        if (xpad_len_ > 0 && dg_buffer_.size() >= xpad_len_) {
+        if (xpad_len_ > 0 && dg_len_ >= xpad_len_) {
 #ifdef PAD_DEBUG
             fprintf(stderr, "[PAD] DG complete (DGLI): size=%zu expected=%zu\n",
-                    dg_buffer_.size(), xpad_len_);
+                    dg_len_, xpad_len_);
 #endif
-            processDataGroup(dg_buffer_.data(), dg_buffer_.size());
-            dg_buffer_.clear();
+            processDataGroup(dg_buffer_.data(), dg_len_);
+            dg_len_ = 0;
             dg_in_progress_ = false;
             xpad_len_ = 0;
         }
@@ -500,7 +554,40 @@ void PadDecoder::processXPad(const uint8_t* xpad, size_t len, uint8_t app_type)
         return;
     }
 
-    // Other application types (MOT, etc.) - not implemented yet
+    if (app_type == 12 || app_type == 13) {
+        if (mot_decoder_) {
+            processMotSegment(xpad, app_type == 12);
+        }
+        return;
+    }
+
+    // Other application types - not implemented
+}
+
+void PadDecoder::processMotSegment(XPadView xpad, bool start) {
+    if (start) {
+        // Data group without (or with a wrong) DGLI - hand over what we have,
+        // the data group CRC decides whether it is usable
+        if (mot_dg_in_progress_ && !mot_dg_.empty()) {
+            mot_decoder_->feedDataGroup(mot_dg_.data(), mot_dg_.size());
+        }
+        mot_dg_.clear();
+        mot_dg_expected_ = dgli_len_;
+        dgli_len_ = 0;
+        mot_dg_in_progress_ = true;
+    }
+    if (!mot_dg_in_progress_ || xpad.len == 0) return;
+
+    size_t copy_len = std::min(xpad.len, MOT_DG_MAX_SIZE - mot_dg_.size());
+    size_t offset = mot_dg_.size();
+    mot_dg_.resize(offset + copy_len);
+    xpad.copyTo(mot_dg_.data() + offset, copy_len);
+
+    if (mot_dg_expected_ > 0 && mot_dg_.size() >= mot_dg_expected_) {
+        mot_decoder_->feedDataGroup(mot_dg_.data(), mot_dg_expected_);
+        mot_dg_.clear();
+        mot_dg_in_progress_ = false;
+    }
 }
 
 void PadDecoder::processDataGroup(const uint8_t* data, size_t len) {
@@ -617,39 +704,46 @@ void PadDecoder::processDLSSegmentNew(const uint8_t* data, size_t len, bool firs
         // Complete DLS received
         dls_buffer_[dls_len_] = '\0';
 
-        // Convert charset if needed
+        // Convert charset if needed (into scratch - labels repeat far more
+        // often than they change)
         if (dls_charset_ == 0) {
             // Convert EBU Latin to UTF-8
-            current_dls_ = ebuLatinToUtf8(dls_buffer_.data(), dls_len_);
+            ebuLatinToUtf8(dls_buffer_.data(), dls_len_, dls_scratch_);
         } else {
-            current_dls_ = std::string(dls_buffer_.data(), dls_len_);
+            dls_scratch_.assign(dls_buffer_.data(), dls_len_);
         }
 
         current_dls_toggle_ = dls_toggle_;  // Store toggle of completed DLS
 
         // Trim trailing spaces/nulls
-        while (!current_dls_.empty() &&
-               (current_dls_.back() == ' ' || current_dls_.back() == '\0')) {
-            current_dls_.pop_back();
+        while (!dls_scratch_.empty() &&
+               (dls_scratch_.back() == ' ' || dls_scratch_.back() == '\0')) {
+            dls_scratch_.pop_back();
         }
 
-        // Clear tags when DLS changes (toggle changes)
-        current_tags_.clear();
-
         dls_count_++;
+        dls_first_received_ = false;
 
 #ifdef PAD_DEBUG
         fprintf(stderr, "[PAD] *** COMPLETE DLS #%zu (toggle=%d): '%s'\n",
-                dls_count_, current_dls_toggle_, current_dls_.c_str());
+                dls_count_, current_dls_toggle_, dls_scratch_.c_str());
 #endif
 
+        // Repeated label - keep text and tags, no callbacks
+        if (dls_scratch_ == current_dls_) {
+            return;
+        }
+        current_dls_.swap(dls_scratch_);
+
+        // Clear tags when DLS changes
+        current_tags_.clear();
+        dlplus_reported_ = false;
+
         if (dls_callback_ && !current_dls_.empty()) {
             dls_callback_(current_dls_);
         }
 
         // Note: Don't call dlplus_callback here - wait for matching DL Plus tags
-
-        dls_first_received_ = false;
     }
 }
 
@@ -705,13 +799,13 @@ void PadDecoder::processDLSSegment(const uint8_t* data, size_t len, bool first,
         // Charset 15 = UTF-8
         if (dls_charset_ == 0) {
             // Convert EBU Latin to UTF-8
-            current_dls_ = ebuLatinToUtf8(dls_buffer_.data(), dls_len_);
+            ebuLatinToUtf8(dls_buffer_.data(), dls_len_, current_dls_);
         } else if (dls_charset_ == 15) {
             // Already UTF-8
-            current_dls_ = std::string(dls_buffer_.data(), dls_len_);
+            current_dls_.assign(dls_buffer_.data(), dls_len_);
         } else {
             // Unknown charset - use as-is
-            current_dls_ = std::string(dls_buffer_.data(), dls_len_);
+            current_dls_.assign(dls_buffer_.data(), dls_len_);
         }
 
         // Trim trailing spaces/nulls
@@ -759,7 +853,7 @@ void PadDecoder::processDLPlus(const uint8_t* data, size_t len, bool toggle) {
         fprintf(stderr, "[PAD] DL Plus: toggle mismatch (dlplus=%d, dls=%d), skipping\n",
                 toggle, current_dls_toggle_);
 #endif
-        dlplus_buffer_.clear();
+        dlplus_len_ = 0;
         dlplus_link_pending_ = false;
         return;
     }
@@ -768,57 +862,51 @@ void PadDecoder::processDLPlus(const uint8_t* data, size_t len, bool toggle) {
 
     uint8_t header = data[0];
     bool link_bit = (header & 0x80) != 0;
-    int nt = header & 0x0F;
-    int num_tags = nt + 1;
 
     // Handle linked segments: accumulate data until link bit is 0
     if (link_bit) {
         // This segment links to next - accumulate (skip header, include tag bytes)
         // CRC is only at the end of the final segment
-        if (dlplus_buffer_.empty()) {
+        if (dlplus_len_ == 0) {
             // First segment - store header info
-            dlplus_buffer_.push_back(header);
+            dlplus_buffer_[dlplus_len_++] = header;
         }
         // Append tag data (skip header byte, keep rest except possible partial CRC)
-        for (size_t i = 1; i < len; i++) {
-            dlplus_buffer_.push_back(data[i]);
-        }
+        size_t copy_len = std::min(len - 1, dlplus_buffer_.size() - dlplus_len_);
+        std::memcpy(dlplus_buffer_.data() + dlplus_len_, data + 1, copy_len);
+        dlplus_len_ += copy_len;
         dlplus_link_pending_ = true;
 #ifdef PAD_DEBUG
-        fprintf(stderr, "[PAD] DL Plus: link segment, accumulated %zu bytes\n", dlplus_buffer_.size());
+        fprintf(stderr, "[PAD] DL Plus: link segment, accumulated %zu bytes\n", dlplus_len_);
 #endif
         return;
     }
 
     // Final segment (link bit = 0)
-    std::vector<uint8_t> complete_data;
-    if (dlplus_link_pending_ && !dlplus_buffer_.empty()) {
+    const uint8_t* complete_data = data;
+    size_t complete_len = len;
+    if (dlplus_link_pending_ && dlplus_len_ > 0) {
         // We have accumulated data from previous segments
-        complete_data = std::move(dlplus_buffer_);
-        // Append this final segment (skip header if we already have one)
-        for (size_t i = 1; i < len; i++) {
-            complete_data.push_back(data[i]);
-        }
-        dlplus_buffer_.clear();
+        // Append this final segment (skip header, we already have one)
+        size_t copy_len = std::min(len - 1, dlplus_buffer_.size() - dlplus_len_);
+        std::memcpy(dlplus_buffer_.data() + dlplus_len_, data + 1, copy_len);
+        complete_data = dlplus_buffer_.data();
+        complete_len = dlplus_len_ + copy_len;
+        dlplus_len_ = 0;
         dlplus_link_pending_ = false;
-        // Update header and num_tags from accumulated data
         header = complete_data[0];
-        nt = header & 0x0F;
-        num_tags = nt + 1;
-    } else {
-        // Single segment, no linking
-        complete_data.assign(data, data + len);
     }
+    int num_tags = (header & 0x0F) + 1;
 
     // Remove CRC-16 (2 bytes) from the end
-    if (complete_data.size() < 5) return;  // Need header + at least 1 tag + CRC
-    size_t data_len = complete_data.size() - 2;
+    if (complete_len < 5) return;  // Need header + at least 1 tag + CRC
+    size_t data_len = complete_len - 2;
 
 #ifdef PAD_DEBUG
-    fprintf(stderr, "[PAD] DL Plus: complete len=%zu data_len=%zu header=0x%02x nt=%d num_tags=%d\n",
-            complete_data.size(), data_len, header, nt, num_tags);
+    fprintf(stderr, "[PAD] DL Plus: complete len=%zu data_len=%zu header=0x%02x num_tags=%d\n",
+            complete_len, data_len, header, num_tags);
     fprintf(stderr, "[PAD] DL Plus raw: ");
-    for (size_t i = 0; i < complete_data.size() && i < 24; i++) {
+    for (size_t i = 0; i < complete_len && i < 24; i++) {
         fprintf(stderr, "%02x ", complete_data[i]);
     }
     fprintf(stderr, "\n");
@@ -830,13 +918,14 @@ void PadDecoder::processDLPlus(const uint8_t* data, size_t len, bool toggle) {
     int max_tags = static_cast<int>(available_tag_bytes / 3);
     num_tags = std::min(num_tags, max_tags);
 
-    if (num_tags <= 0 || num_tags > 4) {
+    if (num_tags <= 0 || num_tags > static_cast<int>(DLPLUS_MAX_TAGS)) {
         return;
     }
 
     // Parse tags
-    current_tags_.clear();
-    const uint8_t* tag_ptr = complete_data.data() + tag_offset;
+    std::array<DLPlusTag, DLPLUS_MAX_TAGS> tags;
+    size_t tag_count = 0;
+    const uint8_t* tag_ptr = complete_data + tag_offset;
 
     for (int i = 0; i < num_tags; i++) {
         if (tag_offset + (i + 1) * 3 > data_len) break;
@@ -855,10 +944,6 @@ void PadDecoder::processDLPlus(const uint8_t* data, size_t len, bool toggle) {
                     i, static_cast<int>(tag.content_type),
                     dlPlusContentTypeToString(tag.content_type),
                     tag.start_marker, tag.length_marker);
-            if (!current_dls_.empty() && tag.start_marker < current_dls_.size()) {
-                std::string extracted = tag.extract(current_dls_);
-                fprintf(stderr, "[PAD] DL Plus tag %d text: '%s'\n", i, extracted.c_str());
-            }
 #endif
             // Only add tags for TITLE and ARTIST (the ones we care about for EIT)
             if (tag.content_type == DLPlusContentType::ITEM_TITLE ||
@@ -866,20 +951,28 @@ void PadDecoder::processDLPlus(const uint8_t* data, size_t len, bool toggle) {
                 tag.content_type == DLPlusContentType::ITEM_ALBUM ||
                 tag.content_type == DLPlusContentType::PROGRAMME_NOW ||
                 tag.content_type == DLPlusContentType::STATIONNAME_LONG) {
-                current_tags_.push_back(tag);
+                tags[tag_count++] = tag;
             }
         }
 
         tag_ptr += 3;
     }
 
-    if (!current_tags_.empty()) {
-        dlplus_count_++;
+    if (tag_count == 0) {
+        return;
+    }
+    dlplus_count_++;
+
+    // Same tags for the same text (DL Plus is repeated with every DLS)
+    if (dlplus_reported_ && sameTags(tags.data(), tag_count, current_tags_)) {
+        return;
+    }
+    current_tags_.assign(tags.begin(), tags.begin() + tag_count);
 
-        // Notify callback if we have DLS text
-        if (dlplus_callback_ && !current_dls_.empty()) {
-            dlplus_callback_(current_dls_, current_tags_);
-        }
+    // Notify callback if we have DLS text
+    if (dlplus_callback_ && !current_dls_.empty()) {
+        dlplus_callback_(current_dls_, current_tags_);
+        dlplus_reported_ = true;
     }
 }
 
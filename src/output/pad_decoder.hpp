@@ -1,7 +1,8 @@
 #pragma once
 // PAD (Programme Associated Data) decoder for DAB+
 // Extracts DLS (Dynamic Label Segment) text and DL Plus tags
-// References: ETSI EN 300 401, ETSI TS 102 980
+// Extracts MOT objects (slideshow) when subscribed
+// References: ETSI EN 300 401, ETSI TS 102 980, ETSI EN 301 234
 //
 // Uses FDK-AAC to properly extract DSE (ancillary data) from AAC AU
 
@@ -11,6 +12,8 @@
 #include <vector>
 #include <functional>
 #include <array>
+#include <memory>
+#include "mot_decoder.hpp"
 
 namespace dvbdab {
 
@@ -92,15 +95,36 @@ struct DLPlusTag {
     }
 };
 
-// Callback for complete DLS text
+// X-PAD as carried in the DSE (byte-reversed), read in place.
+// Index 0 is the first X-PAD byte (the last byte before F-PAD).
+struct XPadView {
+    const uint8_t* data;  // Raw (reversed) bytes
+    size_t len;
+
+    uint8_t operator[](size_t i) const { return data[len - 1 - i]; }
+
+    // Sub-view of X-PAD bytes [offset, offset + n)
+    XPadView sub(size_t offset, size_t n) const { return {data + len - offset - n, n}; }
+
+    // Copy the first n X-PAD bytes in transmission order
+    void copyTo(uint8_t* dst, size_t n) const {
+        for (size_t i = 0; i < n; i++) dst[i] = data[len - 1 - i];
+    }
+};
+
+// Callback for complete DLS text (only called when the text changes)
 using DLSCallback = std::function<void(const std::string& text)>;
 
-// Callback for DL Plus update (text + tags)
+// Callback for DL Plus update (text + tags, only called when either changes)
 using DLPlusCallback = std::function<void(const std::string& text,
                                           const std::vector<DLPlusTag>& tags)>;
 
 // PAD decoder - processes F-PAD and X-PAD from DAB+ audio frames
 // Uses FDK-AAC to extract ancillary data (DSE) like dablin does
+//
+// Runs for every AU, so the steady-state path does not allocate: X-PAD is
+// read in place through XPadView, data groups and DL Plus segments use
+// fixed-capacity buffers, and DLS/tag storage is reserved up front.
 class PadDecoder {
 public:
     PadDecoder();
@@ -118,6 +142,13 @@ public:
     void setDLSCallback(DLSCallback cb) { dls_callback_ = std::move(cb); }
     void setDLPlusCallback(DLPlusCallback cb) { dlplus_callback_ = std::move(cb); }
 
+    // MOT objects (X-PAD app types 12/13). The MOT decoder and its buffers are
+    // only created while a callback is set; pass nullptr to unsubscribe.
+    void setMotCallback(MotObjectCallback cb, size_t memory_limit = MotDecoder::DEFAULT_MEMORY_LIMIT);
+
+    // MOT decoder statistics (nullptr if not subscribed)
+    const MotDecoder* getMotDecoder() const { return mot_decoder_.get(); }
+
     // Process PAD data from DAB+ AU
     // pad_data points to the PAD portion (last bytes of AU before CRC)
     // pad_len is the length of PAD (typically AU length - audio data - 2 CRC bytes)
@@ -139,12 +170,15 @@ private:
     // Process F-PAD (last 2 bytes)
     void processFPad(uint8_t fpad_type, uint8_t ci_flag);
 
-    // Process X-PAD based on content indicator (legacy)
-    void processXPad(const uint8_t* xpad, size_t len, uint8_t app_type);
+    // Process X-PAD subfield based on content indicator
+    void processXPad(XPadView xpad, uint8_t app_type);
 
     // Process X-PAD data (new implementation)
     void processXPadData(const uint8_t* xpad, size_t len, uint8_t app_type);
 
+    // MOT data group segment (app type 12 = start, 13 = continuation)
+    void processMotSegment(XPadView xpad, bool start);
+
     // Try to process accumulated Data Group
     void tryProcessDataGroup();
 
@@ -170,15 +204,28 @@ private:
     uint8_t xpad_app_type_ = 0;    // Application Type
     size_t xpad_len_ = 0;          // Expected X-PAD length
 
-    // Data group reassembly
-    std::vector<uint8_t> dg_buffer_;
+    // Data group reassembly (DLS/DL Plus data groups are at most 22 bytes;
+    // anything beyond capacity is padding and dropped)
+    static constexpr size_t DG_MAX_SIZE = 256;
+    std::array<uint8_t, DG_MAX_SIZE> dg_buffer_;
+    size_t dg_len_ = 0;
     bool dg_in_progress_ = false;
     uint8_t dg_type_ = 0;
 
     // DL Plus segment reassembly (for linked segments)
-    std::vector<uint8_t> dlplus_buffer_;
+    static constexpr size_t DLPLUS_MAX_SIZE = 64;
+    std::array<uint8_t, DLPLUS_MAX_SIZE> dlplus_buffer_;
+    size_t dlplus_len_ = 0;
     bool dlplus_link_pending_ = false;
 
+    // MOT data group reassembly (only used while subscribed)
+    static constexpr size_t MOT_DG_MAX_SIZE = 16384;  // DGLI is 14 bits
+    std::unique_ptr<MotDecoder> mot_decoder_;
+    std::vector<uint8_t> mot_dg_;
+    size_t mot_dg_expected_ = 0;   // From DGLI, 0 = unknown
+    bool mot_dg_in_progress_ = false;
+    size_t dgli_len_ = 0;          // Last Data Group Length Indicator
+
     // DLS reassembly
     std::array<char, 129> dls_buffer_;  // 128 chars + null
     size_t dls_len_ = 0;
@@ -186,10 +233,12 @@ private:
     bool dls_first_received_ = false;
     bool dls_toggle_ = false;      // Toggle bit for current DLS
 
-    // Current state
+    // Current state (capacity reserved in constructor)
     std::string current_dls_;
+    std::string dls_scratch_;          // Conversion target, swapped in on change
     std::vector<DLPlusTag> current_tags_;
     bool current_dls_toggle_ = false;  // Toggle of completed DLS
+    bool dlplus_reported_ = false;     // current_tags_ passed to callback
 
     // Callbacks
     DLSCallback dls_callback_;
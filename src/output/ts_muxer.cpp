@@ -544,6 +544,15 @@ void TsMuxer::feedAudioFrame(uint16_t sid, const uint8_t* data, size_t len, uint
     outputPes(svc.audio_pid, 0xC0, data, len, pts);  // 0xC0 = audio stream
 }
 
+void TsMuxer::feedAudioFrame(uint16_t sid, const uint8_t* header, size_t header_len,
+                             const uint8_t* payload, size_t payload_len, uint64_t pts) {
+    auto it = sid_to_index_.find(sid);
+    if (it == sid_to_index_.end()) return;
+
+    const TsService& svc = services_[it->second];
+    outputPes(svc.audio_pid, 0xC0, header, header_len, pts, payload, payload_len);
+}
+
 void TsMuxer::feedSubchannelData(uint8_t subchannel_id, const uint8_t* data, size_t len) {
     auto it = subch_to_index_.find(subchannel_id);
     if (it == subch_to_index_.end()) return;
@@ -553,8 +562,9 @@ void TsMuxer::feedSubchannelData(uint8_t subchannel_id, const uint8_t* data, siz
     outputPes(svc.audio_pid, 0xBD, data, len, 0);  // 0xBD = private stream 1
 }
 
-void TsMuxer::outputPes(uint16_t pid, uint8_t stream_id, const uint8_t* data, size_t len, uint64_t pts) {
-    if (!output_ || len == 0) return;
+void TsMuxer::outputPes(uint16_t pid, uint8_t stream_id, const uint8_t* data, size_t len, uint64_t pts,
+                        const uint8_t* data2, size_t len2) {
+    if (!output_ || len + len2 == 0) return;
 
     // Determine if we need to insert PCR (every ~4 frames = ~100ms)
     bool insert_pcr = (audio_frame_count_++ % 4 == 0);
@@ -562,52 +572,72 @@ void TsMuxer::outputPes(uint16_t pid, uint8_t stream_id, const uint8_t* data, si
         pcr_base_ = pts;  // Use PTS as PCR base
     }
 
-    // Build PES packet
-    std::vector<uint8_t> pes;
-    pes.reserve(len + 20);
+    // Build PES header (payload pieces are gathered into TS packets below)
+    std::array<uint8_t, 14> hdr;
+    size_t hdr_len = 0;
+    auto push = [&](uint8_t b) { hdr[hdr_len++] = b; };
 
     // PES start code
-    pes.push_back(0x00);
-    pes.push_back(0x00);
-    pes.push_back(0x01);
+    push(0x00);
+    push(0x00);
+    push(0x01);
 
     // Stream ID
-    pes.push_back(stream_id);
+    push(stream_id);
 
     // PES packet length (0 = unbounded for video, but we'll set it for audio)
-    size_t pes_len = len + (pts ? 8 : 3);  // header extension + data
+    size_t pes_len = len + len2 + (pts ? 8 : 3);  // header extension + data
     if (pes_len > 0xFFFF) pes_len = 0;  // Too long, use unbounded
-    pes.push_back((pes_len >> 8) & 0xFF);
-    pes.push_back(pes_len & 0xFF);
+    push((pes_len >> 8) & 0xFF);
+    push(pes_len & 0xFF);
 
     // PES header flags
     // '10' + PES_scrambling_control(2) + PES_priority(1) + data_alignment_indicator(1) + copyright(1) + original_or_copy(1)
-    pes.push_back(0x80);
+    push(0x80);
 
     // PTS_DTS_flags(2) + ESCR_flag(1) + ES_rate_flag(1) + DSM_trick_mode_flag(1) + additional_copy_info_flag(1) + PES_CRC_flag(1) + PES_extension_flag(1)
-    pes.push_back(pts ? 0x80 : 0x00);  // PTS present if non-zero
+    push(pts ? 0x80 : 0x00);  // PTS present if non-zero
 
     // PES_header_data_length
-    pes.push_back(pts ? 5 : 0);
+    push(pts ? 5 : 0);
 
     // PTS (if present)
     if (pts) {
         // PTS is 33 bits, split across 5 bytes with markers
-        pes.push_back(0x21 | ((pts >> 29) & 0x0E));
-        pes.push_back((pts >> 22) & 0xFF);
-        pes.push_back(0x01 | ((pts >> 14) & 0xFE));
-        pes.push_back((pts >> 7) & 0xFF);
-        pes.push_back(0x01 | ((pts << 1) & 0xFE));
+        push(0x21 | ((pts >> 29) & 0x0E));
+        push((pts >> 22) & 0xFF);
+        push(0x01 | ((pts >> 14) & 0xFE));
+        push((pts >> 7) & 0xFF);
+        push(0x01 | ((pts << 1) & 0xFE));
     }
 
-    // PES payload
-    pes.insert(pes.end(), data, data + len);
+    // PES = header + data + data2, copied straight into TS payloads
+    const uint8_t* pieces[3] = {hdr.data(), data, data2};
+    size_t sizes[3] = {hdr_len, len, len2};
+    size_t piece = 0;
+    size_t piece_offset = 0;
+    auto gather = [&](uint8_t* dst, size_t n) {
+        while (n > 0) {
+            size_t avail = sizes[piece] - piece_offset;
+            if (avail == 0) {
+                piece++;
+                piece_offset = 0;
+                continue;
+            }
+            size_t chunk = std::min(avail, n);
+            std::memcpy(dst, pieces[piece] + piece_offset, chunk);
+            dst += chunk;
+            n -= chunk;
+            piece_offset += chunk;
+        }
+    };
+    size_t pes_size = hdr_len + len + len2;
 
     // Now packetize into TS packets
     size_t offset = 0;
     bool first = true;
 
-    while (offset < pes.size()) {
+    while (offset < pes_size) {
         std::array<uint8_t, PACKET_SIZE> packet{};
 
         packet[0] = 0x47;
@@ -615,7 +645,7 @@ void TsMuxer::outputPes(uint16_t pid, uint8_t stream_id, const uint8_t* data, si
         packet[2] = pid & 0xFF;
 
         uint8_t& cc = cc_[pid];
-        size_t remaining = pes.size() - offset;
+        size_t remaining = pes_size - offset;
 
         // Insert PCR on first packet if needed
         if (first && insert_pcr) {
@@ -638,7 +668,7 @@ void TsMuxer::outputPes(uint16_t pid, uint8_t stream_id, const uint8_t* data, si
             packet[11] = 0x00;  // PCR extension = 0
 
             size_t to_copy = std::min(remaining, payload_len);
-            std::memcpy(&packet[12], pes.data() + offset, to_copy);
+            gather(&packet[12], to_copy);
             offset += to_copy;
 
             // Stuff if needed
@@ -653,7 +683,7 @@ void TsMuxer::outputPes(uint16_t pid, uint8_t stream_id, const uint8_t* data, si
                 // Just adaptation_field_length = 0
                 packet[3] = 0x30 | (cc & 0x0F);
                 packet[4] = 0x00;
-                std::memcpy(&packet[5], pes.data() + offset, remaining);
+                gather(&packet[5], remaining);
             } else {
                 packet[3] = 0x30 | (cc & 0x0F);
                 packet[4] = static_cast<uint8_t>(stuff_len);
@@ -661,12 +691,12 @@ void TsMuxer::outputPes(uint16_t pid, uint8_t stream_id, const uint8_t* data, si
                 if (stuff_len > 1) {
                     std::memset(&packet[6], 0xFF, stuff_len - 1);
                 }
-                std::memcpy(&packet[4 + stuff_len + 1], pes.data() + offset, remaining);
+                gather(&packet[4 + stuff_len + 1], remaining);
             }
-            offset = pes.size();
+            offset = pes_size;
         } else {
             packet[3] = 0x10 | (cc & 0x0F);
-            std::memcpy(&packet[4], pes.data() + offset, PACKET_SIZE - 4);
+            gather(&packet[4], PACKET_SIZE - 4);
             offset += PACKET_SIZE - 4;
         }
 
@@ -74,6 +74,11 @@ public:
     // The muxer will packetize into TS packets with PES headers
     void feedAudioFrame(uint16_t sid, const uint8_t* data, size_t len, uint64_t pts);
 
+    // Feed audio frame given as two pieces (e.g. ADTS header + AU); both are
+    // written straight into the TS payloads without building a PES copy
+    void feedAudioFrame(uint16_t sid, const uint8_t* header, size_t header_len,
+                        const uint8_t* payload, size_t payload_len, uint64_t pts);
+
     // Feed raw subchannel data (MSC data from ETI)
     // For services that need the raw DAB stream
     void feedSubchannelData(uint8_t subchannel_id, const uint8_t* data, size_t len);
@@ -103,8 +108,9 @@ private:
     // Output a complete section as TS packets
     void outputSection(uint16_t pid, uint8_t table_id, const std::vector<uint8_t>& section_data);
 
-    // Output PES packet
-    void outputPes(uint16_t pid, uint8_t stream_id, const uint8_t* data, size_t len, uint64_t pts);
+    // Output PES packet (payload is data followed by optional data2)
+    void outputPes(uint16_t pid, uint8_t stream_id, const uint8_t* data, size_t len, uint64_t pts,
+                   const uint8_t* data2 = nullptr, size_t len2 = 0);
 
     // Write a TS packet
     void writePacket(uint16_t pid, bool pusi, const uint8_t* payload, size_t len);
@@ -74,7 +74,8 @@ void TsPacketizer::configureFromEnsemble(const lsdvb::DABEnsemble& ensemble) {
             uint8_t scid = dab_svc.subchannel_id;
 
             // Audio callback
-            decoder->setCallback([this, scid](const uint8_t* data, size_t len) {
+            decoder->setFrameCallback([this, scid](const uint8_t* data, size_t len,
+                                                   const uint8_t* au, size_t au_len) {
                 if (!muxer_ || len < 7) return;
                 auto it = subch_to_sid_.find(scid);
                 if (it == subch_to_sid_.end()) return;
@@ -90,7 +91,7 @@ void TsPacketizer::configureFromEnsemble(const lsdvb::DABEnsemble& ensemble) {
                 int64_t pts = pts_counter_[it->second];
                 pts_counter_[it->second] += (int64_t)1024 * 90000 / sample_rate;
 
-                muxer_->feedAudioFrame(scid, data, len, pts);
+                muxer_->feedAudioFrame(scid, data, len, au, au_len, pts);
             });
 
             // DL Plus callback - disabled due to parsing issues
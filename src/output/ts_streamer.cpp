@@ -1,8 +1,11 @@
 #include "ts_streamer.hpp"
+#include "thread_config.hpp"
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <sys/uio.h>
+#include <chrono>
 #include <cstring>
 #include <iostream>
 
@@ -76,6 +79,9 @@ bool UdpTsStreamer::start() {
         setsockopt(socket_, IPPROTO_IP, IP_MULTICAST_LOOP, &loopback, sizeof(loopback));
     }
 
+    rtp_seq_ = 0;
+    rtp_ssrc_ = ntohl(ip) ^ (static_cast<uint32_t>(port_) << 16) ^ static_cast<uint32_t>(getpid());
+
     running_ = true;
     sender_thread_ = std::thread(&UdpTsStreamer::senderThread, this);
 
@@ -133,6 +139,8 @@ size_t UdpTsStreamer::getQueueSize() const {
 }
 
 void UdpTsStreamer::senderThread() {
+    applyThreadConfig(ThreadRole::UdpSender);
+
     struct sockaddr_in dest_addr;
     std::memset(&dest_addr, 0, sizeof(dest_addr));
     dest_addr.sin_family = AF_INET;
@@ -161,9 +169,7 @@ void UdpTsStreamer::senderThread() {
         }
 
         // Send datagram
-        ssize_t sent = sendto(socket_, datagram.data(), datagram.size(), 0,
-                              reinterpret_cast<struct sockaddr*>(&dest_addr),
-                              sizeof(dest_addr));
+        ssize_t sent = sendTo(datagram.data(), datagram.size(), dest_addr);
         if (sent > 0) {
             datagrams_sent_++;
             packets_sent_ += datagram.size() / TS_PKT_SIZE;
@@ -172,9 +178,7 @@ void UdpTsStreamer::senderThread() {
 
     // Flush remaining data in buffer
     if (datagram_offset_ > 0) {
-        ssize_t sent = sendto(socket_, datagram_buffer_.data(), datagram_offset_, 0,
-                              reinterpret_cast<struct sockaddr*>(&dest_addr),
-                              sizeof(dest_addr));
+        ssize_t sent = sendTo(datagram_buffer_.data(), datagram_offset_, dest_addr);
         if (sent > 0) {
             datagrams_sent_++;
             packets_sent_ += datagram_offset_ / TS_PKT_SIZE;
@@ -190,9 +194,39 @@ void UdpTsStreamer::sendDatagram(const uint8_t* data, size_t len) {
     dest_addr.sin_port = htons(port_);
     dest_addr.sin_addr.s_addr = inet_addr(host_.c_str());
 
-    sendto(socket_, data, len, 0,
-           reinterpret_cast<struct sockaddr*>(&dest_addr),
-           sizeof(dest_addr));
+    sendTo(data, len, dest_addr);
+}
+
+ssize_t UdpTsStreamer::sendTo(const uint8_t* data, size_t len, const struct sockaddr_in& dest) {
+    if (!rtp_) {
+        return sendto(socket_, data, len, 0,
+                      reinterpret_cast<const struct sockaddr*>(&dest), sizeof(dest));
+    }
+
+    // RTP header (RFC 3550): V=2, PT=33 (MP2T), 90 kHz timestamp
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    uint32_t ts = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count() * 9 / 100);
+    uint16_t seq = rtp_seq_++;
+    uint8_t header[12] = {
+        0x80, 33,
+        static_cast<uint8_t>(seq >> 8), static_cast<uint8_t>(seq),
+        static_cast<uint8_t>(ts >> 24), static_cast<uint8_t>(ts >> 16),
+        static_cast<uint8_t>(ts >> 8), static_cast<uint8_t>(ts),
+        static_cast<uint8_t>(rtp_ssrc_ >> 24), static_cast<uint8_t>(rtp_ssrc_ >> 16),
+        static_cast<uint8_t>(rtp_ssrc_ >> 8), static_cast<uint8_t>(rtp_ssrc_)
+    };
+
+    struct iovec iov[2] = {
+        { header, sizeof(header) },
+        { const_cast<uint8_t*>(data), len }
+    };
+    struct msghdr msg{};
+    msg.msg_name = const_cast<struct sockaddr_in*>(&dest);
+    msg.msg_namelen = sizeof(dest);
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+    ssize_t sent = sendmsg(socket_, &msg, 0);
+    return sent > static_cast<ssize_t>(sizeof(header)) ? sent - static_cast<ssize_t>(sizeof(header)) : sent;
 }
 
 } // namespace dvbdab
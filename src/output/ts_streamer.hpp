@@ -8,6 +8,7 @@
 #include <queue>
 #include <mutex>
 #include <condition_variable>
+#include <netinet/in.h>
 
 namespace dvbdab {
 
@@ -30,6 +31,9 @@ public:
     // Set packets per UDP datagram (default: 7 = 1316 bytes per datagram)
     void setPacketsPerDatagram(size_t count);
 
+    // Prefix each datagram with an RTP header (RFC 2250, payload type 33)
+    void setRtp(bool enable) { rtp_ = enable; }
+
     // Start streaming (launches sender thread)
     bool start();
 
@@ -53,6 +57,7 @@ public:
 private:
     void senderThread();
     void sendDatagram(const uint8_t* data, size_t len);
+    ssize_t sendTo(const uint8_t* data, size_t len, const struct sockaddr_in& dest);
 
     int socket_{-1};
     std::string host_;
@@ -60,6 +65,9 @@ private:
     std::string interface_;
     int ttl_{1};
     size_t packets_per_datagram_{7};  // 7 * 188 = 1316 bytes
+    bool rtp_{false};
+    uint16_t rtp_seq_{0};
+    uint32_t rtp_ssrc_{0};
 
     std::atomic<bool> running_{false};
     std::thread sender_thread_;
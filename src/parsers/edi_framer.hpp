@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace dvbdab {
+
+// AF packet framing for EDI carried in a byte stream (EDI over TCP, EDI files)
+//
+// A stream is a plain sequence of AF packets: "AF", LEN (4 bytes), SEQ (2),
+// AR (1), PT (1), LEN bytes of tag items, CRC (2 bytes if AR.CF is set).
+// Complete packets are passed to the callback straight out of the input;
+// only packets split across feed() calls are assembled in a carry buffer.
+// On a header that does not look like an AF packet the framer hunts for the
+// next "AF" sync. The CRC is left to the EDI parser.
+class EdiStreamFramer {
+public:
+    static constexpr size_t AF_HEADER_SIZE = 10;
+    static constexpr size_t MAX_AF_SIZE = 256 * 1024;  // Larger LEN is treated as lost sync
+
+    // Feed raw data; on_packet(const uint8_t* af, size_t len) is called per AF packet
+    template<typename Callback>
+    void feed(const uint8_t* data, size_t len, Callback&& on_packet);
+
+    // Drop buffered bytes (e.g. on reconnect)
+    void reset() {
+        pending_.clear();
+        synced_ = false;
+    }
+
+    // Statistics
+    size_t getPacketCount() const { return packet_count_; }
+    size_t getSyncLossCount() const { return sync_loss_count_; }  // Times the stream had to be re-hunted
+    size_t getSkippedBytes() const { return skipped_bytes_; }
+
+private:
+    // Size of the AF packet at buf (needs AF_HEADER_SIZE bytes), 0 if no valid header
+    static size_t packetSize(const uint8_t* buf) {
+        if (buf[0] != 'A' || buf[1] != 'F' || buf[9] != 'T') return 0;
+        uint32_t tag_len = (static_cast<uint32_t>(buf[2]) << 24) | (buf[3] << 16) | (buf[4] << 8) | buf[5];
+        size_t size = AF_HEADER_SIZE + tag_len + ((buf[8] & 0x80) ? 2 : 0);
+        return size <= MAX_AF_SIZE ? size : 0;
+    }
+
+    // Process a contiguous buffer, returns bytes consumed (rest is carried)
+    template<typename Callback>
+    size_t process(const uint8_t* buf, size_t n, Callback&& on_packet);
+
+    std::vector<uint8_t> pending_;
+    bool synced_{false};
+
+    size_t packet_count_{0};
+    size_t sync_loss_count_{0};
+    size_t skipped_bytes_{0};
+};
+
+template<typename Callback>
+size_t EdiStreamFramer::process(const uint8_t* buf, size_t n, Callback&& on_packet) {
+    size_t pos = 0;
+    while (n - pos >= AF_HEADER_SIZE) {
+        size_t size = packetSize(buf + pos);
+        if (size == 0) {
+            if (synced_) {
+                synced_ = false;
+                sync_loss_count_++;
+            }
+            // Hunt for the next "AF"
+            const void* next = std::memchr(buf + pos + 1, 'A', n - pos - 1);
+            size_t next_pos = next ? static_cast<size_t>(static_cast<const uint8_t*>(next) - buf) : n;
+            skipped_bytes_ += next_pos - pos;
+            pos = next_pos;
+            continue;
+        }
+        if (n - pos < size) break;  // Incomplete packet
+
+        synced_ = true;
+        packet_count_++;
+        on_packet(buf + pos, size);
+        pos += size;
+    }
+    return pos;
+}
+
+template<typename Callback>
+void EdiStreamFramer::feed(const uint8_t* data, size_t len, Callback&& on_packet) {
+    // Complete the carried header / packet first
+    while (!pending_.empty()) {
+        if (len == 0) return;
+        size_t need = pending_.size() < AF_HEADER_SIZE ? AF_HEADER_SIZE : packetSize(pending_.data());
+        size_t take = need > pending_.size() ? need - pending_.size() : 0;
+        if (take > len) take = len;
+        pending_.insert(pending_.end(), data, data + take);
+        data += take;
+        len -= take;
+        if (pending_.size() < need) return;  // Input used up
+
+        size_t used = process(pending_.data(), pending_.size(), on_packet);
+        pending_.erase(pending_.begin(), pending_.begin() + used);
+    }
+
+    size_t used = process(data, len, on_packet);
+    pending_.assign(data + used, data + len);
+}
+
+} // namespace dvbdab
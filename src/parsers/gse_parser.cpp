@@ -14,10 +14,71 @@ void GseParser::reset() {
     synced_ = false;
     for (auto& frag : fragments_) {
         frag.active = false;
+        frag.ignored = false;
         frag.data.clear();
     }
+    last_label_len_ = 0;
     packet_count_ = 0;
     fragment_count_ = 0;
+    filtered_packet_count_ = 0;
+    filtered_bytes_ = 0;
+}
+
+void GseParser::setLabelFilter(const uint8_t* label, size_t len) {
+    if (!label || (len != 3 && len != 6)) {
+        filter_label_len_ = 0;
+        return;
+    }
+    std::memcpy(filter_label_.data(), label, len);
+    filter_label_len_ = len;
+}
+
+bool GseParser::passesFilter(uint8_t lt, const uint8_t* label, uint16_t protocol,
+                             const uint8_t* pdu, size_t pdu_len) {
+    // Label (LT=3 re-uses the previous label of this stream)
+    if (lt <= 1) {
+        last_label_len_ = (lt == 0) ? 6 : 3;
+        std::memcpy(last_label_.data(), label, last_label_len_);
+    }
+    if (filter_label_len_ > 0 && lt != 2) {
+        if (lt == 3 && last_label_len_ == 0) {
+            return true;  // Unknown label - can't decide
+        }
+        if (last_label_len_ != filter_label_len_ ||
+            std::memcmp(last_label_.data(), filter_label_.data(), filter_label_len_) != 0) {
+            return false;
+        }
+    }
+
+    if (filter_ip_ == 0 && filter_port_ == 0) {
+        return true;
+    }
+
+    // Only IPv4 can match an IP filter
+    if (protocol != 0x0800) {
+        return false;
+    }
+    if (pdu_len < 20 || (pdu[0] >> 4) != 4) {
+        return true;  // Not enough of the header yet - let reassembly decide
+    }
+
+    uint32_t dst_ip = (static_cast<uint32_t>(pdu[16]) << 24) | (pdu[17] << 16) |
+                      (pdu[18] << 8) | pdu[19];
+    if (filter_ip_ != 0 && dst_ip != filter_ip_) {
+        return false;
+    }
+
+    // UDP port (IPv4 non-first fragments carry no UDP header)
+    if (filter_port_ != 0 && pdu[9] == 17 && ((pdu[6] & 0x1F) | pdu[7]) == 0) {
+        size_t ip_hdr_len = (pdu[0] & 0x0F) * 4;
+        if (ip_hdr_len + 4 <= pdu_len) {
+            uint16_t dst_port = (pdu[ip_hdr_len + 2] << 8) | pdu[ip_hdr_len + 3];
+            if (dst_port != filter_port_) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
 void GseParser::feedTsPayload(const uint8_t* data, size_t len) {
@@ -258,8 +319,21 @@ bool GseParser::processGsePacket(const uint8_t* data, size_t len, size_t& consum
     bool start = (gse_header >> 7) & 1;
     bool stop = (gse_header >> 6) & 1;
 
+    uint8_t lt = (gse_header >> 4) & 3;
+    size_t label_len = (lt == 0) ? 6 : (lt == 1) ? 3 : 0;
+
     if (start && stop) {
         // Complete GSE packet in one piece (S=1, E=1)
+        // Format: Protocol(2) + [Label] + PDU
+        if (gse_len >= 2 + label_len) {
+            uint16_t protocol = (static_cast<uint16_t>(data[2]) << 8) | data[3];
+            if (!passesFilter(lt, data + 4, protocol, data + 4 + label_len, gse_len - 2 - label_len)) {
+                filtered_packet_count_++;
+                filtered_bytes_ += consumed;
+                return true;
+            }
+        }
+
         // Payload starts at byte 2
         packet_count_++;
         handleCompleteGsePayload(data + 2, gse_len);
@@ -267,36 +341,37 @@ bool GseParser::processGsePacket(const uint8_t* data, size_t len, size_t& consum
     else if (start && !stop) {
         // First fragment (S=1, E=0)
         // Format: FragID(1) + TotalLength(2) + Protocol(2) + [Label] + Data
-        if (gse_len < 7) return true;  // Need FragID + TotalLen + Protocol
+        if (gse_len < 5 + label_len) return true;  // Need FragID + TotalLen + Protocol + Label
 
         uint8_t frag_id = data[2];
         uint16_t total_len = (static_cast<uint16_t>(data[3]) << 8) | data[4];
+        auto& frag = fragments_[frag_id];
 
-        // Determine label length based on LT
-        uint8_t lt = (gse_header >> 4) & 3;
-        size_t label_len = (lt == 0) ? 6 : (lt == 1) ? 3 : 0;
-
-        // Check if this is IPv4 (protocol 0x0800)
-        size_t proto_offset = 5 + label_len;
-        if (proto_offset + 2 > gse_len + 2) return true;
-
-        uint16_t protocol = (static_cast<uint16_t>(data[proto_offset]) << 8) | data[proto_offset + 1];
-
-        // Only process IPv4 fragments, skip others
-        if (protocol != 0x0800) {
-            return true;  // Not IPv4, skip
+        uint16_t protocol = (static_cast<uint16_t>(data[5]) << 8) | data[6];
+
+        // Only process IPv4 fragments (matching the filter), skip the rest
+        // of the PDU without copying otherwise
+        if (protocol != 0x0800 ||
+            !passesFilter(lt, data + 7, protocol, data + 7 + label_len, gse_len - 5 - label_len)) {
+            frag.active = false;
+            frag.ignored = true;
+            filtered_packet_count_++;
+            filtered_bytes_ += consumed;
+            return true;
         }
 
         // For IPv4, sanity check the total length (max ~1500 for UDP)
         if (total_len > 2000 || total_len < 28) {
+            frag.active = false;
+            frag.ignored = false;
             return true;  // Unreasonable IPv4 size
         }
 
-        auto& frag = fragments_[frag_id];
         frag.data.resize(total_len + 2);  // +2 for reconstructed GSE header
         frag.total_length = total_len + 2;
         frag.current_pos = 0;
         frag.active = true;
+        frag.ignored = false;
 
         // Reconstruct header with S=1, E=1
         frag.data[0] = (gse_header | 0xC0);  // Set both S and E bits
@@ -320,6 +395,10 @@ bool GseParser::processGsePacket(const uint8_t* data, size_t len, size_t& consum
 
         uint8_t frag_id = data[2];
         auto& frag = fragments_[frag_id];
+        if (frag.ignored) {
+            filtered_bytes_ += consumed;
+            return true;
+        }
         if (!frag.active) return true;
 
         size_t payload_len = gse_len - 1;  // -1 for FragID
@@ -337,6 +416,11 @@ bool GseParser::processGsePacket(const uint8_t* data, size_t len, size_t& consum
 
         uint8_t frag_id = data[2];
         auto& frag = fragments_[frag_id];
+        if (frag.ignored) {
+            filtered_bytes_ += consumed;
+            frag.ignored = false;
+            return true;
+        }
         if (!frag.active) return true;
 
         size_t payload_len = gse_len - 5;  // -1 for FragID, -4 for CRC
@@ -14,6 +14,7 @@ struct GseFragment {
     size_t total_length{0};
     size_t current_pos{0};
     bool active{false};
+    bool ignored{false};  // First fragment filtered - skip rest of this PDU
 };
 
 // GSE (Generic Stream Encapsulation) Parser
@@ -32,6 +33,12 @@ struct GseFragment {
 //   S=0,E=0: Middle fragment (includes FragID)
 //   S=0,E=1: Last fragment (includes FragID + CRC32)
 //
+// Early filtering:
+//   An optional label filter and IPv4 destination filter are applied to
+//   complete packets and to the first fragment of a PDU, before anything is
+//   copied. Fragment IDs of filtered PDUs are marked ignored, so their middle
+//   and last fragments are skipped without reassembly.
+//
 // TS boundary handling:
 //   GSE packets may span multiple TS packets, but padding at the end
 //   of a TS payload signals that the next GSE packet starts at the
@@ -57,9 +64,18 @@ public:
     // Reset parser state
     void reset();
 
+    // Only pass IPv4 packets to dst_ip:dst_port (0 = any, for either field)
+    void setIpFilter(uint32_t dst_ip, uint16_t dst_port) { filter_ip_ = dst_ip; filter_port_ = dst_port; }
+
+    // Only pass PDUs with this 6-byte (LT=0) or 3-byte (LT=1) label.
+    // Broadcast (LT=2) PDUs always pass. nullptr/0 = no label filter.
+    void setLabelFilter(const uint8_t* label, size_t len);
+
     // Statistics
     size_t getPacketCount() const { return packet_count_; }
     size_t getFragmentCount() const { return fragment_count_; }
+    size_t getFilteredPacketCount() const { return filtered_packet_count_; }  // PDUs dropped by filter
+    size_t getFilteredBytes() const { return filtered_bytes_; }              // GSE bytes skipped by filter
 
 private:
     // Find sync point (first valid GSE packet)
@@ -76,6 +92,10 @@ private:
     // Extract and emit IPv4 packet from GSE payload
     void emitIpv4Packet(const uint8_t* ip_data, size_t len);
 
+    // Early filter on label + start of PDU (protocol, IPv4 header)
+    bool passesFilter(uint8_t lt, const uint8_t* label, uint16_t protocol,
+                      const uint8_t* pdu, size_t pdu_len);
+
     IpPacketCallback callback_;
 
     // Accumulation buffer for partial GSE packets
@@ -87,9 +107,19 @@ private:
     // Fragment reassembly buffers (indexed by fragment ID 0-255)
     std::array<GseFragment, GSE_FRAGMENT_ID_COUNT> fragments_;
 
+    // Early filter
+    uint32_t filter_ip_{0};      // 0 = no filter
+    uint16_t filter_port_{0};    // 0 = no filter
+    std::array<uint8_t, 6> filter_label_{};
+    size_t filter_label_len_{0};  // 0 = no label filter
+    std::array<uint8_t, 6> last_label_{};  // For label re-use (LT=3)
+    size_t last_label_len_{0};
+
     // Statistics
     size_t packet_count_{0};
     size_t fragment_count_{0};
+    size_t filtered_packet_count_{0};
+    size_t filtered_bytes_{0};
 };
 
 } // namespace dvbdab
@@ -0,0 +1,208 @@
+#include "ipv4_reassembler.hpp"
+#include <cstring>
+
+namespace dvbdab {
+
+Ipv4Reassembler::Ipv4Reassembler(IpPacketCallback callback, size_t max_datagrams,
+                                 unsigned int timeout_ms)
+    : callback_(std::move(callback))
+    , pool_(max_datagrams > 0 ? max_datagrams : 1)
+    , timeout_ms_(timeout_ms)
+{
+    for (auto& dg : pool_) {
+        dg.ranges.reserve(8);
+    }
+}
+
+void Ipv4Reassembler::reset() {
+    for (auto& dg : pool_) {
+        dg.in_use = false;
+    }
+    fragment_count_ = 0;
+    reassembled_count_ = 0;
+    timeout_count_ = 0;
+    evicted_count_ = 0;
+    overlap_count_ = 0;
+    duplicate_count_ = 0;
+    invalid_count_ = 0;
+}
+
+size_t Ipv4Reassembler::getPendingCount() const {
+    size_t count = 0;
+    for (const auto& dg : pool_) {
+        if (dg.in_use) count++;
+    }
+    return count;
+}
+
+void Ipv4Reassembler::process(const uint8_t* ip_packet, size_t len, const Clock& clock) {
+    // Fast path: complete datagram, no copy
+    if (!isIpv4Fragment(ip_packet, len)) {
+        callback_(ip_packet, len);
+        return;
+    }
+
+    fragment_count_++;
+
+    size_t hdr_len = (ip_packet[0] & 0x0F) * 4;
+    size_t total_len = (static_cast<size_t>(ip_packet[2]) << 8) | ip_packet[3];
+    if (hdr_len < 20 || total_len <= hdr_len || total_len > len) {
+        invalid_count_++;
+        return;
+    }
+
+    bool more_fragments = (ip_packet[6] & 0x20) != 0;
+    size_t offset = ((static_cast<size_t>(ip_packet[6] & 0x1F) << 8) | ip_packet[7]) * 8;
+    size_t frag_len = total_len - hdr_len;
+    size_t end = offset + frag_len;
+
+    // Non-last fragments carry a multiple of 8 bytes; datagram must fit in 64K
+    if ((more_fragments && (frag_len % 8) != 0) || end > MAX_PAYLOAD || hdr_len + end > 65535) {
+        invalid_count_++;
+        return;
+    }
+
+    uint64_t now_ms = clock.elapsedMs();
+    expire(now_ms);
+
+    uint32_t src = (static_cast<uint32_t>(ip_packet[12]) << 24) | (ip_packet[13] << 16) |
+                   (ip_packet[14] << 8) | ip_packet[15];
+    uint32_t dst = (static_cast<uint32_t>(ip_packet[16]) << 24) | (ip_packet[17] << 16) |
+                   (ip_packet[18] << 8) | ip_packet[19];
+    uint16_t id = (ip_packet[4] << 8) | ip_packet[5];
+    uint8_t proto = ip_packet[9];
+
+    Datagram* dg = find(src, dst, id, proto);
+    if (!dg) {
+        dg = &allocate(now_ms);
+        dg->src = src;
+        dg->dst = dst;
+        dg->id = id;
+        dg->proto = proto;
+    }
+
+    // Duplicates are ignored, any other overlap drops the datagram
+    for (const auto& r : dg->ranges) {
+        if (r.first == offset && r.second == end) {
+            duplicate_count_++;
+            return;
+        }
+        if (offset < r.second && r.first < end) {
+            overlap_count_++;
+            dg->in_use = false;
+            return;
+        }
+    }
+
+    // Last fragment fixes the datagram length; everything must fit inside it
+    if (!more_fragments) {
+        if (dg->total_len != 0 && dg->total_len != end) {
+            overlap_count_++;
+            dg->in_use = false;
+            return;
+        }
+        for (const auto& r : dg->ranges) {
+            if (r.second > end) {
+                overlap_count_++;
+                dg->in_use = false;
+                return;
+            }
+        }
+        dg->total_len = end;
+    } else if (dg->total_len != 0 && end > dg->total_len) {
+        overlap_count_++;
+        dg->in_use = false;
+        return;
+    }
+
+    if (dg->buffer.size() < MAX_HEADER + end) {
+        dg->buffer.resize(MAX_HEADER + end);
+    }
+    std::memcpy(dg->buffer.data() + MAX_HEADER + offset, ip_packet + hdr_len, frag_len);
+    dg->ranges.emplace_back(static_cast<uint16_t>(offset), static_cast<uint16_t>(end));
+    dg->received += frag_len;
+
+    if (offset == 0) {
+        std::memcpy(dg->header, ip_packet, hdr_len);
+        dg->header_len = hdr_len;
+    }
+
+    if (dg->total_len != 0 && dg->received == dg->total_len) {
+        emit(*dg);
+    }
+}
+
+Ipv4Reassembler::Datagram* Ipv4Reassembler::find(uint32_t src, uint32_t dst, uint16_t id, uint8_t proto) {
+    for (auto& dg : pool_) {
+        if (dg.in_use && dg.id == id && dg.src == src && dg.dst == dst && dg.proto == proto) {
+            return &dg;
+        }
+    }
+    return nullptr;
+}
+
+Ipv4Reassembler::Datagram& Ipv4Reassembler::allocate(uint64_t now_ms) {
+    Datagram* slot = nullptr;
+    for (auto& dg : pool_) {
+        if (!dg.in_use) {
+            slot = &dg;
+            break;
+        }
+        if (!slot || dg.first_seen_ms < slot->first_seen_ms) {
+            slot = &dg;
+        }
+    }
+    if (slot->in_use) {
+        evicted_count_++;  // Pool full - drop the oldest datagram
+    }
+
+    slot->in_use = true;
+    slot->first_seen_ms = now_ms;
+    slot->header_len = 0;
+    slot->total_len = 0;
+    slot->received = 0;
+    slot->ranges.clear();
+    return *slot;
+}
+
+void Ipv4Reassembler::expire(uint64_t now_ms) {
+    for (auto& dg : pool_) {
+        if (dg.in_use && now_ms - dg.first_seen_ms > timeout_ms_) {
+            dg.in_use = false;
+            timeout_count_++;
+        }
+    }
+}
+
+void Ipv4Reassembler::emit(Datagram& dg) {
+    dg.in_use = false;
+
+    // Place the first fragment's header directly before the payload
+    uint8_t* packet = dg.buffer.data() + MAX_HEADER - dg.header_len;
+    std::memcpy(packet, dg.header, dg.header_len);
+
+    size_t packet_len = dg.header_len + dg.total_len;
+    packet[2] = static_cast<uint8_t>(packet_len >> 8);
+    packet[3] = static_cast<uint8_t>(packet_len);
+    packet[6] &= 0x40;  // Keep DF, clear MF and offset
+    packet[7] = 0;
+
+    // Recompute header checksum
+    packet[10] = 0;
+    packet[11] = 0;
+    uint32_t sum = 0;
+    for (size_t i = 0; i < dg.header_len; i += 2) {
+        sum += (packet[i] << 8) | packet[i + 1];
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    uint16_t checksum = static_cast<uint16_t>(~sum);
+    packet[10] = static_cast<uint8_t>(checksum >> 8);
+    packet[11] = static_cast<uint8_t>(checksum);
+
+    reassembled_count_++;
+    callback_(packet, packet_len);
+}
+
+} // namespace dvbdab
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <dvbdab/dvbdab.hpp>
+#include "../clock.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace dvbdab {
+
+// Check IPv4 header for MF flag or non-zero fragment offset
+inline bool isIpv4Fragment(const uint8_t* ip_packet, size_t len) {
+    if (len < 20 || (ip_packet[0] >> 4) != 4) return false;
+    return ((ip_packet[6] & 0x3F) | ip_packet[7]) != 0;
+}
+
+// IPv4 fragment reassembly
+//
+// Some EDI encoders send AF packets larger than the MTU without PFT; the
+// resulting IPv4 fragments are collected here, keyed by (src, dst, id, proto),
+// and the complete datagram is emitted as one IPv4 packet (header of the first
+// fragment with MF/offset cleared and total length fixed up).
+//
+// Unfragmented packets are passed through to the callback unchanged (no copy).
+// Reassembly uses a fixed pool of datagram slots whose buffers are reused, so
+// steady-state operation does not allocate. When the pool is full the oldest
+// datagram is evicted. Overlapping fragments drop the datagram (exact
+// duplicates are ignored), as in the Linux IPv4 stack. Timeouts run on the
+// caller's Clock, so a scan in media time expires fragments in stream time.
+class Ipv4Reassembler {
+public:
+    static constexpr size_t DEFAULT_MAX_DATAGRAMS = 16;
+    static constexpr unsigned int DEFAULT_TIMEOUT_MS = 1000;
+
+    explicit Ipv4Reassembler(IpPacketCallback callback,
+                             size_t max_datagrams = DEFAULT_MAX_DATAGRAMS,
+                             unsigned int timeout_ms = DEFAULT_TIMEOUT_MS);
+
+    // Process an IPv4 packet (fragment or complete datagram); the clock is
+    // only read for fragments
+    void process(const uint8_t* ip_packet, size_t len, const Clock& clock);
+
+    // Incomplete datagrams older than this are discarded
+    void setTimeout(unsigned int timeout_ms) { timeout_ms_ = timeout_ms; }
+
+    // Drop all pending fragments and reset statistics
+    void reset();
+
+    // Statistics
+    size_t getFragmentCount() const { return fragment_count_; }        // Fragments received
+    size_t getReassembledCount() const { return reassembled_count_; }  // Datagrams completed
+    size_t getTimeoutCount() const { return timeout_count_; }          // Datagrams expired incomplete
+    size_t getEvictedCount() const { return evicted_count_; }          // Datagrams dropped (pool full)
+    size_t getOverlapCount() const { return overlap_count_; }          // Datagrams dropped on overlap
+    size_t getDuplicateCount() const { return duplicate_count_; }      // Duplicate fragments ignored
+    size_t getInvalidCount() const { return invalid_count_; }          // Malformed/oversized fragments
+    size_t getPendingCount() const;                                    // Datagrams being reassembled
+
+private:
+    // Room for the largest IPv4 header in front of the payload, so the header
+    // can be placed directly before the data on completion
+    static constexpr size_t MAX_HEADER = 60;
+    static constexpr size_t MAX_PAYLOAD = 65535 - 20;
+
+    struct Datagram {
+        bool in_use{false};
+        uint32_t src{0};
+        uint32_t dst{0};
+        uint16_t id{0};
+        uint8_t proto{0};
+        uint64_t first_seen_ms{0};
+
+        std::vector<uint8_t> buffer;  // MAX_HEADER bytes + payload (reused)
+        uint8_t header[MAX_HEADER];   // Header of offset-0 fragment
+        size_t header_len{0};         // 0 = first fragment not yet received
+        size_t total_len{0};          // Payload length, 0 = last fragment not yet received
+        size_t received{0};           // Payload bytes received
+        std::vector<std::pair<uint16_t, uint16_t>> ranges;  // Received [start, end) (reused)
+    };
+
+    Datagram* find(uint32_t src, uint32_t dst, uint16_t id, uint8_t proto);
+    Datagram& allocate(uint64_t now_ms);
+    void expire(uint64_t now_ms);
+    void emit(Datagram& dg);
+
+    IpPacketCallback callback_;
+    std::vector<Datagram> pool_;
+    uint64_t timeout_ms_;
+
+    size_t fragment_count_{0};
+    size_t reassembled_count_{0};
+    size_t timeout_count_{0};
+    size_t evicted_count_{0};
+    size_t overlap_count_{0};
+    size_t duplicate_count_{0};
+    size_t invalid_count_{0};
+};
+
+} // namespace dvbdab
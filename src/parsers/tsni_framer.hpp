@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace dvbdab {
+
+// ETI-NI framing for TS NI V.11 (satellite DAB distribution)
+//
+// Each ETI-NI frame is carried in a section-like unit starting at PUSI:
+// pointer_field (0), then the frame without its FSYNC word. The first byte
+// (the "table_id") counts up by one per frame. A frame is complete when the
+// next PUSI arrives; the FSYNC word is restored from the parity of that
+// first byte (ff 07 3a b6 even, ff f8 c5 49 odd) and the frame is padded to
+// FRAME_SIZE with 0x55. Frames are assembled in place behind a reserved
+// FSYNC slot, so emitting one does not copy.
+//
+// The stream counts as confirmed once SEQ_THRESHOLD consecutive PUSIs carry
+// pointer_field 0 and an incrementing sequence byte.
+class TsniFramer {
+public:
+    static constexpr size_t FRAME_SIZE = 6140;
+    static constexpr int SEQ_THRESHOLD = 4;
+
+    TsniFramer() {
+        buffer_.reserve(FRAME_SIZE + 188);
+    }
+
+    // Feed one TS payload; on_frame(const uint8_t* eti, size_t len) is called
+    // per complete ETI-NI frame
+    template<typename Callback>
+    void feedPayload(const uint8_t* payload, size_t len, bool pusi, Callback&& on_frame);
+
+    // Drop the frame being collected (e.g. on data loss)
+    void clearFrame() { buffer_.clear(); }
+
+    // Drop all state including confirmation
+    void reset() {
+        buffer_.clear();
+        last_seq_ = -1;
+        seq_count_ = 0;
+        confirmed_ = false;
+    }
+
+    bool isConfirmed() const { return confirmed_; }
+
+    // Statistics
+    size_t getPusiCount() const { return pusi_count_; }
+    size_t getFrameCount() const { return frame_count_; }
+
+private:
+    static constexpr size_t SYNC_SIZE = 4;
+
+    void checkSequence(const uint8_t* payload) {
+        if (payload[0] != 0) {
+            seq_count_ = 0;
+            last_seq_ = -1;
+            return;
+        }
+        uint8_t seq = payload[1];
+        if (last_seq_ >= 0 && seq == static_cast<uint8_t>(last_seq_ + 1)) {
+            if (++seq_count_ >= SEQ_THRESHOLD) confirmed_ = true;
+        } else {
+            seq_count_ = 0;
+        }
+        last_seq_ = seq;
+    }
+
+    std::vector<uint8_t> buffer_;  // FSYNC slot + frame being collected, empty = waiting for PUSI
+    int last_seq_{-1};
+    int seq_count_{0};
+    bool confirmed_{false};
+
+    size_t pusi_count_{0};
+    size_t frame_count_{0};
+};
+
+template<typename Callback>
+void TsniFramer::feedPayload(const uint8_t* payload, size_t len, bool pusi, Callback&& on_frame) {
+    if (pusi && len > 1) {
+        pusi_count_++;
+        checkSequence(payload);
+
+        // Frame boundary - output the previous frame (at least FSYNC-sized)
+        if (buffer_.size() >= 2 * SYNC_SIZE) {
+            static const uint8_t SYNC_EVEN[SYNC_SIZE] = {0xff, 0x07, 0x3a, 0xb6};
+            static const uint8_t SYNC_ODD[SYNC_SIZE] = {0xff, 0xf8, 0xc5, 0x49};
+            std::memcpy(buffer_.data(), (buffer_[SYNC_SIZE] % 2 == 0) ? SYNC_EVEN : SYNC_ODD, SYNC_SIZE);
+            if (buffer_.size() < FRAME_SIZE) {
+                buffer_.resize(FRAME_SIZE, 0x55);
+            }
+            frame_count_++;
+            on_frame(buffer_.data(), buffer_.size());
+        }
+
+        // Start a new frame - skip pointer_field (byte 0)
+        buffer_.resize(SYNC_SIZE);
+        buffer_.insert(buffer_.end(), payload + 1, payload + len);
+    } else if (!buffer_.empty()) {
+        buffer_.insert(buffer_.end(), payload, payload + len);
+    }
+}
+
+} // namespace dvbdab
@@ -4,18 +4,30 @@ namespace dvbdab {
 
 UdpExtractor::UdpExtractor(UdpPacketCallback callback)
     : callback_(std::move(callback))
+    , reassembler_([this](const uint8_t* ip_packet, size_t len) {
+          extract(ip_packet, len);
+      })
 {
 }
 
 void UdpExtractor::reset() {
+    reassembler_.reset();
     ip_packet_count_ = 0;
     udp_packet_count_ = 0;
     non_udp_count_ = 0;
 }
 
-void UdpExtractor::process(const uint8_t* ip_packet, size_t len) {
+void UdpExtractor::process(const uint8_t* ip_packet, size_t len, const Clock& clock) {
     ip_packet_count_++;
 
+    if (isIpv4Fragment(ip_packet, len)) {
+        reassembler_.process(ip_packet, len, clock);  // Calls extract() once complete
+        return;
+    }
+    extract(ip_packet, len);
+}
+
+void UdpExtractor::extract(const uint8_t* ip_packet, size_t len) {
     uint32_t dst_ip;
     uint16_t dst_port;
     const uint8_t* payload;
@@ -42,6 +54,9 @@ bool extractUdpFromIpv4(const uint8_t* ip_packet, size_t len,
     // Check protocol (17 = UDP)
     if (ip_packet[9] != 17) return false;
 
+    // Fragments must go through Ipv4Reassembler first
+    if (isIpv4Fragment(ip_packet, len)) return false;
+
     // Extract destination IP (bytes 16-19, big-endian)
     dst_ip = (ip_packet[16] << 24) | (ip_packet[17] << 16) | (ip_packet[18] << 8) | ip_packet[19];
 
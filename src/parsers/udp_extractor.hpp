@@ -1,6 +1,7 @@
 #pragma once
 
 #include <dvbdab/dvbdab.hpp>
+#include "ipv4_reassembler.hpp"
 #include <cstdint>
 #include <functional>
 
@@ -8,24 +9,33 @@ namespace dvbdab {
 
 // UDP Extractor - shared component that extracts UDP payloads from IPv4 packets
 // All input sources converge at IPv4 level, this extracts (dst_ip, dst_port, payload)
-// for routing to per-ensemble EDI parsers
+// for routing to per-ensemble EDI parsers.
+// IPv4 fragments are reassembled first; unfragmented packets are not copied.
 class UdpExtractor {
 public:
     explicit UdpExtractor(UdpPacketCallback callback);
 
     // Process an IPv4 packet, extract UDP payload and emit via callback
-    void process(const uint8_t* ip_packet, size_t len);
+    // (clock: time base for fragment timeouts)
+    void process(const uint8_t* ip_packet, size_t len, const Clock& clock);
 
-    // Reset statistics
+    // Reset statistics (and drop pending fragments)
     void reset();
 
+    // Fragment reassembly stage (timeout, statistics)
+    Ipv4Reassembler& getReassembler() { return reassembler_; }
+    const Ipv4Reassembler& getReassembler() const { return reassembler_; }
+
     // Statistics
     size_t getIpPacketCount() const { return ip_packet_count_; }
     size_t getUdpPacketCount() const { return udp_packet_count_; }
     size_t getNonUdpCount() const { return non_udp_count_; }
 
 private:
+    void extract(const uint8_t* ip_packet, size_t len);
+
     UdpPacketCallback callback_;
+    Ipv4Reassembler reassembler_;
 
     size_t ip_packet_count_{0};
     size_t udp_packet_count_{0};
@@ -33,7 +43,7 @@ private:
 };
 
 // Standalone function for simple extraction without callback management
-// Returns true if UDP was successfully extracted
+// Returns true if UDP was successfully extracted (false for IPv4 fragments)
 // Fills dst_ip, dst_port, payload_ptr, payload_len on success
 bool extractUdpFromIpv4(const uint8_t* ip_packet, size_t len,
                         uint32_t& dst_ip, uint16_t& dst_port,
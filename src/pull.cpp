@@ -0,0 +1,370 @@
+// Pull API: generators driven by the consumer
+
+#include <dvbdab/pull.hpp>
+#include "sources/gse_ts_source.hpp"
+#include "sources/bbf_ts_source.hpp"
+#include "sources/mpe_ts_source.hpp"
+#include "parsers/udp_extractor.hpp"
+#include "output/dabplus_decoder.hpp"
+#include "output/dab_mp2_decoder.hpp"
+#include "ensemble_manager.hpp"
+#include "clock.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <unistd.h>
+
+namespace dvbdab {
+
+namespace {
+
+DiscoveredEnsemble toDiscovered(const StreamKey& key, const lsdvb::DABEnsemble& ens, EnsembleFormat format) {
+    DiscoveredEnsemble de;
+    de.ip = key.ip;
+    de.port = key.port;
+    de.eid = ens.eid;
+    de.label = ens.label;
+    de.format = format;
+    for (const auto& svc : ens.services) {
+        DiscoveredService ds;
+        ds.sid = svc.sid;
+        ds.label = svc.label;
+        ds.bitrate = svc.bitrate;
+        ds.subchannel_id = static_cast<uint8_t>(svc.subchannel_id);
+        ds.dabplus = svc.dabplus;
+        de.services.push_back(ds);
+    }
+    return de;
+}
+
+// Keeps a consumer count up while a generator is alive
+struct ConsumerGuard {
+    int& count;
+    explicit ConsumerGuard(int& c) : count(c) { count++; }
+    ~ConsumerGuard() { count--; }
+};
+
+} // namespace
+
+struct PullSource::Impl {
+    ReadFunction read;
+    std::vector<uint8_t> read_buf;
+    std::unique_ptr<InputSource> input;
+    EnsembleFormat ensemble_format{EnsembleFormat::MPE};
+    UdpExtractor udp_extractor;
+    Clock clock;  // Wall time for fragment timeouts
+    EnsembleManager manager;
+    std::optional<StreamKey> stream;
+    bool eof{false};
+    size_t bytes_read{0};
+
+    // ETI frames produced by the last read (only queued while frames() runs)
+    struct Frame {
+        StreamKey key;
+        uint16_t dflc;
+        size_t len;
+        std::unique_ptr<uint8_t[]> buf;
+    };
+    std::deque<Frame> frames;
+    std::vector<std::unique_ptr<uint8_t[]>> pool;
+    int frame_consumers{0};
+
+    // Ensemble events (only queued while ensembleEvents() runs)
+    std::deque<EnsembleEvent> events;
+    int event_consumers{0};
+
+    // Latest ensemble per stream; generation changes on every update
+    std::map<StreamKey, lsdvb::DABEnsemble> ensembles;
+    uint64_t ensemble_generation{0};
+
+    Impl(ReadFunction read_fn, InputFormat format, uint16_t pid, size_t read_size)
+        : read(std::move(read_fn))
+        , read_buf(read_size > 0 ? read_size : DEFAULT_READ_SIZE)
+        , udp_extractor([this](uint32_t ip, uint16_t port, const uint8_t* payload, size_t len) {
+              manager.processUdp(ip, port, payload, len);
+          })
+    {
+        switch (format) {
+            case InputFormat::GSE:
+                input = std::make_unique<GseTsSource>();
+                ensemble_format = EnsembleFormat::GSE;
+                break;
+            case InputFormat::BBF:
+                input = std::make_unique<BbfTsSource>();
+                ensemble_format = EnsembleFormat::BBF;
+                break;
+            case InputFormat::MPE:
+                input = std::make_unique<MpeTsSource>(pid);
+                break;
+        }
+        input->setIpCallback([this](const uint8_t* ip_data, size_t len) {
+            udp_extractor.process(ip_data, len, clock);
+        });
+
+        manager.setEtiCallback([this](const StreamKey& key, const uint8_t* data, size_t len, uint16_t dflc) {
+            if (frame_consumers == 0 || !wanted(key)) return;
+            Frame frame{key, dflc, std::min(len, ETI_FRAME_SIZE), nullptr};
+            if (pool.empty()) {
+                frame.buf = std::make_unique_for_overwrite<uint8_t[]>(ETI_FRAME_SIZE);
+            } else {
+                frame.buf = std::move(pool.back());
+                pool.pop_back();
+            }
+            std::memcpy(frame.buf.get(), data, frame.len);
+            frames.push_back(std::move(frame));
+        });
+        manager.setBasicReadyCallback([this](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
+            update(key, ens, EnsembleEvent::Type::BasicReady);
+        });
+        manager.setCompleteCallback([this](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
+            update(key, ens, EnsembleEvent::Type::Complete);
+        });
+        manager.setSubchannelChangeCallback([this](const StreamKey& key, const std::vector<SubchannelChange>&) {
+            auto all = manager.getAllEnsembles();
+            auto it = all.find(key);
+            if (it != all.end()) {
+                update(key, it->second, EnsembleEvent::Type::Reconfigured);
+            }
+        });
+    }
+
+    bool wanted(const StreamKey& key) const {
+        return !stream || *stream == key;
+    }
+
+    void update(const StreamKey& key, const lsdvb::DABEnsemble& ens, EnsembleEvent::Type type) {
+        ensembles[key] = ens;
+        ensemble_generation++;
+        if (event_consumers > 0 && wanted(key)) {
+            events.push_back({type, toDiscovered(key, ens, ensemble_format)});
+        }
+    }
+
+    // Read and process one block. Returns false once the input is exhausted.
+    bool pump() {
+        if (eof) return false;
+
+        size_t n = read(read_buf.data(), read_buf.size());
+        if (n == 0) {
+            eof = true;
+            if (auto* bbf = dynamic_cast<BbfTsSource*>(input.get())) {
+                bbf->flush();
+            }
+            return true;  // Flush may have produced output
+        }
+        bytes_read += n;
+        input->feed(read_buf.data(), n);
+        return true;
+    }
+};
+
+PullSource::PullSource(ReadFunction read, InputFormat format, uint16_t pid, size_t read_size)
+    : impl_(std::make_unique<Impl>(std::move(read), format, pid, read_size))
+{
+}
+
+PullSource::~PullSource() = default;
+
+ReadFunction PullSource::fdReader(int fd) {
+    return [fd](uint8_t* buf, size_t len) -> size_t {
+        while (true) {
+            ssize_t n = ::read(fd, buf, len);
+            if (n >= 0) return static_cast<size_t>(n);
+            if (errno != EINTR && errno != EOVERFLOW) return 0;
+        }
+    };
+}
+
+void PullSource::setStream(const StreamKey& stream) {
+    impl_->stream = stream;
+}
+
+void PullSource::subscribeSubchannel(uint8_t subchannel_id, SubchannelCallback callback) {
+    if (!callback) {
+        impl_->manager.unsubscribeSubchannel(subchannel_id);
+        return;
+    }
+    subscribeSubchannel(subchannel_id, [cb = std::move(callback)](const StreamKey& key, uint8_t scid,
+                                                                 const uint8_t* data, size_t len, uint16_t) {
+        cb(key, scid, data, len);
+    });
+}
+
+void PullSource::subscribeSubchannel(uint8_t subchannel_id, SubchannelCifCallback callback) {
+    if (!callback) {
+        impl_->manager.unsubscribeSubchannel(subchannel_id);
+        return;
+    }
+    impl_->manager.subscribeSubchannel(subchannel_id, [this, cb = std::move(callback)](
+            const StreamKey& key, uint8_t scid, const uint8_t* data, size_t len, uint16_t cif_count) {
+        if (impl_->wanted(key)) cb(key, scid, data, len, cif_count);
+    });
+}
+
+void PullSource::unsubscribeSubchannel(uint8_t subchannel_id) {
+    impl_->manager.unsubscribeSubchannel(subchannel_id);
+}
+
+bool PullSource::atEnd() const {
+    return impl_->eof && impl_->frames.empty() && impl_->events.empty();
+}
+
+size_t PullSource::getBytesRead() const {
+    return impl_->bytes_read;
+}
+
+std::generator<const EtiFrameView&> frames(PullSource& source) {
+    PullSource::Impl& impl = *source.impl_;
+    ConsumerGuard guard(impl.frame_consumers);
+
+    while (true) {
+        if (impl.frames.empty()) {
+            if (!impl.pump()) co_return;
+            continue;
+        }
+        PullSource::Impl::Frame frame = std::move(impl.frames.front());
+        impl.frames.pop_front();
+
+        EtiFrameView view{frame.key, {frame.buf.get(), frame.len}, frame.dflc};
+        co_yield view;
+
+        impl.pool.push_back(std::move(frame.buf));
+    }
+}
+
+std::generator<const AudioUnitView&> audioUnits(PullSource& source, uint32_t sid) {
+    PullSource::Impl& impl = *source.impl_;
+
+    // Current decoder for the service (recreated when the subchannel changes)
+    StreamKey key;
+    lsdvb::DABService service{};
+    bool have_service = false;
+    uint64_t generation = ~uint64_t{0};
+    std::unique_ptr<DabPlusDecoder> aac;
+    std::unique_ptr<DabMp2Decoder> mp2;
+    int64_t pts = 90000;
+
+    // AUs of the current ETI frame. AAC AUs point into the decoder's
+    // superframe (stable until the next feed); MP2 frames are copied
+    // because the decoder compacts its buffer after each frame.
+    struct PendingAu {
+        std::array<uint8_t, 16> header;
+        size_t header_len;
+        const uint8_t* data;
+        size_t offset;  // Into mp2_buf when data is null
+        size_t len;
+        int64_t pts;
+    };
+    std::vector<PendingAu> pending;
+    std::vector<uint8_t> mp2_buf;
+
+    for (const EtiFrameView& frame : frames(source)) {
+        // Find the service whenever the ensemble information changed
+        if (impl.ensemble_generation != generation) {
+            generation = impl.ensemble_generation;
+            const lsdvb::DABService* found = nullptr;
+            for (const auto& [k, ens] : impl.ensembles) {
+                if (!impl.wanted(k)) continue;
+                for (const auto& svc : ens.services) {
+                    if (svc.sid == sid) {
+                        key = k;
+                        found = &svc;
+                        break;
+                    }
+                }
+                if (found) break;
+            }
+            if (found && (!have_service || found->subchannel_id != service.subchannel_id ||
+                          found->bitrate != service.bitrate || found->dabplus != service.dabplus)) {
+                service = *found;
+                have_service = true;
+                aac.reset();
+                mp2.reset();
+                if (service.dabplus) {
+                    aac = std::make_unique<DabPlusDecoder>(service.bitrate);
+                    aac->setFrameCallback([&](const uint8_t* header, size_t header_len,
+                                              const uint8_t* au, size_t au_len) {
+                        static const int adts_rates[] = {
+                            96000, 88200, 64000, 48000, 44100, 32000,
+                            24000, 22050, 16000, 12000, 11025, 8000, 7350
+                        };
+                        int sample_rate = 48000;
+                        if (header_len >= 3 && header[0] == 0xFF && (header[1] & 0xF0) == 0xF0) {
+                            int sr_idx = (header[2] >> 2) & 0xF;
+                            if (sr_idx < 13) sample_rate = adts_rates[sr_idx];
+                        }
+                        PendingAu p{};
+                        p.header_len = std::min(header_len, p.header.size());
+                        std::memcpy(p.header.data(), header, p.header_len);
+                        p.data = au;
+                        p.len = au_len;
+                        p.pts = pts;
+                        pending.push_back(p);
+                        pts += (int64_t)1024 * 90000 / sample_rate;
+                    });
+                } else {
+                    mp2 = std::make_unique<DabMp2Decoder>(service.bitrate);
+                    mp2->setCallback([&](const uint8_t* data, size_t len) {
+                        static const int mp2_sample_rates[4][4] = {
+                            {11025, 12000, 8000, 0},   // MPEG2.5
+                            {0, 0, 0, 0},              // Reserved
+                            {22050, 24000, 16000, 0},  // MPEG2
+                            {44100, 48000, 32000, 0}   // MPEG1
+                        };
+                        int sample_rate = 48000;
+                        if (len >= 4 && data[0] == 0xFF && (data[1] & 0xE0) == 0xE0) {
+                            int rate = mp2_sample_rates[(data[1] >> 3) & 0x03][(data[2] >> 2) & 0x03];
+                            if (rate > 0) sample_rate = rate;
+                        }
+                        PendingAu p{};
+                        p.offset = mp2_buf.size();
+                        p.len = len;
+                        p.pts = pts;
+                        mp2_buf.insert(mp2_buf.end(), data, data + len);
+                        pending.push_back(p);
+                        pts += (int64_t)1152 * 90000 / sample_rate;
+                    });
+                }
+            }
+        }
+        if (!have_service || !(frame.stream == key)) continue;
+
+        pending.clear();
+        mp2_buf.clear();
+        forEachEtiSubchannel(frame.data.data(), frame.data.size(),
+                             [&](uint8_t scid, const uint8_t* data, size_t len) {
+            if (scid != service.subchannel_id) return;
+            if (aac) aac->feedFrame(data, len);
+            if (mp2) mp2->feedFrame(data, len);
+        });
+
+        for (const PendingAu& p : pending) {
+            AudioUnitView view{sid, static_cast<uint8_t>(service.subchannel_id), service.dabplus,
+                               {p.header.data(), p.header_len},
+                               {p.data ? p.data : mp2_buf.data() + p.offset, p.len}, p.pts};
+            co_yield view;
+        }
+    }
+}
+
+std::generator<const EnsembleEvent&> ensembleEvents(PullSource& source) {
+    PullSource::Impl& impl = *source.impl_;
+    ConsumerGuard guard(impl.event_consumers);
+
+    while (true) {
+        if (impl.events.empty()) {
+            if (!impl.pump()) co_return;
+            continue;
+        }
+        EnsembleEvent event = std::move(impl.events.front());
+        impl.events.pop_front();
+        co_yield event;
+    }
+}
+
+} // namespace dvbdab
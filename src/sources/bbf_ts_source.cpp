@@ -7,13 +7,12 @@ BbfTsSource::BbfTsSource()
           emitIpPacket(ip_data, len);
       })
 {
-    partial_ts_.reserve(BBF_TS_PACKET_SIZE);
     bbf_buffer_.reserve(8192);
 }
 
 void BbfTsSource::reset() {
     gse_parser_.reset();
-    partial_ts_.clear();
+    ts_sync_.reset();
     bbf_buffer_.clear();
     ts_packet_count_ = 0;
     bbf_frame_count_ = 0;
@@ -21,36 +20,9 @@ void BbfTsSource::reset() {
 }
 
 void BbfTsSource::feed(const uint8_t* data, size_t len) {
-    size_t pos = 0;
-
-    // If we have partial TS packet from previous feed, complete it first
-    if (!partial_ts_.empty()) {
-        size_t needed = BBF_TS_PACKET_SIZE - partial_ts_.size();
-        if (len < needed) {
-            // Still not enough, accumulate and return
-            partial_ts_.insert(partial_ts_.end(), data, data + len);
-            return;
-        }
-
-        // Complete the partial packet
-        partial_ts_.insert(partial_ts_.end(), data, data + needed);
-        pos = needed;
-
-        // Process completed TS packet
-        processTsPacket(partial_ts_.data());
-        partial_ts_.clear();
-    }
-
-    // Process complete TS packets
-    while (pos + BBF_TS_PACKET_SIZE <= len) {
-        processTsPacket(data + pos);
-        pos += BBF_TS_PACKET_SIZE;
-    }
-
-    // Save any remaining partial TS packet
-    if (pos < len) {
-        partial_ts_.assign(data + pos, data + len);
-    }
+    ts_sync_.feed(data, len, [this](const uint8_t* ts_packet) {
+        processTsPacket(ts_packet);
+    });
 }
 
 void BbfTsSource::flush() {
@@ -82,30 +54,35 @@ void BbfTsSource::processTsPacket(const uint8_t* ts_packet) {
     }
 
     ts_packet_count_++;
+    feedPayload(ts_packet + BBF_TS_HEADER_SIZE, BBF_TS_PACKET_SIZE - BBF_TS_HEADER_SIZE);
+}
 
-    // Pseudo-TS format (per pts2bbf.cpp):
-    // ts_packet[0-3]: TS header
-    // ts_packet[4-6]: pseudo-TS header (00 80 00 typically)
-    // ts_packet[7]: payload length
-    // ts_packet[8]: first data byte (0xb8 if BBF start)
-    // ts_packet[9+]: more data
+void BbfTsSource::feedPayload(const uint8_t* payload, size_t len) {
+    // Pseudo-TS format (per pts2bbf.cpp), offsets after the TS header:
+    // payload[0-2]: pseudo-TS header (00 80 00 typically)
+    // payload[3]: payload length
+    // payload[4]: first data byte (0xb8 if BBF start)
+    // payload[5+]: more data
+    if (len < 5) {
+        return;
+    }
 
-    uint8_t length = ts_packet[7];
+    uint8_t length = payload[3];
 
     if (length == 0) {
         return;  // No payload
     }
 
-    if (ts_packet[8] == BBF_SYNC_BYTE) {
+    if (payload[4] == BBF_SYNC_BYTE) {
         // Start of BBF frame - process any previous BBF data first
         if (!bbf_buffer_.empty()) {
             processBbfData();
             bbf_buffer_.clear();
         }
 
-        // Start new BBF frame: output from byte 8, length bytes
-        if (8 + length <= BBF_TS_PACKET_SIZE) {
-            bbf_buffer_.insert(bbf_buffer_.end(), ts_packet + 8, ts_packet + 8 + length);
+        // Start new BBF frame: output from byte 4, length bytes
+        if (4 + static_cast<size_t>(length) <= len) {
+            bbf_buffer_.insert(bbf_buffer_.end(), payload + 4, payload + 4 + length);
         }
         bbf_frame_count_++;
 
@@ -120,9 +97,9 @@ void BbfTsSource::processTsPacket(const uint8_t* ts_packet) {
             }
         }
     } else {
-        // Continuation: output from byte 9, length-1 bytes
-        if (length > 0 && 9 + (length - 1) <= BBF_TS_PACKET_SIZE) {
-            bbf_buffer_.insert(bbf_buffer_.end(), ts_packet + 9, ts_packet + 9 + (length - 1));
+        // Continuation: output from byte 5, length-1 bytes
+        if (5 + static_cast<size_t>(length - 1) <= len) {
+            bbf_buffer_.insert(bbf_buffer_.end(), payload + 5, payload + 5 + (length - 1));
         }
 
         // Check if BBF frame is now complete
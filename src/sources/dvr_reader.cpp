@@ -0,0 +1,160 @@
+#include "dvr_reader.hpp"
+#include "thread_config.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#if defined(__linux__) && __has_include(<linux/dvb/dmx.h>)
+#include <linux/dvb/dmx.h>
+#endif
+
+namespace dvbdab {
+
+DvrReader::DvrReader(int fd, size_t ring_size, size_t dvr_buffer_size)
+    : fd_(fd)
+    , ring_(ring_size >= MAX_READ_SIZE ? ring_size : MAX_READ_SIZE)
+{
+#ifdef DMX_SET_BUFFER_SIZE
+    // Only DVR/demux devices accept this; pipes and files fail with ENOTTY
+    if (dvr_buffer_size > 0 && ioctl(fd_, DMX_SET_BUFFER_SIZE, static_cast<unsigned long>(dvr_buffer_size)) == 0) {
+        dvr_buffer_size_ = dvr_buffer_size;
+    }
+#else
+    (void)dvr_buffer_size;
+#endif
+}
+
+DvrReader::~DvrReader() {
+    stop();
+}
+
+bool DvrReader::start() {
+    if (running_.load() || fd_ < 0) return false;
+
+    reader_done_.store(false);
+    running_.store(true);
+    reader_thread_ = std::thread(&DvrReader::readerThread, this);
+    return true;
+}
+
+void DvrReader::stop() {
+    if (!running_.load()) return;
+
+    running_.store(false);
+    {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        space_cv_.notify_all();
+    }
+    if (reader_thread_.joinable()) {
+        reader_thread_.join();
+    }
+}
+
+bool DvrReader::finished() const {
+    return reader_done_.load() && available() == 0;
+}
+
+void DvrReader::release(size_t len) {
+    read_pos_.fetch_add(len);
+    if (reader_waiting_.load()) {
+        std::lock_guard<std::mutex> lock(wait_mutex_);
+        space_cv_.notify_one();
+    }
+}
+
+void DvrReader::updateRate(size_t bytes, std::chrono::steady_clock::time_point now) {
+    if (rate_bytes_ == 0 && rate_start_ == std::chrono::steady_clock::time_point{}) {
+        rate_start_ = now;
+    }
+    rate_bytes_ += bytes;
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - rate_start_).count();
+    if (elapsed_ms < 1000) return;
+
+    uint64_t rate = static_cast<uint64_t>(rate_bytes_) * 1000 / static_cast<uint64_t>(elapsed_ms);
+    rate_.store(rate, std::memory_order_relaxed);
+    rate_start_ = now;
+    rate_bytes_ = 0;
+
+    // Read about READ_INTERVAL_MS worth of data per syscall, in whole packets
+    size_t target = static_cast<size_t>(rate * READ_INTERVAL_MS / 1000);
+    target = (target + 187) / 188 * 188;
+    read_size_.store(std::clamp(target, MIN_READ_SIZE, MAX_READ_SIZE), std::memory_order_relaxed);
+}
+
+void DvrReader::readerThread() {
+    applyThreadConfig(ThreadRole::DvrReader);
+    bindToRoleNode(ThreadRole::DvrReader, ring_.data(), ring_.size());
+
+    const size_t size = ring_.size();
+    rate_start_ = {};
+    rate_bytes_ = 0;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        size_t wpos = write_pos_.load(std::memory_order_relaxed);
+        size_t used = wpos - read_pos_.load(std::memory_order_acquire);
+
+        // Ring full - wait for the consumer (the kernel buffer keeps filling)
+        if (used == size) {
+            ring_full_count_.fetch_add(1, std::memory_order_relaxed);
+            std::unique_lock<std::mutex> lock(wait_mutex_);
+            reader_waiting_.store(true);
+            space_cv_.wait_for(lock, std::chrono::milliseconds(100), [this, wpos, size] {
+                return wpos - read_pos_.load() < size || !running_.load();
+            });
+            reader_waiting_.store(false);
+            continue;
+        }
+
+        size_t pos = wpos % size;
+        size_t len = std::min({size - used, size - pos, read_size_.load(std::memory_order_relaxed)});
+
+        // Poll with a timeout so stop() is noticed while the input is idle
+        struct pollfd pfd = { .fd = fd_, .events = POLLIN, .revents = 0 };
+        int ret = poll(&pfd, 1, 100);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            error_.store(errno, std::memory_order_relaxed);
+            break;
+        }
+        if (ret == 0) continue;
+
+        ssize_t n = read(fd_, ring_.data() + pos, len);
+        if (n < 0) {
+            if (errno == EINTR || errno == EAGAIN) continue;
+            if (errno == EOVERFLOW) {
+                // Driver buffer overflowed and was flushed; data is lost but reading continues
+                overflow_count_.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            error_.store(errno, std::memory_order_relaxed);
+            break;
+        }
+        if (n == 0) break;  // EOF
+
+        // seq_cst pairs with the consumer's store of consumer_waiting_ / load of write_pos_
+        write_pos_.store(wpos + static_cast<size_t>(n));
+        if (consumer_waiting_.load()) {
+            std::lock_guard<std::mutex> lock(wait_mutex_);
+            data_cv_.notify_one();
+        }
+
+        bytes_read_.fetch_add(static_cast<size_t>(n), std::memory_order_relaxed);
+        read_count_.fetch_add(1, std::memory_order_relaxed);
+        updateRate(static_cast<size_t>(n), std::chrono::steady_clock::now());
+
+        // Short read on a DVR device: the kernel buffer is drained, let the
+        // next batch accumulate there instead of reading a few packets at a time
+        if (dvr_buffer_size_ > 0 && static_cast<size_t>(n) < len / 2) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(READ_INTERVAL_MS));
+        }
+    }
+
+    reader_done_.store(true);
+    std::lock_guard<std::mutex> lock(wait_mutex_);
+    data_cv_.notify_all();
+}
+
+} // namespace dvbdab
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dvbdab {
+
+// High-throughput reader for a DVR device (or any fd: pipe, file, socket)
+//
+// A dedicated thread does blocking reads straight into a large single
+// producer / single consumer ring; the consumer side takes whole regions out
+// of the ring without copying. On a DVR device the kernel buffer is enlarged
+// with DMX_SET_BUFFER_SIZE so the reader can batch: reads are sized to the
+// measured input rate (about READ_INTERVAL_MS of data each), and after a short
+// read the thread waits for the next batch to accumulate instead of issuing
+// one syscall per few packets.
+//
+// The ring is allocated and touched by the constructing thread - normally the
+// consumer - so on NUMA systems it sits on the consumer's node, unless a node
+// is configured for ThreadRole::DvrReader: then the reader thread moves it
+// there when it starts (run the consumer on the same node). The fd is not
+// closed by the reader.
+class DvrReader {
+public:
+    static constexpr size_t DEFAULT_RING_SIZE = 16 * 1024 * 1024;
+    static constexpr size_t DEFAULT_DVR_BUFFER_SIZE = 8 * 1024 * 1024;  // Kernel DVR buffer
+    static constexpr size_t MIN_READ_SIZE = 188 * 64;
+    static constexpr size_t MAX_READ_SIZE = 188 * 4096;
+    static constexpr unsigned int READ_INTERVAL_MS = 10;
+
+    explicit DvrReader(int fd, size_t ring_size = DEFAULT_RING_SIZE,
+                       size_t dvr_buffer_size = DEFAULT_DVR_BUFFER_SIZE);
+    ~DvrReader();
+
+    DvrReader(const DvrReader&) = delete;
+    DvrReader& operator=(const DvrReader&) = delete;
+
+    // Start / stop the reader thread
+    bool start();
+    void stop();
+
+    // Wait up to timeout_ms for data, then pass everything buffered to
+    // cb(const uint8_t* data, size_t len) as at most two contiguous regions
+    // and release it. Returns bytes consumed (0 on timeout or end of input).
+    template<typename Callback>
+    size_t consume(Callback&& cb, unsigned int timeout_ms);
+
+    // Reader thread has stopped (EOF or read error) and the ring is empty
+    bool finished() const;
+
+    // Statistics
+    size_t getBytesRead() const { return bytes_read_.load(std::memory_order_relaxed); }
+    size_t getReadCount() const { return read_count_.load(std::memory_order_relaxed); }       // read() calls returning data
+    size_t getOverflowCount() const { return overflow_count_.load(std::memory_order_relaxed); } // EOVERFLOW from the driver
+    size_t getRingFullCount() const { return ring_full_count_.load(std::memory_order_relaxed); } // Reader stalled on a full ring
+    size_t getReadSize() const { return read_size_.load(std::memory_order_relaxed); }         // Current read size
+    uint64_t getRate() const { return rate_.load(std::memory_order_relaxed); }                // Input rate in bytes/s
+    size_t getDvrBufferSize() const { return dvr_buffer_size_; }  // 0 if the fd has no DVR buffer
+    int getError() const { return error_.load(std::memory_order_relaxed); }  // errno of a fatal read error, 0 if none
+
+private:
+    void readerThread();
+    void updateRate(size_t bytes, std::chrono::steady_clock::time_point now);
+    size_t available() const {
+        return write_pos_.load(std::memory_order_acquire) - read_pos_.load(std::memory_order_relaxed);
+    }
+    void release(size_t len);
+
+    int fd_;
+    std::vector<uint8_t> ring_;
+    size_t dvr_buffer_size_{0};
+
+    // Monotonic byte positions; used = write_pos_ - read_pos_
+    std::atomic<size_t> write_pos_{0};
+    std::atomic<size_t> read_pos_{0};
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> reader_done_{false};
+    std::thread reader_thread_;
+
+    // Only used to sleep when the ring is empty (consumer) or full (reader)
+    std::mutex wait_mutex_;
+    std::condition_variable data_cv_;
+    std::condition_variable space_cv_;
+    std::atomic<bool> consumer_waiting_{false};
+    std::atomic<bool> reader_waiting_{false};
+
+    // Rate measurement (reader thread)
+    std::chrono::steady_clock::time_point rate_start_{};
+    size_t rate_bytes_{0};
+
+    // Statistics
+    std::atomic<size_t> bytes_read_{0};
+    std::atomic<size_t> read_count_{0};
+    std::atomic<size_t> overflow_count_{0};
+    std::atomic<size_t> ring_full_count_{0};
+    std::atomic<size_t> read_size_{MIN_READ_SIZE};
+    std::atomic<uint64_t> rate_{0};
+    std::atomic<int> error_{0};
+};
+
+template<typename Callback>
+size_t DvrReader::consume(Callback&& cb, unsigned int timeout_ms) {
+    size_t len = available();
+    if (len == 0) {
+        std::unique_lock<std::mutex> lock(wait_mutex_);
+        consumer_waiting_.store(true);
+        // seq_cst pairs with the reader's store of write_pos_ / load of consumer_waiting_
+        data_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this] {
+            return write_pos_.load() != read_pos_.load(std::memory_order_relaxed) || reader_done_.load();
+        });
+        consumer_waiting_.store(false);
+        len = available();
+        if (len == 0) return 0;
+    }
+
+    size_t size = ring_.size();
+    size_t pos = read_pos_.load(std::memory_order_relaxed) % size;
+    size_t first = len < size - pos ? len : size - pos;
+    cb(ring_.data() + pos, first);
+    if (first < len) {
+        cb(ring_.data(), len - first);
+    }
+    release(len);
+    return len;
+}
+
+} // namespace dvbdab
@@ -0,0 +1,174 @@
+#include "edi_tcp_source.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+namespace dvbdab {
+
+EdiTcpSource::EdiTcpSource(Mode mode, std::string host, uint16_t port, size_t ring_size)
+    : mode_(mode)
+    , host_(std::move(host))
+    , port_(port)
+    , ring_size_(ring_size > 0 ? ring_size : DEFAULT_RING_SIZE)
+{
+}
+
+EdiTcpSource::~EdiTcpSource() {
+    disconnect();
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+    }
+}
+
+void EdiTcpSource::disconnect() {
+    if (reader_) {
+        reader_->stop();
+        bytes_read_ += reader_->getBytesRead();
+        reader_.reset();
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool EdiTcpSource::connect(unsigned int timeout_ms) {
+    int fd = -1;
+    if (mode_ == Mode::Server) {
+        fd = acceptSender(timeout_ms);
+    } else {
+        // Back off after failed attempts and dropped connections
+        auto now = std::chrono::steady_clock::now();
+        if (now < next_attempt_) {
+            auto wait = std::min(next_attempt_ - now,
+                                 std::chrono::steady_clock::duration(std::chrono::milliseconds(timeout_ms)));
+            std::this_thread::sleep_for(wait);
+            if (std::chrono::steady_clock::now() < next_attempt_) return false;
+        }
+        fd = connectClient();
+        next_attempt_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(backoff_ms_);
+        backoff_ms_ = std::min(backoff_ms_ * 2, MAX_BACKOFF_MS);
+    }
+    if (fd < 0) return false;
+
+    startReader(fd);
+    return true;
+}
+
+void EdiTcpSource::startReader(int fd) {
+    fd_ = fd;
+    // No DVR buffer: reads are batched by the socket buffer alone
+    reader_ = std::make_unique<DvrReader>(fd_, ring_size_, 0);
+    if (!reader_->start()) {
+        reader_.reset();
+        close(fd_);
+        fd_ = -1;
+        return;
+    }
+    connect_count_++;
+    error_ = 0;
+}
+
+int EdiTcpSource::connectClient() {
+    struct addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* res = nullptr;
+    std::string port = std::to_string(port_);
+    if (getaddrinfo(host_.c_str(), port.c_str(), &hints, &res) != 0 || !res) {
+        error_ = EHOSTUNREACH;
+        return -1;
+    }
+
+    int fd = -1;
+    for (struct addrinfo* ai = res; ai; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK, ai->ai_protocol);
+        if (fd < 0) continue;
+
+        // Set before connect so the window scale is negotiated for it
+        int rcvbuf = SOCKET_BUFFER_SIZE;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+        int ret = ::connect(fd, ai->ai_addr, ai->ai_addrlen);
+        if (ret < 0 && errno == EINPROGRESS) {
+            struct pollfd pfd = { .fd = fd, .events = POLLOUT, .revents = 0 };
+            ret = poll(&pfd, 1, CONNECT_TIMEOUT_MS) == 1 ? 0 : -1;
+            int so_error = ret == 0 ? 0 : ETIMEDOUT;
+            socklen_t len = sizeof(so_error);
+            if (ret == 0) {
+                getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_error, &len);
+            }
+            if (so_error != 0) {
+                errno = so_error;
+                ret = -1;
+            }
+        }
+        if (ret == 0) break;
+
+        error_ = errno;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0) return -1;
+
+    // Blocking from here on; the reader polls before each read
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    return fd;
+}
+
+int EdiTcpSource::acceptSender(unsigned int timeout_ms) {
+    if (listen_fd_ < 0) {
+        struct addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        struct addrinfo* res = nullptr;
+        std::string port = std::to_string(port_);
+        if (getaddrinfo(host_.empty() ? nullptr : host_.c_str(), port.c_str(), &hints, &res) != 0 || !res) {
+            error_ = EADDRNOTAVAIL;
+            return -1;
+        }
+
+        int fd = socket(res->ai_family, res->ai_socktype | SOCK_CLOEXEC, res->ai_protocol);
+        if (fd >= 0) {
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            // Accepted sockets inherit the receive buffer (and window scale)
+            int rcvbuf = SOCKET_BUFFER_SIZE;
+            setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+            if (bind(fd, res->ai_addr, res->ai_addrlen) < 0 || listen(fd, 1) < 0) {
+                error_ = errno;
+                close(fd);
+                fd = -1;
+            }
+        } else {
+            error_ = errno;
+        }
+        freeaddrinfo(res);
+        if (fd < 0) {
+            // Do not spin on a port that cannot be bound
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(timeout_ms, MAX_BACKOFF_MS)));
+            return -1;
+        }
+        listen_fd_ = fd;
+    }
+
+    struct pollfd pfd = { .fd = listen_fd_, .events = POLLIN, .revents = 0 };
+    if (poll(&pfd, 1, static_cast<int>(timeout_ms)) != 1) return -1;
+
+    int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+        error_ = errno;
+    }
+    return fd;
+}
+
+} // namespace dvbdab
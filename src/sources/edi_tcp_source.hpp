@@ -0,0 +1,101 @@
+#pragma once
+
+#include "dvr_reader.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace dvbdab {
+
+// EDI over TCP input (ODR-DabMux and encoders with a TCP EDI output)
+//
+// Client mode connects to a sender, server mode listens and takes one sender
+// at a time. Each connection is read by a DvrReader: batched reads into a
+// large ring, with the socket receive buffer enlarged so the TCP window
+// covers bursts. When the connection drops, the client reconnects with
+// exponential backoff and the server waits for the next sender.
+//
+// Data is delivered as the raw TCP byte stream (back-to-back AF packets);
+// frame it with EdiStreamFramer, resetting the framer when
+// getConnectCount() changes.
+class EdiTcpSource {
+public:
+    enum class Mode { Client, Server };
+
+    static constexpr size_t DEFAULT_RING_SIZE = 4 * 1024 * 1024;
+    static constexpr int SOCKET_BUFFER_SIZE = 4 * 1024 * 1024;
+    static constexpr unsigned int CONNECT_TIMEOUT_MS = 2000;
+    static constexpr unsigned int MIN_BACKOFF_MS = 100;
+    static constexpr unsigned int MAX_BACKOFF_MS = 10000;
+
+    // Client: host is the sender to connect to. Server: host is the local
+    // address to bind (empty = any).
+    EdiTcpSource(Mode mode, std::string host, uint16_t port, size_t ring_size = DEFAULT_RING_SIZE);
+    ~EdiTcpSource();
+
+    EdiTcpSource(const EdiTcpSource&) = delete;
+    EdiTcpSource& operator=(const EdiTcpSource&) = delete;
+
+    // Wait up to timeout_ms for data (connecting first if needed) and pass it
+    // to cb(const uint8_t* data, size_t len) as at most two contiguous
+    // regions. Returns bytes consumed, 0 on timeout or while disconnected.
+    template<typename Callback>
+    size_t consume(Callback&& cb, unsigned int timeout_ms);
+
+    // Drop the current connection (reconnects on the next consume())
+    void disconnect();
+
+    bool isConnected() const { return reader_ != nullptr; }
+
+    // Statistics
+    size_t getConnectCount() const { return connect_count_; }  // Connections established
+    size_t getBytesRead() const { return bytes_read_ + (reader_ ? reader_->getBytesRead() : 0); }
+    uint64_t getRate() const { return reader_ ? reader_->getRate() : 0; }  // Bytes/s of the current connection
+    int getError() const { return error_; }  // errno of the last failed connect/accept/read, 0 if none
+
+private:
+    // Try to establish a connection within timeout_ms; false if not connected
+    bool connect(unsigned int timeout_ms);
+    int connectClient();
+    int acceptSender(unsigned int timeout_ms);
+    void startReader(int fd);
+
+    Mode mode_;
+    std::string host_;
+    uint16_t port_;
+    size_t ring_size_;
+
+    int fd_{-1};
+    int listen_fd_{-1};
+    std::unique_ptr<DvrReader> reader_;
+
+    // Reconnect backoff (client mode)
+    unsigned int backoff_ms_{MIN_BACKOFF_MS};
+    std::chrono::steady_clock::time_point next_attempt_{};
+
+    size_t connect_count_{0};
+    size_t bytes_read_{0};  // From closed connections
+    int error_{0};
+};
+
+template<typename Callback>
+size_t EdiTcpSource::consume(Callback&& cb, unsigned int timeout_ms) {
+    if (!reader_ && !connect(timeout_ms)) {
+        return 0;
+    }
+
+    size_t n = reader_->consume(cb, timeout_ms);
+    if (n > 0) {
+        backoff_ms_ = MIN_BACKOFF_MS;
+    } else if (reader_->finished()) {
+        if (reader_->getError() != 0) {
+            error_ = reader_->getError();
+        }
+        disconnect();
+    }
+    return n;
+}
+
+} // namespace dvbdab
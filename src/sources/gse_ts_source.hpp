@@ -2,6 +2,7 @@
 
 #include <dvbdab/input_source.hpp>
 #include "../parsers/gse_parser.hpp"
+#include "ts_sync.hpp"
 #include <vector>
 
 namespace dvbdab {
@@ -16,22 +17,37 @@ class GseTsSource : public InputSource {
 public:
     GseTsSource();
 
-    // Feed arbitrary amount of data (handles partial TS packets internally)
+    // Feed arbitrary amount of data (any alignment; 188/192/204-byte packets
+    // are detected and partial packets are handled internally)
     void feed(const uint8_t* data, size_t len) override;
 
     // Feed exactly one 188-byte TS packet (no buffering needed)
     void feedPacket(const uint8_t* ts_packet);
 
+    // Feed the payload of one TS packet (from an external demux; no
+    // continuity check)
+    void feedPayload(const uint8_t* payload, size_t len);
+
     void reset() override;
     const char* description() const override { return "GSE-in-TS"; }
 
     // Statistics
     size_t getTsPacketCount() const { return ts_packet_count_; }
     size_t getGsePacketCount() const { return gse_parser_.getPacketCount(); }
+    size_t getFilteredBytes() const { return gse_parser_.getFilteredBytes(); }
+    const TsSync& getTsSync() const { return ts_sync_; }
+
+    // Set IP:port filter (0 = no filter), applied before GSE reassembly
+    void setIpFilter(uint32_t ip, uint16_t port) { gse_parser_.setIpFilter(ip, port); }
+
+    // Set GSE label filter (3 or 6 bytes, nullptr = no filter)
+    void setLabelFilter(const uint8_t* label, size_t len) { gse_parser_.setLabelFilter(label, len); }
 
 private:
+    void processTsPacket(const uint8_t* ts_packet);
+
     GseParser gse_parser_;
-    std::vector<uint8_t> partial_ts_;  // Buffer for incomplete TS packets
+    TsSync ts_sync_;
     size_t ts_packet_count_{0};
 };
 
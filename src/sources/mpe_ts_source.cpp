@@ -12,7 +12,6 @@ MpeTsSource::MpeTsSource(uint16_t pid)
       })
     , target_pid_(pid)
 {
-    partial_ts_.reserve(MPE_TS_PACKET_SIZE);
 }
 
 bool MpeTsSource::matchesFilter(const uint8_t* ip_data, size_t len) {
@@ -51,41 +50,14 @@ bool MpeTsSource::matchesFilter(const uint8_t* ip_data, size_t len) {
 
 void MpeTsSource::reset() {
     mpe_parser_.reset();
-    partial_ts_.clear();
+    ts_sync_.reset();
     ts_packet_count_ = 0;
 }
 
 void MpeTsSource::feed(const uint8_t* data, size_t len) {
-    size_t pos = 0;
-
-    // If we have partial TS packet from previous feed, complete it first
-    if (!partial_ts_.empty()) {
-        size_t needed = MPE_TS_PACKET_SIZE - partial_ts_.size();
-        if (len < needed) {
-            // Still not enough, accumulate and return
-            partial_ts_.insert(partial_ts_.end(), data, data + len);
-            return;
-        }
-
-        // Complete the partial packet
-        partial_ts_.insert(partial_ts_.end(), data, data + needed);
-        pos = needed;
-
-        // Process completed TS packet
-        processTsPacket(partial_ts_.data());
-        partial_ts_.clear();
-    }
-
-    // Process complete TS packets
-    while (pos + MPE_TS_PACKET_SIZE <= len) {
-        processTsPacket(data + pos);
-        pos += MPE_TS_PACKET_SIZE;
-    }
-
-    // Save any remaining partial TS packet
-    if (pos < len) {
-        partial_ts_.assign(data + pos, data + len);
-    }
+    ts_sync_.feed(data, len, [this](const uint8_t* ts_packet) {
+        processTsPacket(ts_packet);
+    });
 }
 
 void MpeTsSource::feedPacket(const uint8_t* ts_packet) {
@@ -137,4 +109,8 @@ void MpeTsSource::processTsPacket(const uint8_t* ts_packet) {
     mpe_parser_.feedTsPayload(ts_packet + payload_start, payload_len, pusi);
 }
 
+void MpeTsSource::feedPayload(const uint8_t* payload, size_t len, bool pusi) {
+    mpe_parser_.feedTsPayload(payload, len, pusi);
+}
+
 } // namespace dvbdab
@@ -2,6 +2,7 @@
 
 #include <dvbdab/input_source.hpp>
 #include "../parsers/mpe_parser.hpp"
+#include "ts_sync.hpp"
 #include <vector>
 
 namespace dvbdab {
@@ -20,12 +21,17 @@ public:
     // Constructor with configurable PID (default 3000 for WDR)
     explicit MpeTsSource(uint16_t pid = 3000);
 
-    // Feed arbitrary amount of data (handles partial TS packets internally)
+    // Feed arbitrary amount of data (any alignment; 188/192/204-byte packets
+    // are detected and partial packets are handled internally)
     void feed(const uint8_t* data, size_t len) override;
 
     // Feed exactly one 188-byte TS packet (no buffering needed)
     void feedPacket(const uint8_t* ts_packet);
 
+    // Feed the payload of one TS packet of the target PID (from an external
+    // demux; no PID or continuity check)
+    void feedPayload(const uint8_t* payload, size_t len, bool pusi);
+
     void reset() override;
     const char* description() const override { return "MPE-in-TS"; }
 
@@ -34,6 +40,7 @@ public:
     size_t getMpeSectionCount() const { return mpe_parser_.getSectionCount(); }
     size_t getIpPacketCount() const { return mpe_parser_.getIpPacketCount(); }
     size_t getFilteredPacketCount() const { return filtered_packet_count_; }
+    const TsSync& getTsSync() const { return ts_sync_; }
 
     // Get/set target PID
     uint16_t getPid() const { return target_pid_; }
@@ -47,7 +54,7 @@ private:
     bool matchesFilter(const uint8_t* ip_data, size_t len);
 
     MpeParser mpe_parser_;
-    std::vector<uint8_t> partial_ts_;  // Buffer for incomplete TS packets
+    TsSync ts_sync_;
     uint16_t target_pid_;
     uint32_t filter_ip_{0};      // 0 = no filter
     uint16_t filter_port_{0};    // 0 = no filter
@@ -0,0 +1,78 @@
+#include "ts_history.hpp"
+#include <cstring>
+
+namespace dvbdab {
+
+TsHistory::TsHistory(unsigned int duration_ms, size_t max_bytes_per_pid)
+    : duration_ms_(duration_ms)
+    , max_packets_(max_bytes_per_pid / TS_PACKET_SIZE > 0 ? max_bytes_per_pid / TS_PACKET_SIZE : 1)
+{
+}
+
+void TsHistory::addPid(uint16_t pid) {
+    rings_.try_emplace(pid);
+}
+
+void TsHistory::removePid(uint16_t pid) {
+    rings_.erase(pid);
+}
+
+void TsHistory::clear() {
+    for (auto& [pid, ring] : rings_) {
+        ring.head = 0;
+        ring.count = 0;
+    }
+    ts_sync_.reset();
+}
+
+void TsHistory::feed(const uint8_t* data, size_t len, const Clock& clock) {
+    uint64_t now_ms = clock.elapsedMs();
+    ts_sync_.feed(data, len, [this, now_ms](const uint8_t* ts) {
+        recordPacket(ts, now_ms);
+    });
+}
+
+void TsHistory::recordPacket(const uint8_t* ts, uint64_t now_ms) {
+    uint16_t pid = ((ts[1] & 0x1F) << 8) | ts[2];
+    auto it = rings_.find(pid);
+    if (it == rings_.end()) return;
+
+    Ring& ring = it->second;
+    if (ring.times.empty()) {
+        ring.data.resize(max_packets_ * TS_PACKET_SIZE);
+        ring.times.resize(max_packets_);
+    }
+    size_t slots = ring.times.size();
+
+    // Drop packets older than the history duration
+    while (ring.count > 0 && now_ms - ring.times[ring.head] > duration_ms_) {
+        ring.head = (ring.head + 1) % slots;
+        ring.count--;
+    }
+
+    // Full - overwrite the oldest
+    if (ring.count == slots) {
+        ring.head = (ring.head + 1) % slots;
+        ring.count--;
+    }
+
+    size_t slot = (ring.head + ring.count) % slots;
+    std::memcpy(ring.data.data() + slot * TS_PACKET_SIZE, ts, TS_PACKET_SIZE);
+    ring.times[slot] = now_ms;
+    ring.count++;
+}
+
+size_t TsHistory::getPacketCount(uint16_t pid) const {
+    auto it = rings_.find(pid);
+    return it != rings_.end() ? it->second.count : 0;
+}
+
+size_t TsHistory::getMemoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& [pid, ring] : rings_) {
+        bytes += ring.data.size() + ring.times.size() * sizeof(ring.times[0]);
+    }
+    return bytes;
+}
+
+} // namespace dvbdab
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ts_sync.hpp"
+#include "../clock.hpp"
+#include <cstdint>
+#include <cstddef>
+#include <map>
+#include <vector>
+
+namespace dvbdab {
+
+// Recent TS packets per PID, kept at the demux stage so a streamer created
+// later (new ensemble on an already tuned transponder) can be primed at full
+// speed instead of waiting for fresh FIC and superframe sync.
+//
+// Each recorded PID has a ring of 188-byte packets bounded by age (on the
+// caller's Clock) and size.
+// Ring storage is allocated on the first packet of a PID and reused after
+// that. replay() hands out the packets oldest first as contiguous runs.
+class TsHistory {
+public:
+    static constexpr unsigned int DEFAULT_DURATION_MS = 5000;
+    static constexpr size_t DEFAULT_MAX_BYTES = 2 * 1024 * 1024;  // Per PID
+
+    explicit TsHistory(unsigned int duration_ms = DEFAULT_DURATION_MS,
+                       size_t max_bytes_per_pid = DEFAULT_MAX_BYTES);
+
+    // Select PIDs to record
+    void addPid(uint16_t pid);
+    void removePid(uint16_t pid);
+
+    // Feed raw TS data (any alignment, 188/192/204 stride), stamped with the
+    // clock's current time
+    void feed(const uint8_t* data, size_t len, const Clock& clock);
+
+    // Record one aligned 188-byte TS packet arriving at now_ms (Clock time)
+    void recordPacket(const uint8_t* ts, uint64_t now_ms);
+
+    // Pass recorded packets of a PID to cb(const uint8_t* data, size_t len),
+    // oldest first, in runs of whole packets. Returns number of packets.
+    template<typename Callback>
+    size_t replay(uint16_t pid, Callback&& cb) const;
+
+    // Drop all recorded packets (PID selection is kept)
+    void clear();
+
+    // Statistics
+    size_t getPacketCount(uint16_t pid) const;  // Packets currently held for pid
+    size_t getMemoryUsage() const;               // Bytes of ring storage allocated
+
+private:
+    struct Ring {
+        std::vector<uint8_t> data;     // slots * TS_PACKET_SIZE
+        std::vector<uint64_t> times;   // Arrival per slot (ms)
+        size_t head{0};   // Oldest packet
+        size_t count{0};
+    };
+
+    std::map<uint16_t, Ring> rings_;
+    TsSync ts_sync_;
+    uint64_t duration_ms_;
+    size_t max_packets_;
+};
+
+template<typename Callback>
+size_t TsHistory::replay(uint16_t pid, Callback&& cb) const {
+    auto it = rings_.find(pid);
+    if (it == rings_.end() || it->second.count == 0) return 0;
+
+    const Ring& ring = it->second;
+    size_t slots = ring.times.size();
+    size_t first = ring.count < slots - ring.head ? ring.count : slots - ring.head;
+    cb(ring.data.data() + ring.head * TS_PACKET_SIZE, first * TS_PACKET_SIZE);
+    if (first < ring.count) {
+        cb(ring.data.data(), (ring.count - first) * TS_PACKET_SIZE);
+    }
+    return ring.count;
+}
+
+} // namespace dvbdab
@@ -0,0 +1,59 @@
+#include "ts_sync.hpp"
+#include <cstring>
+
+namespace dvbdab {
+
+// Supported packet strides, most common first
+static constexpr size_t TS_STRIDES[] = {188, 204, 192};
+
+TsSync::TsSync() {
+    pending_.reserve(LOCK_PACKETS * MAX_STRIDE);
+}
+
+void TsSync::reset() {
+    pending_.clear();
+    skip_ = 0;
+    locked_ = false;
+}
+
+static inline bool stride_matches(const uint8_t* buf, size_t pos, size_t stride) {
+    for (int k = 1; k < TsSync::LOCK_PACKETS; k++) {
+        if (buf[pos + k * stride] != 0x47) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t TsSync::hunt(const uint8_t* buf, size_t n, size_t pos, size_t& resume) {
+    while (pos < n) {
+        const void* hit = std::memchr(buf + pos, 0x47, n - pos);
+        if (!hit) {
+            resume = n;
+            return NO_SYNC;
+        }
+        size_t q = static_cast<const uint8_t*>(hit) - buf;
+
+        // Need lookahead for the widest stride before deciding
+        if (q + (LOCK_PACKETS - 1) * MAX_STRIDE >= n) {
+            resume = q;
+            return NO_SYNC;
+        }
+
+        // Previous stride first - quick re-lock after a sync loss
+        if (stride_matches(buf, q, stride_)) {
+            return q;
+        }
+        for (size_t stride : TS_STRIDES) {
+            if (stride != stride_ && stride_matches(buf, q, stride)) {
+                stride_ = stride;
+                return q;
+            }
+        }
+        pos = q + 1;
+    }
+    resume = n;
+    return NO_SYNC;
+}
+
+} // namespace dvbdab
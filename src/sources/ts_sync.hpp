@@ -0,0 +1,175 @@
+#pragma once
+
+#include <dvbdab/dvbdab.hpp>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace dvbdab {
+
+// TS sync acquisition shared by all TS-based inputs
+//
+// Finds 0x47 sync bytes in an arbitrary byte stream (any read size, any start
+// offset) and locks onto a packet stride:
+//   188 - plain TS
+//   192 - M2TS (4-byte timecode before each packet)
+//   204 - TS with 16 bytes RS parity appended
+// Once locked, every 188-byte TS packet (starting at 0x47) is passed to the
+// callback without copying - only packets split across feed() calls are
+// assembled in a small carry buffer. A single corrupted sync byte is tolerated
+// when the following packet is in place; otherwise lock is dropped and the
+// stream is hunted again (memchr) from the next byte.
+class TsSync {
+public:
+    TsSync();
+
+    // Feed raw data; on_packet(const uint8_t* ts) is called per 188-byte packet
+    template<typename Callback>
+    void feed(const uint8_t* data, size_t len, Callback&& on_packet);
+
+    // Drop lock and buffered bytes
+    void reset();
+
+    // Current lock state
+    bool isLocked() const { return locked_; }
+    size_t getPacketStride() const { return locked_ ? stride_ : 0; }  // 188/192/204, 0 = hunting
+
+    // Statistics
+    size_t getPacketCount() const { return packet_count_; }        // Packets delivered
+    size_t getLockCount() const { return lock_count_; }            // Times sync was acquired
+    size_t getSyncLossCount() const { return sync_loss_count_; }   // Times lock was lost
+    size_t getSyncErrorCount() const { return sync_error_count_; } // Packets dropped with bad sync byte (lock kept)
+    size_t getSkippedBytes() const { return skipped_bytes_; }      // Bytes discarded while hunting
+
+    // Packets checked (at equal stride) before declaring lock
+    static constexpr int LOCK_PACKETS = 4;
+    static constexpr size_t MAX_STRIDE = 204;
+
+private:
+    static constexpr size_t NO_SYNC = static_cast<size_t>(-1);
+
+    // Search buf[pos..n) for LOCK_PACKETS sync bytes at a supported stride.
+    // Returns offset of first sync byte and sets stride_, or NO_SYNC with
+    // resume = first byte that must be kept (candidate lacking lookahead).
+    size_t hunt(const uint8_t* buf, size_t n, size_t pos, size_t& resume);
+
+    // Process a contiguous buffer, returns bytes consumed (rest is carried)
+    template<typename Callback>
+    size_t process(const uint8_t* buf, size_t n, Callback&& on_packet);
+
+    std::vector<uint8_t> pending_;  // Carry: partial packet (locked) or hunt window (unlocked)
+    size_t skip_{0};                // Stride bytes still to skip at start of next feed
+    size_t stride_{TS_PACKET_SIZE};
+    bool locked_{false};
+
+    size_t packet_count_{0};
+    size_t lock_count_{0};
+    size_t sync_loss_count_{0};
+    size_t sync_error_count_{0};
+    size_t skipped_bytes_{0};
+};
+
+template<typename Callback>
+size_t TsSync::process(const uint8_t* buf, size_t n, Callback&& on_packet) {
+    size_t p = 0;
+    while (p < n) {
+        if (!locked_) {
+            size_t resume = n;
+            size_t found = hunt(buf, n, p, resume);
+            if (found == NO_SYNC) {
+                // Keep bytes that may still start a sync run once more data arrives
+                skipped_bytes_ += resume - p;
+                return resume;
+            }
+            skipped_bytes_ += found - p;
+            p = found;
+            locked_ = true;
+            lock_count_++;
+        }
+
+        if (n - p < TS_PACKET_SIZE) {
+            return p;  // Partial packet - carried to next feed
+        }
+
+        if (buf[p] != 0x47) {
+            if (p + stride_ < n && buf[p + stride_] == 0x47) {
+                // Corrupted sync byte, next packet in place - keep lock
+                sync_error_count_++;
+                p += stride_;
+                continue;
+            }
+            locked_ = false;
+            sync_loss_count_++;
+            p++;
+            continue;
+        }
+
+        on_packet(buf + p);
+        packet_count_++;
+
+        if (p + stride_ > n) {
+            skip_ = p + stride_ - n;  // M2TS/RS tail continues in next feed
+            return n;
+        }
+        p += stride_;
+    }
+    return p;
+}
+
+template<typename Callback>
+void TsSync::feed(const uint8_t* data, size_t len, Callback&& on_packet) {
+    size_t pos = 0;
+
+    // Bytes left over from the previous packet's stride (M2TS prefix / RS parity)
+    if (skip_ > 0) {
+        size_t n = skip_ < len ? skip_ : len;
+        skip_ -= n;
+        pos = n;
+    }
+    if (pos >= len) return;
+
+    if (!pending_.empty() && locked_) {
+        // Complete the packet split across feeds
+        size_t needed = TS_PACKET_SIZE - pending_.size();
+        if (len - pos < needed) {
+            pending_.insert(pending_.end(), data + pos, data + len);
+            return;
+        }
+        pending_.insert(pending_.end(), data + pos, data + pos + needed);
+        pos += needed;
+
+        if (pending_[0] == 0x47) {
+            on_packet(pending_.data());
+            packet_count_++;
+            pending_.clear();
+
+            size_t extra = stride_ - TS_PACKET_SIZE;
+            size_t n = extra < len - pos ? extra : len - pos;
+            skip_ = extra - n;
+            pos += n;
+            if (pos >= len) return;
+        } else {
+            // Lost sync at the boundary - hunt through carry + new data
+            locked_ = false;
+            sync_loss_count_++;
+            pending_.erase(pending_.begin());
+        }
+    }
+
+    if (!pending_.empty()) {
+        // Hunting across the boundary: join carry and new data (acquisition only)
+        pending_.insert(pending_.end(), data + pos, data + len);
+        size_t consumed = process(pending_.data(), pending_.size(), on_packet);
+        pending_.erase(pending_.begin(), pending_.begin() + consumed);
+        return;
+    }
+
+    // Fast path: process caller's buffer in place
+    size_t consumed = process(data + pos, len - pos, on_packet);
+    pos += consumed;
+    if (pos < len) {
+        pending_.assign(data + pos, data + len);
+    }
+}
+
+} // namespace dvbdab
@@ -0,0 +1,395 @@
+#include "udp_ts_receiver.hpp"
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace dvbdab {
+
+namespace {
+
+constexpr uint8_t TS_SYNC_BYTE = 0x47;
+constexpr uint16_t RTP_LATE_WINDOW = 64;  // Sequence numbers this far behind are late, not a restart
+
+// Socket filter for the ring: IPv4/UDP to group:port, no fragments, not our own
+// transmissions (loopback). The socket is SOCK_DGRAM, so data starts at the IP header.
+std::vector<struct sock_filter> buildRingFilter(uint32_t group, uint16_t port) {
+    std::vector<struct sock_filter> prog;
+    std::vector<size_t> to_drop_jt;  // Jumps whose jt / jf is the drop label
+    std::vector<size_t> to_drop_jf;
+
+    prog.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, static_cast<uint32_t>(SKF_AD_OFF + SKF_AD_PKTTYPE)));
+    to_drop_jt.push_back(prog.size());
+    prog.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, PACKET_OUTGOING, 0, 0));
+    prog.push_back(BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 9));              // Protocol
+    to_drop_jf.push_back(prog.size());
+    prog.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, IPPROTO_UDP, 0, 0));
+    prog.push_back(BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 6));              // Flags / fragment offset
+    to_drop_jt.push_back(prog.size());
+    prog.push_back(BPF_JUMP(BPF_JMP | BPF_JSET | BPF_K, 0x3fff, 0, 0));
+    if (group != 0) {
+        prog.push_back(BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 16));         // Destination address
+        to_drop_jf.push_back(prog.size());
+        prog.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, group, 0, 0));
+    }
+    prog.push_back(BPF_STMT(BPF_LDX | BPF_B | BPF_MSH, 0));             // X = IP header length
+    prog.push_back(BPF_STMT(BPF_LD | BPF_H | BPF_IND, 2));              // UDP destination port
+    to_drop_jf.push_back(prog.size());
+    prog.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, port, 0, 0));
+    prog.push_back(BPF_STMT(BPF_RET | BPF_K, 0xffffffff));
+    size_t drop = prog.size();
+    prog.push_back(BPF_STMT(BPF_RET | BPF_K, 0));
+
+    for (size_t i : to_drop_jt) prog[i].jt = static_cast<uint8_t>(drop - i - 1);
+    for (size_t i : to_drop_jf) prog[i].jf = static_cast<uint8_t>(drop - i - 1);
+    return prog;
+}
+
+bool attachFilter(int fd, std::vector<struct sock_filter>& prog) {
+    struct sock_fprog fprog{};
+    fprog.len = static_cast<unsigned short>(prog.size());
+    fprog.filter = prog.data();
+    return setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog)) == 0;
+}
+
+} // namespace
+
+UdpTsReceiver::UdpTsReceiver(std::string address, uint16_t port, std::string interface, Mode mode)
+    : address_(std::move(address))
+    , port_(port)
+    , interface_(std::move(interface))
+    , mode_(mode)
+{
+}
+
+UdpTsReceiver::~UdpTsReceiver() {
+    if (ring_) {
+        munmap(ring_, RING_BLOCK_SIZE * RING_BLOCK_COUNT);
+    }
+    if (fd_ >= 0) close(fd_);
+    if (join_fd_ >= 0) close(join_fd_);
+}
+
+bool UdpTsReceiver::open() {
+    if (fd_ >= 0) return true;
+
+    if (!address_.empty()) {
+        struct in_addr addr{};
+        if (inet_pton(AF_INET, address_.c_str(), &addr) != 1) {
+            error_ = EINVAL;
+            return false;
+        }
+        group_ = ntohl(addr.s_addr);
+    }
+
+    unsigned int ifindex = 0;
+    if (!interface_.empty()) {
+        ifindex = if_nametoindex(interface_.c_str());
+        if (ifindex == 0) {
+            error_ = ENODEV;
+            return false;
+        }
+    }
+
+    // The ring sees one interface; without one only the socket can be used
+    if (mode_ == Mode::Ring || (mode_ == Mode::Auto && ifindex != 0)) {
+        if (ifindex != 0 && openRing(ifindex)) return true;
+        if (mode_ == Mode::Ring) {
+            if (ifindex == 0) error_ = ENODEV;
+            return false;
+        }
+    }
+    return openSocket(ifindex);
+}
+
+bool UdpTsReceiver::joinGroup(int fd, unsigned int ifindex) {
+    if (!IN_MULTICAST(group_)) return true;
+
+    struct ip_mreqn mreq{};
+    mreq.imr_multiaddr.s_addr = htonl(group_);
+    mreq.imr_address.s_addr = htonl(INADDR_ANY);
+    mreq.imr_ifindex = static_cast<int>(ifindex);
+    if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+        error_ = errno;
+        return false;
+    }
+    return true;
+}
+
+bool UdpTsReceiver::openRing(unsigned int ifindex) {
+    // A bound UDP socket joins the group and keeps the kernel from answering
+    // unicast traffic with port unreachable; it never queues anything.
+    int join_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (join_fd < 0) {
+        error_ = errno;
+        return false;
+    }
+    std::vector<struct sock_filter> drop_all = { BPF_STMT(BPF_RET | BPF_K, 0) };
+    int one = 1;
+    setsockopt(join_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(port_);
+    sin.sin_addr.s_addr = htonl(group_);
+    if (!attachFilter(join_fd, drop_all) ||
+        bind(join_fd, reinterpret_cast<struct sockaddr*>(&sin), sizeof(sin)) < 0 ||
+        !joinGroup(join_fd, ifindex)) {
+        error_ = errno;
+        close(join_fd);
+        return false;
+    }
+
+    int fd = socket(AF_PACKET, SOCK_DGRAM | SOCK_CLOEXEC, htons(ETH_P_IP));
+    if (fd < 0) {
+        error_ = errno;
+        close(join_fd);
+        return false;
+    }
+
+    // Filter before the ring exists so it never sees unrelated traffic
+    std::vector<struct sock_filter> prog = buildRingFilter(group_, port_);
+    int version = TPACKET_V3;
+    struct tpacket_req3 req{};
+    req.tp_block_size = RING_BLOCK_SIZE;
+    req.tp_block_nr = RING_BLOCK_COUNT;
+    req.tp_frame_size = DATAGRAM_SIZE;
+    req.tp_frame_nr = (RING_BLOCK_SIZE / DATAGRAM_SIZE) * RING_BLOCK_COUNT;
+    req.tp_retire_blk_tov = RING_BLOCK_TIMEOUT_MS;
+
+    struct sockaddr_ll sll{};
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htons(ETH_P_IP);
+    sll.sll_ifindex = static_cast<int>(ifindex);
+
+    void* map = MAP_FAILED;
+    if (attachFilter(fd, prog) &&
+        setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) == 0 &&
+        setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) == 0) {
+        map = mmap(nullptr, RING_BLOCK_SIZE * RING_BLOCK_COUNT, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd, 0);
+    }
+    if (map == MAP_FAILED ||
+        bind(fd, reinterpret_cast<struct sockaddr*>(&sll), sizeof(sll)) < 0) {
+        error_ = errno;
+        if (map != MAP_FAILED) munmap(map, RING_BLOCK_SIZE * RING_BLOCK_COUNT);
+        close(fd);
+        close(join_fd);
+        return false;
+    }
+
+    fd_ = fd;
+    join_fd_ = join_fd;
+    ring_ = static_cast<uint8_t*>(map);
+    ring_block_ = 0;
+    iov_.reserve(RING_BLOCK_SIZE / 256);
+    return true;
+}
+
+bool UdpTsReceiver::openSocket(unsigned int ifindex) {
+    int fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        error_ = errno;
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &one, sizeof(one));
+    // FORCE needs CAP_NET_ADMIN; otherwise capped at rmem_max
+    int rcvbuf = SOCKET_BUFFER_SIZE;
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) < 0) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+    }
+
+    // Binding the group address keeps other groups on the same port out
+    struct sockaddr_in sin{};
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(port_);
+    sin.sin_addr.s_addr = htonl(group_);
+    if (bind(fd, reinterpret_cast<struct sockaddr*>(&sin), sizeof(sin)) < 0 ||
+        !joinGroup(fd, ifindex)) {
+        error_ = errno;
+        close(fd);
+        return false;
+    }
+
+    fd_ = fd;
+    buffers_.resize(BATCH_SIZE * DATAGRAM_SIZE);
+    control_.resize(BATCH_SIZE * CMSG_SPACE(sizeof(uint32_t)));
+    iov_.reserve(BATCH_SIZE);
+    return true;
+}
+
+bool UdpTsReceiver::receive(unsigned int timeout_ms) {
+    iov_.clear();
+    segments_.clear();
+    if (fd_ < 0) return false;
+
+    bool ok = ring_ ? receiveRing(timeout_ms) : receiveSocket(timeout_ms);
+    if (ok && iov_.empty()) {
+        release();  // Nothing usable in this block
+        return false;
+    }
+    return ok;
+}
+
+bool UdpTsReceiver::receiveRing(unsigned int timeout_ms) {
+    auto* block = reinterpret_cast<struct tpacket_block_desc*>(ring_ + ring_block_ * RING_BLOCK_SIZE);
+    auto ready = [block]() {
+        return (__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER) != 0;
+    };
+    if (!ready()) {
+        struct pollfd pfd = { .fd = fd_, .events = POLLIN | POLLERR, .revents = 0 };
+        if (poll(&pfd, 1, static_cast<int>(timeout_ms)) <= 0 || !ready()) return false;
+    }
+    block_held_ = true;
+
+    const uint8_t* base = reinterpret_cast<const uint8_t*>(block);
+    const uint8_t* pos = base + block->hdr.bh1.offset_to_first_pkt;
+    for (uint32_t i = 0; i < block->hdr.bh1.num_pkts; i++) {
+        auto* hdr = reinterpret_cast<const struct tpacket3_hdr*>(pos);
+        // SOCK_DGRAM: tp_mac is the start of the IP header
+        addPacket(pos + hdr->tp_mac, hdr->tp_snaplen);
+        pos += hdr->tp_next_offset;
+    }
+    return true;
+}
+
+bool UdpTsReceiver::receiveSocket(unsigned int timeout_ms) {
+    struct pollfd pfd = { .fd = fd_, .events = POLLIN, .revents = 0 };
+    if (poll(&pfd, 1, static_cast<int>(timeout_ms)) <= 0) return false;
+
+    struct mmsghdr msgs[BATCH_SIZE];
+    struct iovec iovs[BATCH_SIZE];
+    const size_t control_size = CMSG_SPACE(sizeof(uint32_t));
+    for (size_t i = 0; i < BATCH_SIZE; i++) {
+        iovs[i].iov_base = buffers_.data() + i * DATAGRAM_SIZE;
+        iovs[i].iov_len = DATAGRAM_SIZE;
+        std::memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_control = control_.data() + i * control_size;
+        msgs[i].msg_hdr.msg_controllen = control_size;
+    }
+
+    int n = recvmmsg(fd_, msgs, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EINTR) error_ = errno;
+        return false;
+    }
+
+    for (int i = 0; i < n; i++) {
+        const struct msghdr& msg = msgs[i].msg_hdr;
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(const_cast<struct msghdr*>(&msg), cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+                uint32_t drops;
+                std::memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+                drop_count_ += drops - socket_drops_;
+                socket_drops_ = drops;
+            }
+        }
+        if (msg.msg_flags & MSG_TRUNC) {
+            datagram_count_++;
+            invalid_count_++;
+            continue;
+        }
+        addDatagram(static_cast<const uint8_t*>(iovs[i].iov_base), msgs[i].msg_len);
+    }
+    return true;
+}
+
+void UdpTsReceiver::release() {
+    if (!ring_ || !block_held_) return;
+
+    auto* block = reinterpret_cast<struct tpacket_block_desc*>(ring_ + ring_block_ * RING_BLOCK_SIZE);
+    __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    block_held_ = false;
+    ring_block_ = (ring_block_ + 1) % RING_BLOCK_COUNT;
+
+    // Reading the statistics resets them
+    struct tpacket_stats_v3 stats{};
+    socklen_t len = sizeof(stats);
+    if (getsockopt(fd_, SOL_PACKET, PACKET_STATISTICS, &stats, &len) == 0) {
+        drop_count_ += stats.tp_drops;
+    }
+}
+
+void UdpTsReceiver::addPacket(const uint8_t* ip, size_t len) {
+    // The filter already matched; only guard against malformed headers
+    if (len < 28 || (ip[0] >> 4) != 4) return;
+    size_t ihl = static_cast<size_t>(ip[0] & 0x0f) * 4;
+    if (ihl < 20 || len < ihl + 8 || ip[9] != IPPROTO_UDP) return;
+
+    uint32_t dst = (static_cast<uint32_t>(ip[16]) << 24) | (ip[17] << 16) | (ip[18] << 8) | ip[19];
+    const uint8_t* udp = ip + ihl;
+    uint16_t dst_port = static_cast<uint16_t>((udp[2] << 8) | udp[3]);
+    size_t udp_len = static_cast<size_t>((udp[4] << 8) | udp[5]);
+    if ((group_ != 0 && dst != group_) || dst_port != port_) return;
+    if (udp_len < 8 || udp_len > len - ihl) return;
+
+    addDatagram(udp + 8, udp_len - 8);
+}
+
+void UdpTsReceiver::addDatagram(const uint8_t* data, size_t len) {
+    datagram_count_++;
+
+    const uint8_t* ts = data;
+    size_t ts_len = len;
+    bool gap = false;
+
+    if (len > 0 && data[0] != TS_SYNC_BYTE) {
+        // RTP (RFC 3550): version 2, CSRCs, optional extension and padding
+        if (len < 12 || (data[0] & 0xc0) != 0x80) {
+            invalid_count_++;
+            return;
+        }
+        size_t header = 12 + 4 * static_cast<size_t>(data[0] & 0x0f);
+        if ((data[0] & 0x10) && len >= header + 4) {
+            header += 4 + 4 * static_cast<size_t>((data[header + 2] << 8) | data[header + 3]);
+        }
+        size_t padding = (data[0] & 0x20) ? data[len - 1] : 0;
+        if (header + padding >= len || data[header] != TS_SYNC_BYTE) {
+            invalid_count_++;
+            return;
+        }
+        ts = data + header;
+        ts_len = len - header - padding;
+        rtp_count_++;
+
+        uint16_t seq = static_cast<uint16_t>((data[2] << 8) | data[3]);
+        if (have_seq_ && seq != next_seq_) {
+            uint16_t missing = static_cast<uint16_t>(seq - next_seq_);
+            if (missing > 0xffff - RTP_LATE_WINDOW) {
+                // Late or duplicate: its place in the stream is gone
+                invalid_count_++;
+                return;
+            }
+            // A large jump is a sender restart rather than loss
+            sequence_gap_count_++;
+            if (missing < 0x8000) lost_datagram_count_ += missing;
+            gap = true;
+        }
+        have_seq_ = true;
+        next_seq_ = static_cast<uint16_t>(seq + 1);
+    }
+    if (ts_len == 0) {
+        invalid_count_++;
+        return;
+    }
+
+    if (segments_.empty() || gap) {
+        segments_.push_back({iov_.size(), 0, gap});
+    }
+    iov_.push_back({const_cast<uint8_t*>(ts), ts_len});
+    segments_.back().count++;
+}
+
+} // namespace dvbdab
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <sys/uio.h>
+
+namespace dvbdab {
+
+// Receiver for TS over UDP / RTP (SAT>IP, minisatip and IPTV multicast)
+//
+// Ring mode reads an AF_PACKET TPACKET_V3 mmap ring: the kernel fills whole
+// blocks of datagrams and hands them over without a copy or a syscall per
+// datagram; a BPF filter keeps other traffic out of the ring. It needs
+// CAP_NET_RAW and an interface. Socket mode reads a UDP socket with
+// recvmmsg() in batches. Auto uses the ring when possible.
+//
+// RTP headers are stripped (plain UDP carrying TS is accepted as well) and
+// the TS payloads of a batch are passed as an iovec array pointing into the
+// ring or receive buffers. Gaps in the RTP sequence start a new segment that
+// is flagged as discontinuous, so the demux can treat it like a CC error.
+class UdpTsReceiver {
+public:
+    enum class Mode { Auto, Ring, Socket };
+
+    static constexpr size_t RING_BLOCK_SIZE = 1024 * 1024;
+    static constexpr size_t RING_BLOCK_COUNT = 32;             // ~2.5 s at 100 Mbit/s
+    static constexpr unsigned int RING_BLOCK_TIMEOUT_MS = 8;   // Partly filled blocks are retired after this
+    static constexpr size_t BATCH_SIZE = 64;                   // Datagrams per recvmmsg()
+    static constexpr size_t DATAGRAM_SIZE = 2048;
+    static constexpr int SOCKET_BUFFER_SIZE = 16 * 1024 * 1024;
+
+    // address: multicast group or local unicast address ("" = any).
+    // interface: network interface name ("" = default route, socket mode only).
+    UdpTsReceiver(std::string address, uint16_t port, std::string interface = "", Mode mode = Mode::Auto);
+    ~UdpTsReceiver();
+
+    UdpTsReceiver(const UdpTsReceiver&) = delete;
+    UdpTsReceiver& operator=(const UdpTsReceiver&) = delete;
+
+    // Open the sockets and join the group. Returns false on error (see getError()).
+    bool open();
+
+    // Wait up to timeout_ms for datagrams and pass their TS payloads to
+    // cb(const struct iovec* iov, int iovcnt, bool discontinuity), once per
+    // run of datagrams without a sequence gap. Buffers are valid during the
+    // call only. Returns TS bytes delivered, 0 on timeout.
+    template<typename Callback>
+    size_t consume(Callback&& cb, unsigned int timeout_ms);
+
+    bool usesRing() const { return ring_ != nullptr; }
+
+    // Statistics
+    size_t getDatagramCount() const { return datagram_count_; }
+    size_t getRtpCount() const { return rtp_count_; }                  // Datagrams with an RTP header
+    size_t getSequenceGapCount() const { return sequence_gap_count_; }
+    size_t getLostDatagramCount() const { return lost_datagram_count_; }  // Missing RTP sequence numbers
+    size_t getInvalidCount() const { return invalid_count_; }          // Not TS, or late/duplicate RTP
+    uint64_t getDropCount() const { return drop_count_; }              // Dropped by the kernel (ring or socket full)
+    int getError() const { return error_; }
+
+private:
+    struct Segment {
+        size_t first;
+        size_t count;
+        bool discontinuity;
+    };
+
+    bool openRing(unsigned int ifindex);
+    bool openSocket(unsigned int ifindex);
+    bool joinGroup(int fd, unsigned int ifindex);
+
+    // Collect the next block (ring) or batch (socket) into iov_ / segments_
+    bool receive(unsigned int timeout_ms);
+    bool receiveRing(unsigned int timeout_ms);
+    bool receiveSocket(unsigned int timeout_ms);
+    // Give the current block back to the kernel
+    void release();
+
+    // IPv4 + UDP packet from the ring: check the destination, add the payload
+    void addPacket(const uint8_t* ip, size_t len);
+    // UDP payload: strip RTP, track the sequence, add the TS data
+    void addDatagram(const uint8_t* data, size_t len);
+
+    std::string address_;
+    uint16_t port_;
+    std::string interface_;
+    Mode mode_;
+    uint32_t group_{0};  // Host byte order, 0 = any
+
+    int fd_{-1};           // AF_PACKET (ring) or UDP socket
+    int join_fd_{-1};      // UDP socket holding the membership in ring mode
+    uint8_t* ring_{nullptr};
+    size_t ring_block_{0};
+    bool block_held_{false};
+
+    // Socket mode receive buffers
+    std::vector<uint8_t> buffers_;
+    std::vector<uint8_t> control_;
+
+    // Current batch
+    std::vector<struct iovec> iov_;
+    std::vector<Segment> segments_;
+
+    bool have_seq_{false};
+    uint16_t next_seq_{0};
+
+    size_t datagram_count_{0};
+    size_t rtp_count_{0};
+    size_t sequence_gap_count_{0};
+    size_t lost_datagram_count_{0};
+    size_t invalid_count_{0};
+    uint64_t drop_count_{0};
+    uint32_t socket_drops_{0};  // Last SO_RXQ_OVFL value
+    int error_{0};
+};
+
+template<typename Callback>
+size_t UdpTsReceiver::consume(Callback&& cb, unsigned int timeout_ms) {
+    if (!receive(timeout_ms)) return 0;
+
+    size_t bytes = 0;
+    for (const Segment& seg : segments_) {
+        for (size_t i = seg.first; i < seg.first + seg.count; i++) {
+            bytes += iov_[i].iov_len;
+        }
+        cb(iov_.data() + seg.first, static_cast<int>(seg.count), seg.discontinuity);
+    }
+    release();
+    return bytes;
+}
+
+} // namespace dvbdab
@@ -0,0 +1,107 @@
+#include "subchannel_stats.hpp"
+
+namespace dvbdab {
+
+namespace {
+
+// Delta of a cumulative counter; a smaller value means the decoder restarted
+uint32_t counterDelta(uint64_t value, uint64_t last) {
+    return static_cast<uint32_t>(value >= last ? value - last : value);
+}
+
+} // namespace
+
+SubchannelStats::SubchannelStats()
+    : buckets_(BUCKET_COUNT + 1)
+{
+}
+
+void SubchannelStats::reset() {
+    for (Bucket& b : buckets_) {
+        b = Bucket{};
+    }
+    head_ = 0;
+    closed_ = 0;
+    last_totals_ = {};
+    last_mask_ = 0;
+}
+
+void SubchannelStats::addDecoderTotals(uint8_t subchannel_id, const DecoderTotals& totals) {
+    uint8_t id = subchannel_id & 0x3F;
+    uint64_t bit = uint64_t{1} << id;
+    Bucket& b = buckets_[head_];
+
+    DecoderTotals last = (last_mask_ & bit) ? last_totals_[id] : DecoderTotals{};
+    Entry& e = b.entries[id];
+    e.au_count += counterDelta(totals.au_count, last.au_count);
+    e.au_errors += counterDelta(totals.au_errors, last.au_errors);
+    e.au_bytes += counterDelta(totals.au_bytes, last.au_bytes);
+    e.pad_bytes += counterDelta(totals.pad_bytes, last.pad_bytes);
+    e.superframes += counterDelta(totals.superframes, last.superframes);
+    e.firecode_errors += counterDelta(totals.firecode_errors, last.firecode_errors);
+
+    last_totals_[id] = totals;
+    b.decoded_mask |= bit;
+}
+
+void SubchannelStats::rotate() {
+    // Decoders not sampled in this bucket were stopped
+    last_mask_ = buckets_[head_].decoded_mask;
+
+    head_ = (head_ + 1) % buckets_.size();
+    buckets_[head_] = Bucket{};
+    if (closed_ < BUCKET_COUNT) closed_++;
+}
+
+size_t SubchannelStats::windowBuckets(unsigned int window_ms) const {
+    size_t n = 0;
+    unsigned int duration = 0;
+    while (n < closed_ && duration < window_ms) {
+        duration += buckets_[(head_ + buckets_.size() - 1 - n) % buckets_.size()].duration_ms;
+        n++;
+    }
+    return n;
+}
+
+SubchannelStats::Window SubchannelStats::getWindow(uint8_t subchannel_id, unsigned int window_ms) const {
+    uint8_t id = subchannel_id & 0x3F;
+    uint64_t bit = uint64_t{1} << id;
+
+    Window w;
+    size_t n = windowBuckets(window_ms);
+    for (size_t i = 0; i < n; i++) {
+        const Bucket& b = buckets_[(head_ + buckets_.size() - 1 - i) % buckets_.size()];
+        const Entry& e = b.entries[id];
+        w.duration_ms += b.duration_ms;
+        w.cifs += e.cifs;
+        w.bytes += e.bytes;
+        w.decoder.au_count += e.au_count;
+        w.decoder.au_errors += e.au_errors;
+        w.decoder.au_bytes += e.au_bytes;
+        w.decoder.pad_bytes += e.pad_bytes;
+        w.decoder.superframes += e.superframes;
+        w.decoder.firecode_errors += e.firecode_errors;
+        if (b.decoded_mask & bit) w.decoded = true;
+    }
+    return w;
+}
+
+uint64_t SubchannelStats::getSeenMask(unsigned int window_ms) const {
+    uint64_t mask = 0;
+    size_t n = windowBuckets(window_ms);
+    for (size_t i = 0; i < n; i++) {
+        mask |= buckets_[(head_ + buckets_.size() - 1 - i) % buckets_.size()].seen_mask;
+    }
+    return mask;
+}
+
+unsigned int SubchannelStats::getWindowDuration(unsigned int window_ms) const {
+    unsigned int duration = 0;
+    size_t n = windowBuckets(window_ms);
+    for (size_t i = 0; i < n; i++) {
+        duration += buckets_[(head_ + buckets_.size() - 1 - i) % buckets_.size()].duration_ms;
+    }
+    return duration;
+}
+
+} // namespace dvbdab
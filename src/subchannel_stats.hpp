@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace dvbdab {
+
+// Measured payload per subchannel over rolling windows of stream time
+//
+// The ETI dispatch adds each subchannel stream with addStream() and closes
+// the frame with endFrame(). Every ETI frame is 24 ms of stream time, so no
+// clock is read and a replayed file gives the same figures as live input.
+// Counts are kept in one-second buckets, the last BUCKET_COUNT are retained.
+// Decoder counters are cumulative; they are sampled once per bucket from the
+// endFrame() callback and stored as deltas.
+class SubchannelStats {
+public:
+    static constexpr unsigned int FRAME_MS = 24;
+    static constexpr unsigned int BUCKET_MS = 1000;
+    static constexpr size_t BUCKET_COUNT = 60;
+    static constexpr size_t SUBCHANNEL_COUNT = 64;
+
+    // Cumulative counters of one decoder (since it was created)
+    struct DecoderTotals {
+        uint64_t au_count{0};         // AUs (DAB+) or MP2 frames checked
+        uint64_t au_errors{0};        // AU CRC (DAB+) or header CRC (DAB) failures
+        uint64_t au_bytes{0};         // Valid AU / MP2 frame bytes, PAD included
+        uint64_t pad_bytes{0};        // PAD within them
+        uint64_t superframes{0};      // DAB+ superframe starts checked
+        uint64_t firecode_errors{0};  // DAB+ superframe starts failing FireCode
+    };
+
+    // Sum over a window
+    struct Window {
+        unsigned int duration_ms{0};  // Stream time covered
+        uint64_t cifs{0};             // ETI frames carrying the subchannel
+        uint64_t bytes{0};            // MSC stream bytes
+        bool decoded{false};          // A decoder was sampled in the window
+        DecoderTotals decoder;
+    };
+
+    SubchannelStats();
+
+    // One subchannel stream of the current ETI frame
+    void addStream(uint8_t subchannel_id, size_t bytes) {
+        Bucket& b = buckets_[head_];
+        Entry& e = b.entries[subchannel_id & 0x3F];
+        e.cifs++;
+        e.bytes += static_cast<uint32_t>(bytes);
+        b.seen_mask |= uint64_t{1} << (subchannel_id & 0x3F);
+    }
+
+    // End of an ETI frame. When a bucket is complete, sample(*this) is called
+    // first so the decoders can report their totals with addDecoderTotals().
+    template<typename Fn>
+    void endFrame(Fn&& sample) {
+        Bucket& b = buckets_[head_];
+        b.duration_ms += FRAME_MS;
+        if (b.duration_ms < BUCKET_MS) return;
+        sample(*this);
+        rotate();
+    }
+
+    // Cumulative decoder counters for a subchannel (only from the sample callback)
+    void addDecoderTotals(uint8_t subchannel_id, const DecoderTotals& totals);
+
+    // Sum of the newest complete buckets covering at least window_ms (or all kept)
+    Window getWindow(uint8_t subchannel_id, unsigned int window_ms) const;
+
+    // Subchannels carried in the window (bit n = subchannel n)
+    uint64_t getSeenMask(unsigned int window_ms) const;
+
+    // Stream time covered by the window
+    unsigned int getWindowDuration(unsigned int window_ms) const;
+
+    void reset();
+
+private:
+    // Per subchannel and bucket; 32 bits hold one second at any bitrate
+    struct Entry {
+        uint32_t cifs;
+        uint32_t bytes;
+        uint32_t au_count;
+        uint32_t au_errors;
+        uint32_t au_bytes;
+        uint32_t pad_bytes;
+        uint32_t superframes;
+        uint32_t firecode_errors;
+    };
+
+    struct Bucket {
+        unsigned int duration_ms{0};
+        uint64_t seen_mask{0};      // Subchannels carried
+        uint64_t decoded_mask{0};   // Subchannels with a decoder sampled
+        std::array<Entry, SUBCHANNEL_COUNT> entries{};
+    };
+
+    void rotate();
+
+    // Closed buckets to sum for window_ms, newest first from head_ - 1
+    size_t windowBuckets(unsigned int window_ms) const;
+
+    // Ring of BUCKET_COUNT closed buckets plus the open one at head_
+    std::vector<Bucket> buckets_;
+    size_t head_{0};
+    size_t closed_{0};
+
+    // Last sampled decoder totals; a subchannel not sampled in a bucket
+    // (decoder stopped) starts again from zero
+    std::array<DecoderTotals, SUBCHANNEL_COUNT> last_totals_{};
+    uint64_t last_mask_{0};
+};
+
+} // namespace dvbdab
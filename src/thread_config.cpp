@@ -0,0 +1,140 @@
+// Thread placement for library threads (see setThreadConfig)
+
+#include "thread_config.hpp"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace dvbdab {
+
+namespace {
+
+constexpr size_t ROLE_COUNT = 4;
+
+std::mutex config_mutex;
+std::array<ThreadConfig, ROLE_COUNT> configs;
+
+const char* threadName(ThreadRole role) {
+    switch (role) {
+        case ThreadRole::DvrReader: return "dvbdab-dvr";
+        case ThreadRole::AsyncFeed: return "dvbdab-feed";
+        case ThreadRole::UdpSender: return "dvbdab-udp";
+        case ThreadRole::Recorder: return "dvbdab-rec";
+    }
+    return "dvbdab";
+}
+
+// CPUs of a NUMA node from sysfs ("0-7,16-23")
+std::vector<int> nodeCpus(int node) {
+    std::vector<int> cpus;
+    char path[64];
+    std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    FILE* f = std::fopen(path, "r");
+    if (!f) return cpus;
+
+    int first = 0;
+    int last = 0;
+    while (std::fscanf(f, "%d", &first) == 1) {
+        last = first;
+        int c = std::fgetc(f);
+        if (c == '-') {
+            if (std::fscanf(f, "%d", &last) != 1) break;
+            c = std::fgetc(f);
+        }
+        for (int cpu = first; cpu <= last; cpu++) {
+            cpus.push_back(cpu);
+        }
+        if (c != ',') break;
+    }
+    std::fclose(f);
+    return cpus;
+}
+
+// Prefer allocations of the calling thread on a node (set_mempolicy, no libnuma)
+void setPreferredNode(int node) {
+#ifdef SYS_set_mempolicy
+    constexpr int MPOL_PREFERRED_MODE = 1;
+    constexpr int MASK_BITS = sizeof(unsigned long) * 8;
+    if (node < 0 || node >= MASK_BITS) return;
+    unsigned long mask = 1UL << node;
+    syscall(SYS_set_mempolicy, MPOL_PREFERRED_MODE, &mask, MASK_BITS + 1);
+#else
+    (void)node;
+#endif
+}
+
+// Bind pages to a node and migrate those already touched (mbind, no libnuma)
+void bindPages(void* addr, size_t len, int node) {
+#ifdef SYS_mbind
+    constexpr int MPOL_PREFERRED_MODE = 1;
+    constexpr unsigned int MPOL_MF_MOVE_FLAG = 1 << 1;
+    constexpr int MASK_BITS = sizeof(unsigned long) * 8;
+    if (node < 0 || node >= MASK_BITS || !addr || len == 0) return;
+    long page = sysconf(_SC_PAGESIZE);
+    if (page <= 0) return;
+    uintptr_t start = reinterpret_cast<uintptr_t>(addr) & ~static_cast<uintptr_t>(page - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(addr) + len;
+    unsigned long mask = 1UL << node;
+    syscall(SYS_mbind, start, end - start, MPOL_PREFERRED_MODE, &mask, MASK_BITS + 1, MPOL_MF_MOVE_FLAG);
+#else
+    (void)addr;
+    (void)len;
+    (void)node;
+#endif
+}
+
+size_t roleIndex(ThreadRole role) {
+    return static_cast<size_t>(role);
+}
+
+} // namespace
+
+void setThreadConfig(ThreadRole role, const ThreadConfig& config) {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    configs[roleIndex(role)] = config;
+}
+
+ThreadConfig getThreadConfig(ThreadRole role) {
+    std::lock_guard<std::mutex> lock(config_mutex);
+    return configs[roleIndex(role)];
+}
+
+void applyThreadConfig(ThreadRole role) {
+    pthread_setname_np(pthread_self(), threadName(role));  // Max 15 chars
+
+    ThreadConfig cfg = getThreadConfig(role);
+
+    std::vector<int> cpus = cfg.cpus;
+    if (cpus.empty() && cfg.numa_node >= 0) {
+        cpus = nodeCpus(cfg.numa_node);
+    }
+    if (!cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+
+    if (cfg.policy >= 0) {
+        struct sched_param param{};
+        param.sched_priority = cfg.priority;
+        pthread_setschedparam(pthread_self(), cfg.policy, &param);
+    }
+
+    if (cfg.numa_node >= 0) {
+        setPreferredNode(cfg.numa_node);
+    }
+}
+
+void bindToRoleNode(ThreadRole role, void* addr, size_t len) {
+    bindPages(addr, len, getThreadConfig(role).numa_node);
+}
+
+} // namespace dvbdab
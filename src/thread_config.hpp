@@ -0,0 +1,15 @@
+#pragma once
+
+#include <dvbdab/dvbdab.hpp>
+
+namespace dvbdab {
+
+// Name the calling thread after its role and apply the configured affinity,
+// scheduler and NUMA memory policy. Called first in every library thread.
+void applyThreadConfig(ThreadRole role);
+
+// Move the pages of [addr, addr + len) to the NUMA node configured for a role
+// (mbind, whole pages) and keep them there. No-op if the role has no node.
+void bindToRoleNode(ThreadRole role, void* addr, size_t len);
+
+} // namespace dvbdab
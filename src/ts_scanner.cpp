@@ -3,11 +3,15 @@
 #include <dvbdab/ts_scanner.hpp>
 #include "parsers/mpe_parser.hpp"
 #include "parsers/udp_extractor.hpp"
+#include "sources/gse_ts_source.hpp"
+#include "sources/bbf_ts_source.hpp"
 #include "etina_pipeline.hpp"
+#include "sources/ts_sync.hpp"
 #include "ensemble_manager.hpp"
 #include "dab_parser.h"
+#include "clock.hpp"
 #include <array>
-#include <chrono>
+#include <atomic>
 #include <fstream>
 #include <map>
 #include <vector>
@@ -46,8 +50,36 @@ struct PidState {
     bool tsni_streaming{false};   // True when TSNI confirmed and streaming ETI-NI
     bool tsni_detection_reported{false};
     std::unique_ptr<lsdvb::DABParser> tsni_fic_parser;
+
+    // GSE-in-TS / BBF pseudo-TS detection (continuous PIDs, like ETI-NA)
+    int bbf_header_count{0};       // Packets with the pseudo-TS header (00 80 00)
+    bool bbf_start_seen{false};    // BBFrame sync byte seen at a start position
+    bool gse_candidate{false};     // GSE trial running
+    bool is_gse{false};            // Confirmed: GSE produced a valid IPv4 packet
+    bool is_bbf{false};            // Confirmed by pseudo-TS signature
+    int gse_trial_packets{0};      // Packets fed to the GSE trial
+    std::unique_ptr<GseTsSource> gse_source;
+    std::unique_ptr<BbfTsSource> bbf_source;
+
+    // Progressive reporting (ETI-NA / TSNI basic-ready sent once per PID)
+    bool basic_ready_reported{false};
 };
 
+// Valid IPv4 header (version, length, checksum) - confirms a GSE candidate
+static bool isValidIpv4Header(const uint8_t* ip, size_t len) {
+    if (len < 20 || (ip[0] >> 4) != 4) return false;
+    size_t hdr_len = (ip[0] & 0x0F) * 4;
+    if (hdr_len < 20 || hdr_len > len) return false;
+    uint32_t sum = 0;
+    for (size_t i = 0; i < hdr_len; i += 2) {
+        sum += (ip[i] << 8) | ip[i + 1];
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return sum == 0xFFFF;
+}
+
 struct TsScanner::Impl {
     // Hybrid PID tracking: static array for O(1) lookup
     std::array<PidState, 8192> pids;
@@ -55,6 +87,10 @@ struct TsScanner::Impl {
     // List of PIDs that are confirmed MPE
     std::vector<uint16_t> mpe_pids;
 
+    // PIDs confirmed as GSE-in-TS or BBF pseudo-TS
+    std::vector<uint16_t> gse_pids;
+    static constexpr int GSE_TRIAL_PACKETS = 2000;  // Give up GSE trial without a valid IPv4 packet
+
     // ETI-NA detection results
     std::vector<EtiNaDetectionInfo> etina_results;
     static constexpr int ETINA_PACKET_THRESHOLD = 100;  // Check for no-PUSI after this many packets
@@ -87,13 +123,18 @@ struct TsScanner::Impl {
     std::vector<DiscoveredEnsemble> results;  // Built from map on getResults()
 
     // Timing
-    std::chrono::steady_clock::time_point start_time;
+    Clock clock;
     unsigned int timeout_ms{500};
     bool started{false};
     bool done{false};
+    std::atomic<bool> cancelled{false};
+
+    // Progressive reporting
+    EnsembleFoundCallback ensemble_callback;
+    bool report_basic_ready{false};
 
-    // Partial TS packet buffer
-    std::vector<uint8_t> partial_ts;
+    // TS sync (any alignment, 188/192/204-byte packets)
+    TsSync ts_sync;
 
     // Helper to convert MPE ensemble to DiscoveredEnsemble
     DiscoveredEnsemble toDiscovered(const StreamKey& key, const lsdvb::DABEnsemble& ens) {
@@ -107,6 +148,12 @@ struct TsScanner::Impl {
         auto pid_it = stream_pid_map.find(key);
         if (pid_it != stream_pid_map.end()) {
             de.pid = pid_it->second;
+            const PidState& state = pids[de.pid];
+            if (state.is_bbf) {
+                de.format = EnsembleFormat::BBF;
+            } else if (state.is_gse) {
+                de.format = EnsembleFormat::GSE;
+            }
         }
 
         for (const auto& svc : ens.services) {
@@ -131,6 +178,7 @@ struct TsScanner::Impl {
         de.eid = ens.eid;
         de.label = ens.label;
         de.is_etina = true;
+        de.format = EnsembleFormat::ETI_NA;
         de.etina_info.padding_bytes = info.padding_bytes;
         de.etina_info.sync_bit_offset = info.sync_bit_offset;
         de.etina_info.inverted = info.inverted;
@@ -156,6 +204,7 @@ struct TsScanner::Impl {
         de.eid = ens.eid;
         de.label = ens.label;
         de.is_tsni = true;  // Mark as TSNI format
+        de.format = EnsembleFormat::TSNI;
 
         for (const auto& svc : ens.services) {
             DiscoveredService ds;
@@ -174,19 +223,28 @@ struct TsScanner::Impl {
               onUdp(ip, port, payload, len);
           })
     {
-        partial_ts.reserve(TS_PACKET_SIZE);
-
         // Set up basic_ready callback - store partial results immediately
         ensemble_manager.setBasicReadyCallback([this](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
             results_map[key] = toDiscovered(key, ens);
+            if (report_basic_ready) {
+                notify(results_map[key], false);
+            }
         });
 
         // Set up complete callback - update with full labels
         ensemble_manager.setCompleteCallback([this](const StreamKey& key, const lsdvb::DABEnsemble& ens) {
             results_map[key] = toDiscovered(key, ens);
+            notify(results_map[key], true);
         });
     }
 
+    // Report ensemble to progressive callback; false from callback ends the scan
+    void notify(const DiscoveredEnsemble& de, bool complete) {
+        if (ensemble_callback && !done && !ensemble_callback(de, complete)) {
+            done = true;
+        }
+    }
+
     void onUdp(uint32_t ip, uint16_t port, const uint8_t* payload, size_t len) {
         // Check for multicast IP (224.x.x.x - 239.x.x.x)
         uint8_t first_octet = (ip >> 24) & 0xFF;
@@ -202,7 +260,36 @@ struct TsScanner::Impl {
 
     void onIpPacket(uint16_t pid, const uint8_t* ip_data, size_t len) {
         current_pid = pid;  // Track which PID this IP packet came from
-        udp_extractor.process(ip_data, len);
+        udp_extractor.process(ip_data, len, clock);
+    }
+
+    // GSE trial: run a GSE source on the PID until it yields a valid IPv4
+    // packet (confirmed) or GSE_TRIAL_PACKETS pass without one (dropped)
+    void processGseCandidate(PidState& state, uint16_t pid, const uint8_t* ts) {
+        if (!state.gse_source) {
+            state.gse_source = std::make_unique<GseTsSource>();
+            state.gse_source->setIpCallback([this, &state, pid](const uint8_t* ip_data, size_t len) {
+                if (!state.is_gse && isValidIpv4Header(ip_data, len)) {
+                    // GSE confirmed - stop the ETI-NA trial on this PID
+                    state.is_gse = true;
+                    state.gse_candidate = false;
+                    state.etina_checked = true;
+                    state.etina_candidate = false;
+                    state.etina_pipeline.reset();
+                    state.etina_fic_parser.reset();
+                    gse_pids.push_back(pid);
+                }
+                if (state.is_gse) {
+                    onIpPacket(pid, ip_data, len);
+                }
+            });
+        }
+        state.gse_source->feedPacket(ts);
+
+        if (!state.is_gse && ++state.gse_trial_packets >= GSE_TRIAL_PACKETS) {
+            state.gse_candidate = false;
+            state.gse_source.reset();
+        }
     }
 
     void processTsPacket(const uint8_t* ts) {
@@ -221,14 +308,35 @@ struct TsScanner::Impl {
         uint8_t adapt_ctrl = (ts[3] >> 4) & 3;
         uint8_t cc = ts[3] & 0x0F;
 
-        // Skip packets with errors or null PID
-        if (tei || pid == 0x1FFF) {
+        // Skip packets with errors
+        if (tei) {
             return;
         }
 
         // Get PID state
         PidState& state = pids[pid];
 
+        // Confirmed GSE-in-TS / BBF pseudo-TS: the whole packet goes to the source
+        if (state.is_bbf) {
+            state.bbf_source->feedPacket(ts);
+            return;
+        }
+        if (state.is_gse) {
+            state.gse_source->feedPacket(ts);
+            return;
+        }
+
+        // Null PID: only GSE-in-TS may be carried there, trial from the first packet
+        if (pid == 0x1FFF) {
+            if (state.gse_trial_packets == 0) {
+                state.gse_candidate = true;
+            }
+            if (state.gse_candidate) {
+                processGseCandidate(state, pid, ts);
+            }
+            return;
+        }
+
         // Initialize on first packet
         if (!state.active) {
             state.active = true;
@@ -358,7 +466,15 @@ struct TsScanner::Impl {
 
                         if (state.tsni_fic_parser->is_complete()) {
                             const auto& ens = state.tsni_fic_parser->get_ensemble();
+                            bool first = tsni_ensembles.find(pid) == tsni_ensembles.end();
                             tsni_ensembles[pid] = toDiscoveredTsni(pid, ens);
+                            if (first) {
+                                notify(tsni_ensembles[pid], true);
+                            }
+                        } else if (report_basic_ready && !state.basic_ready_reported &&
+                                   state.tsni_fic_parser->is_basic_ready()) {
+                            state.basic_ready_reported = true;
+                            notify(toDiscoveredTsni(pid, state.tsni_fic_parser->get_ensemble()), false);
                         }
                     }
                 }
@@ -380,6 +496,40 @@ struct TsScanner::Impl {
             state.pusi_count++;
         }
 
+        // BBF pseudo-TS signature (checked until the threshold)
+        if (state.packet_count <= ETINA_PACKET_THRESHOLD) {
+            if (ts[4] == 0x00 && ts[5] == 0x80 && ts[6] == 0x00 && ts[7] <= TS_PACKET_SIZE - 8) {
+                state.bbf_header_count++;
+                if (ts[8] == BBF_SYNC_BYTE) {
+                    state.bbf_start_seen = true;
+                }
+            }
+        }
+
+        // At the threshold, classify continuous PIDs: every packet with the
+        // pseudo-TS header -> BBF; no PUSI at all -> try GSE next to ETI-NA
+        if (state.packet_count == ETINA_PACKET_THRESHOLD && !state.is_mpe && !state.is_tsni) {
+            if (state.bbf_header_count == ETINA_PACKET_THRESHOLD && state.bbf_start_seen) {
+                state.is_bbf = true;
+                state.etina_checked = true;  // Not ETI-NA
+                state.bbf_source = std::make_unique<BbfTsSource>();
+                state.bbf_source->setIpCallback([this, pid](const uint8_t* ip_data, size_t len) {
+                    onIpPacket(pid, ip_data, len);
+                });
+                gse_pids.push_back(pid);
+                return;
+            }
+            if (state.pusi_count == 0) {
+                state.gse_candidate = true;
+            }
+        }
+        if (state.gse_candidate) {
+            processGseCandidate(state, pid, ts);
+            if (state.is_gse) {
+                return;
+            }
+        }
+
         // ETI-NA detection: check PIDs after threshold
         // Try ETI-NA for any non-MPE, non-TSNI PID with enough traffic
         if (!state.etina_checked && !state.is_mpe && !state.is_tsni &&
@@ -419,15 +569,24 @@ struct TsScanner::Impl {
                     if (state.etina_fic_parser) {
                         state.etina_fic_parser->process_eti_frame(eti_ni, len);
 
+                        EtiNaDetectionInfo det;
+                        det.pid = pid;
+                        det.padding_bytes = state.etina_pipeline->offset.detected_offset;
+                        det.sync_bit_offset = state.etina_pipeline->e1.bit_offset;
+                        det.inverted = state.etina_pipeline->e1.inverted;
+
                         // Check if FIC parser has all labels (full discovery complete)
                         if (state.etina_fic_parser->is_complete()) {
                             const auto& ens = state.etina_fic_parser->get_ensemble();
-                            EtiNaDetectionInfo det;
-                            det.pid = pid;
-                            det.padding_bytes = state.etina_pipeline->offset.detected_offset;
-                            det.sync_bit_offset = state.etina_pipeline->e1.bit_offset;
-                            det.inverted = state.etina_pipeline->e1.inverted;
+                            bool first = etina_ensembles.find(pid) == etina_ensembles.end();
                             etina_ensembles[pid] = toDiscoveredEtina(pid, ens, det);
+                            if (first) {
+                                notify(etina_ensembles[pid], true);
+                            }
+                        } else if (report_basic_ready && !state.basic_ready_reported &&
+                                   state.etina_fic_parser->is_basic_ready()) {
+                            state.basic_ready_reported = true;
+                            notify(toDiscoveredEtina(pid, state.etina_fic_parser->get_ensemble(), det), false);
                         }
                     }
                 });
@@ -444,6 +603,9 @@ struct TsScanner::Impl {
     }
 
     int feed(const uint8_t* data, size_t len) {
+        if (cancelled.load(std::memory_order_relaxed)) {
+            done = true;
+        }
         if (done) {
             return 1;
         }
@@ -451,40 +613,26 @@ struct TsScanner::Impl {
         // Start timing on first feed
         if (!started) {
             started = true;
-            start_time = std::chrono::steady_clock::now();
+            clock.start();
         }
 
-        size_t pos = 0;
-
-        // Handle partial TS packet from previous feed
-        if (!partial_ts.empty()) {
-            size_t needed = TS_PACKET_SIZE - partial_ts.size();
-            if (len < needed) {
-                partial_ts.insert(partial_ts.end(), data, data + len);
-                return 0;
+        // Process TS packets (skip the rest as soon as the ensemble callback ends the scan)
+        bool media_time = clock.isMedia();
+        ts_sync.feed(data, len, [this, media_time](const uint8_t* ts) {
+            if (!done) {
+                if (media_time) {
+                    clock.onTsPacket(ts);
+                }
+                processTsPacket(ts);
             }
-
-            partial_ts.insert(partial_ts.end(), data, data + needed);
-            pos = needed;
-            processTsPacket(partial_ts.data());
-            partial_ts.clear();
-        }
-
-        // Process complete TS packets
-        while (pos + TS_PACKET_SIZE <= len) {
-            processTsPacket(data + pos);
-            pos += TS_PACKET_SIZE;
-        }
-
-        // Save remaining partial TS packet
-        if (pos < len) {
-            partial_ts.assign(data + pos, data + len);
+        });
+        if (done) {
+            return 1;
         }
 
         // Check timeout
-        auto elapsed = std::chrono::steady_clock::now() - start_time;
-        auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
-        if (static_cast<unsigned int>(elapsed_ms) >= timeout_ms) {
+        uint64_t elapsed_ms = clock.elapsedMs();
+        if (elapsed_ms >= timeout_ms) {
             done = true;
             return 1;
         }
@@ -516,20 +664,21 @@ struct TsScanner::Impl {
 
         // Early exit if no DAB found after 1 second
         // This avoids waiting for full timeout on streams with no DAB traffic
-        if (static_cast<unsigned int>(elapsed_ms) >= EARLY_EXIT_MS &&
+        if (elapsed_ms >= EARLY_EXIT_MS &&
             mpe_pids.empty() &&
+            gse_pids.empty() &&
             etina_streaming_pids.empty() &&
             tsni_streaming_pids.empty() &&
             results_map.empty()) {
-            // No MPE sections, no ETI-NA, no TSNI, no ensembles after 1 second - no DAB here
+            // No MPE/GSE/BBF, no ETI-NA, no TSNI, no ensembles after 1 second - no DAB here
             done = true;
             return 1;
         }
 
-        // Exit if MPE sections seen but no ensembles discovered after 3 seconds
-        // MPE table_id 0x3E is also used for non-DAB data broadcasting
-        if (static_cast<unsigned int>(elapsed_ms) >= MPE_EXIT_MS &&
-            !mpe_pids.empty() &&
+        // Exit if MPE/GSE/BBF seen but no ensembles discovered after 3 seconds
+        // (IP encapsulation is also used for non-DAB data broadcasting)
+        if (elapsed_ms >= MPE_EXIT_MS &&
+            (!mpe_pids.empty() || !gse_pids.empty()) &&
             results_map.empty()) {
             // MPE without DAB ensembles - not DAB content
             done = true;
@@ -551,10 +700,27 @@ void TsScanner::setTimeout(unsigned int timeout_ms) {
     impl_->timeout_ms = timeout_ms;
 }
 
+void TsScanner::setClock(ClockMode mode) {
+    impl_->clock.setMode(mode);
+}
+
+void TsScanner::setClock(ClockFunction clock) {
+    impl_->clock.setFunction(std::move(clock));
+}
+
 int TsScanner::feed(const uint8_t* data, size_t len) {
     return impl_->feed(data, len);
 }
 
+void TsScanner::setEnsembleCallback(EnsembleFoundCallback callback, bool report_basic_ready) {
+    impl_->ensemble_callback = std::move(callback);
+    impl_->report_basic_ready = report_basic_ready;
+}
+
+void TsScanner::cancel() {
+    impl_->cancelled.store(true, std::memory_order_relaxed);
+}
+
 std::vector<DiscoveredEnsemble> TsScanner::getResults() {
     // Build results from MPE ensembles
     std::vector<DiscoveredEnsemble> results;
@@ -585,6 +751,10 @@ std::vector<uint16_t> TsScanner::getMpePids() const {
     return impl_->mpe_pids;
 }
 
+std::vector<uint16_t> TsScanner::getGsePids() const {
+    return impl_->gse_pids;
+}
+
 std::vector<EtiNaDetectionInfo> TsScanner::getEtiNaResults() const {
     return impl_->etina_results;
 }
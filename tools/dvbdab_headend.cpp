@@ -0,0 +1,724 @@
+// dvbdab-headend - DAB headend daemon built on libdvbdab
+//
+// Reads TS from DVR devices, fds, files or UDP/RTP multicast, runs one streamer per configured
+// ensemble and sends the resulting MPEG-TS to UDP/RTP or to a file.
+//
+// Usage: dvbdab-headend <config-file>
+//
+// Config file (INI style, '#' or ';' starts a comment line):
+//
+//   [headend]
+//   stats_interval = 10              # Seconds between statistics, 0 = off
+//
+//   [input dvr0]
+//   path = /dev/dvb/adapter0/dvr0    # Device, FIFO or TS file
+//   # fd = 3                         # Or an already open (tuned) fd
+//   ring_size = 16777216             # Optional reader ring size
+//   # udp = 239.1.2.3:5000           # Or TS over UDP/RTP (SAT>IP, minisatip)
+//   # interface = eth0               # UDP: receive through an mmap ring on this interface
+//
+//   [pipeline radio]
+//   input = dvr0
+//   format = mpe                     # mpe, gse, bbf, eti-na, tsni, edi
+//   pid = 701
+//   ip = 239.199.2.1                 # MPE/GSE/BBF: EDI stream (edi: input is a raw AF stream)
+//   port = 1234
+//   # eti_padding / eti_bit_offset / eti_inverted for eti-na
+//   eid = 0x1001                     # Optional: expected ensemble ID
+//   services = all                   # all, or SIDs / "labels", comma separated
+//   output = udp://239.10.0.1:5004   # udp://, rtp:// or file:///path.ts
+//   ttl = 4
+//   interface = 192.168.1.10         # Multicast interface address
+//
+// SIGHUP reloads the config file. Inputs and pipelines whose settings did not
+// change keep running; changed ones are restarted, removed ones stopped.
+// SIGINT / SIGTERM stop the daemon.
+
+#include <dvbdab/dvbdab_c.h>
+#include "sources/dvr_reader.hpp"
+#include "sources/udp_ts_receiver.hpp"
+#include "output/ts_streamer.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+volatile sig_atomic_t g_stop = 0;
+volatile sig_atomic_t g_reload = 0;
+
+void onSignal(int sig) {
+    if (sig == SIGHUP) {
+        g_reload = 1;
+    } else {
+        g_stop = 1;
+    }
+}
+
+// =============================================================================
+// Configuration
+// =============================================================================
+
+struct InputConfig {
+    std::string path;
+    int fd{-1};
+    size_t ring_size{0};
+    std::string udp_address;  // TS over UDP/RTP
+    uint16_t udp_port{0};
+    std::string interface;
+
+    bool operator==(const InputConfig&) const = default;
+};
+
+struct PipelineConfig {
+    std::string input;
+    dvbdab_format_t format{DVBDAB_FORMAT_MPE};
+    uint16_t pid{0};
+    uint32_t ip{0};
+    uint16_t port{0};
+    uint8_t eti_padding{12};
+    uint8_t eti_bit_offset{0};
+    uint8_t eti_inverted{0};
+    uint16_t eid{0};
+    std::vector<std::string> services;  // Empty = all
+    std::string output;
+    int ttl{1};
+    std::string interface;
+
+    bool operator==(const PipelineConfig&) const = default;
+};
+
+struct Config {
+    unsigned int stats_interval{10};
+    std::map<std::string, InputConfig> inputs;
+    std::map<std::string, PipelineConfig> pipelines;
+};
+
+std::string trim(const std::string& s) {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    if (b == std::string::npos) return {};
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return s.substr(b, e - b + 1);
+}
+
+std::string unquote(const std::string& s) {
+    if (s.size() >= 2 && s.front() == '"' && s.back() == '"') {
+        return s.substr(1, s.size() - 2);
+    }
+    return s;
+}
+
+// Split a comma separated list; commas inside quotes are kept
+std::vector<std::string> splitList(const std::string& s) {
+    std::vector<std::string> out;
+    std::string item;
+    bool quoted = false;
+    for (char c : s) {
+        if (c == '"') quoted = !quoted;
+        if (c == ',' && !quoted) {
+            out.push_back(trim(item));
+            item.clear();
+        } else {
+            item += c;
+        }
+    }
+    if (!trim(item).empty()) out.push_back(trim(item));
+    return out;
+}
+
+bool parseNumber(const std::string& s, unsigned long max, unsigned long& out) {
+    try {
+        size_t pos = 0;
+        out = std::stoul(s, &pos, 0);
+        return pos == s.size() && out <= max;
+    } catch (...) {
+        return false;
+    }
+}
+
+bool parseFormat(const std::string& s, dvbdab_format_t& out) {
+    if (s == "mpe") out = DVBDAB_FORMAT_MPE;
+    else if (s == "gse") out = DVBDAB_FORMAT_GSE;
+    else if (s == "bbf" || s == "bbf-ts") out = DVBDAB_FORMAT_BBF_TS;
+    else if (s == "eti-na" || s == "etina") out = DVBDAB_FORMAT_ETI_NA;
+    else if (s == "tsni") out = DVBDAB_FORMAT_TSNI;
+    else if (s == "edi") out = DVBDAB_FORMAT_EDI;
+    else return false;
+    return true;
+}
+
+bool parseConfig(const std::string& path, Config& cfg, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    std::string section;
+    std::string name;
+    int line_no = 0;
+
+    auto fail = [&](const std::string& msg) {
+        error = path + ":" + std::to_string(line_no) + ": " + msg;
+        return false;
+    };
+
+    while (std::getline(file, line)) {
+        line_no++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+
+        if (line.front() == '[') {
+            if (line.back() != ']') return fail("bad section header");
+            std::string header = trim(line.substr(1, line.size() - 2));
+            size_t sp = header.find_first_of(" \t");
+            section = header.substr(0, sp);
+            name = sp == std::string::npos ? std::string{} : unquote(trim(header.substr(sp)));
+            if (section == "input") {
+                if (name.empty()) return fail("input needs a name");
+                cfg.inputs[name];
+            } else if (section == "pipeline") {
+                if (name.empty()) return fail("pipeline needs a name");
+                cfg.pipelines[name];
+            } else if (section != "headend") {
+                return fail("unknown section '" + section + "'");
+            }
+            continue;
+        }
+
+        size_t eq = line.find('=');
+        if (eq == std::string::npos || section.empty()) return fail("expected key = value");
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+        unsigned long num = 0;
+
+        if (section == "headend") {
+            if (key == "stats_interval" && parseNumber(value, 86400, num)) {
+                cfg.stats_interval = static_cast<unsigned int>(num);
+            } else {
+                return fail("bad headend setting '" + key + "'");
+            }
+        } else if (section == "input") {
+            InputConfig& in = cfg.inputs[name];
+            if (key == "path") {
+                in.path = unquote(value);
+            } else if (key == "fd" && parseNumber(value, 65535, num)) {
+                in.fd = static_cast<int>(num);
+            } else if (key == "ring_size" && parseNumber(value, 1UL << 31, num)) {
+                in.ring_size = num;
+            } else if (key == "udp") {
+                size_t colon = value.rfind(':');
+                if (colon == std::string::npos || !parseNumber(value.substr(colon + 1), 65535, num) || num == 0) {
+                    return fail("udp needs address:port");
+                }
+                in.udp_address = value.substr(0, colon);
+                in.udp_port = static_cast<uint16_t>(num);
+            } else if (key == "interface") {
+                in.interface = value;
+            } else {
+                return fail("bad input setting '" + key + "'");
+            }
+        } else {
+            PipelineConfig& pl = cfg.pipelines[name];
+            in_addr addr{};
+            if (key == "input") {
+                pl.input = value;
+            } else if (key == "format") {
+                if (!parseFormat(value, pl.format)) return fail("unknown format '" + value + "'");
+            } else if (key == "pid" && parseNumber(value, 8191, num)) {
+                pl.pid = static_cast<uint16_t>(num);
+            } else if (key == "ip" && inet_pton(AF_INET, value.c_str(), &addr) == 1) {
+                pl.ip = ntohl(addr.s_addr);
+            } else if (key == "port" && parseNumber(value, 65535, num)) {
+                pl.port = static_cast<uint16_t>(num);
+            } else if (key == "eti_padding" && parseNumber(value, 255, num)) {
+                pl.eti_padding = static_cast<uint8_t>(num);
+            } else if (key == "eti_bit_offset" && parseNumber(value, 7, num)) {
+                pl.eti_bit_offset = static_cast<uint8_t>(num);
+            } else if (key == "eti_inverted" && parseNumber(value, 1, num)) {
+                pl.eti_inverted = static_cast<uint8_t>(num);
+            } else if (key == "eid" && parseNumber(value, 0xFFFF, num)) {
+                pl.eid = static_cast<uint16_t>(num);
+            } else if (key == "services") {
+                pl.services.clear();
+                if (value != "all") pl.services = splitList(value);
+            } else if (key == "output") {
+                pl.output = value;
+            } else if (key == "ttl" && parseNumber(value, 255, num)) {
+                pl.ttl = static_cast<int>(num);
+            } else if (key == "interface") {
+                pl.interface = value;
+            } else {
+                return fail("bad pipeline setting '" + key + "'");
+            }
+        }
+    }
+
+    for (const auto& [in_name, in] : cfg.inputs) {
+        if (!in.path.empty() + (in.fd >= 0) + (in.udp_port != 0) != 1) {
+            error = "input " + in_name + ": set exactly one of path, fd and udp";
+            return false;
+        }
+    }
+    for (const auto& [pl_name, pl] : cfg.pipelines) {
+        if (!cfg.inputs.count(pl.input)) {
+            error = "pipeline " + pl_name + ": unknown input '" + pl.input + "'";
+            return false;
+        }
+        if (pl.output.empty()) {
+            error = "pipeline " + pl_name + ": no output";
+            return false;
+        }
+    }
+    return true;
+}
+
+// =============================================================================
+// Outputs
+// =============================================================================
+
+class Output {
+public:
+    virtual ~Output() = default;
+    virtual void write(const uint8_t* data, size_t len) = 0;
+};
+
+class UdpOutput : public Output {
+public:
+    bool open(const std::string& host, uint16_t port, bool rtp, int ttl, const std::string& interface) {
+        streamer_.setDestination(host, port);
+        streamer_.setTtl(ttl);
+        streamer_.setRtp(rtp);
+        if (!interface.empty()) streamer_.setInterface(interface);
+        return streamer_.start();
+    }
+    void write(const uint8_t* data, size_t len) override { streamer_.sendPackets(data, len); }
+
+private:
+    dvbdab::UdpTsStreamer streamer_;
+};
+
+class FileOutput : public Output {
+public:
+    ~FileOutput() override {
+        if (file_) std::fclose(file_);
+    }
+    bool open(const std::string& path) {
+        file_ = std::fopen(path.c_str(), "wb");
+        return file_ != nullptr;
+    }
+    void write(const uint8_t* data, size_t len) override { std::fwrite(data, 1, len, file_); }
+
+private:
+    FILE* file_{nullptr};
+};
+
+std::unique_ptr<Output> openOutput(const PipelineConfig& cfg) {
+    const std::string& url = cfg.output;
+    if (url.rfind("file://", 0) == 0) {
+        auto out = std::make_unique<FileOutput>();
+        if (!out->open(url.substr(7))) return nullptr;
+        return out;
+    }
+
+    bool rtp = url.rfind("rtp://", 0) == 0;
+    if (!rtp && url.rfind("udp://", 0) != 0) return nullptr;
+    std::string hostport = url.substr(6);
+    size_t colon = hostport.rfind(':');
+    unsigned long port = 0;
+    if (colon == std::string::npos || !parseNumber(hostport.substr(colon + 1), 65535, port)) {
+        return nullptr;
+    }
+    auto out = std::make_unique<UdpOutput>();
+    if (!out->open(hostport.substr(0, colon), static_cast<uint16_t>(port), rtp, cfg.ttl, cfg.interface)) {
+        return nullptr;
+    }
+    return out;
+}
+
+// =============================================================================
+// Pipelines and inputs
+// =============================================================================
+
+// One streamer (ensemble) with its output
+struct Pipeline {
+    std::string name;
+    PipelineConfig cfg;
+    dvbdab_streamer_t* streamer{nullptr};
+    std::unique_ptr<Output> output;
+    bool eid_checked{false};
+    std::set<uint8_t> started_subchannels;  // Services started by resolveServices()
+    std::set<std::string> missing;          // Configured services not in the ensemble (reported)
+    std::chrono::steady_clock::time_point next_resolve{};
+    std::atomic<uint64_t> output_bytes{0};
+
+    // The ensemble can be reconfigured at any time (services added, removed
+    // or moved to another subchannel)
+    static constexpr std::chrono::seconds RESOLVE_INTERVAL{1};
+
+    ~Pipeline() {
+        if (streamer) dvbdab_streamer_destroy(streamer);  // Before the output it writes to
+    }
+
+    static void onOutput(void* opaque, const uint8_t* data, size_t len) {
+        auto* self = static_cast<Pipeline*>(opaque);
+        self->output->write(data, len);
+        self->output_bytes.fetch_add(len, std::memory_order_relaxed);
+    }
+
+    bool start() {
+        output = openOutput(cfg);
+        if (!output) {
+            std::fprintf(stderr, "pipeline %s: cannot open output %s\n", name.c_str(), cfg.output.c_str());
+            return false;
+        }
+
+        dvbdab_streamer_config_t sc{};
+        sc.format = cfg.format;
+        sc.pid = cfg.pid;
+        sc.eti_padding = cfg.eti_padding;
+        sc.eti_bit_offset = cfg.eti_bit_offset;
+        sc.eti_inverted = cfg.eti_inverted;
+        sc.filter_ip = cfg.ip;
+        sc.filter_port = cfg.port;
+        sc.eid = cfg.eid;
+        streamer = dvbdab_streamer_create(&sc);
+        if (!streamer) {
+            std::fprintf(stderr, "pipeline %s: cannot create streamer\n", name.c_str());
+            return false;
+        }
+        dvbdab_streamer_set_output(streamer, &Pipeline::onOutput, this);
+        if (cfg.services.empty()) {
+            dvbdab_streamer_start_all(streamer);  // As soon as the ensemble is known
+        }
+        return true;
+    }
+
+    void feed(const uint8_t* data, size_t len) {
+        dvbdab_streamer_feed(streamer, data, len);
+
+        auto now = std::chrono::steady_clock::now();
+        if (now >= next_resolve && dvbdab_streamer_is_ready(streamer)) {
+            next_resolve = now + RESOLVE_INTERVAL;
+            resolveServices();
+        }
+    }
+
+    // Resolve configured services (SID or label) against the current
+    // ensemble: start newly found or moved ones, stop those that are gone
+    void resolveServices() {
+        dvbdab_ensemble_t* ens = dvbdab_streamer_get_ensemble(streamer);
+        if (!ens) return;
+
+        if (!eid_checked) {
+            eid_checked = true;
+            if (cfg.eid && ens->eid != cfg.eid) {
+                std::fprintf(stderr, "pipeline %s: ensemble is %04X, expected %04X\n",
+                             name.c_str(), ens->eid, cfg.eid);
+            }
+        }
+
+        std::set<uint8_t> wanted;
+        if (cfg.services.empty()) {
+            for (int i = 0; i < ens->service_count; i++) {
+                wanted.insert(static_cast<uint8_t>(ens->services[i].subchannel_id));
+            }
+        }
+        for (const auto& want : cfg.services) {
+            std::string label = unquote(want);
+            unsigned long sid = 0;
+            bool by_sid = label == want && parseNumber(want, 0xFFFFFFFF, sid);
+            const dvbdab_service_t* match = nullptr;
+            for (int i = 0; i < ens->service_count; i++) {
+                const dvbdab_service_t& svc = ens->services[i];
+                if (by_sid ? svc.sid == sid : trim(svc.label) == label) {
+                    match = &svc;
+                    break;
+                }
+            }
+            if (match) {
+                wanted.insert(static_cast<uint8_t>(match->subchannel_id));
+                if (missing.erase(want)) {
+                    std::fprintf(stderr, "pipeline %s: service %s appeared in ensemble %04X\n",
+                                 name.c_str(), want.c_str(), ens->eid);
+                }
+            } else if (missing.insert(want).second) {
+                std::fprintf(stderr, "pipeline %s: service %s not in ensemble %04X\n",
+                             name.c_str(), want.c_str(), ens->eid);
+            }
+        }
+        dvbdab_streamer_free_ensemble(ens);
+
+        for (auto it = started_subchannels.begin(); it != started_subchannels.end();) {
+            if (wanted.count(*it)) {
+                ++it;
+                continue;
+            }
+            dvbdab_streamer_stop_service(streamer, *it);
+            it = started_subchannels.erase(it);
+        }
+        for (uint8_t subchannel_id : wanted) {
+            if (!started_subchannels.count(subchannel_id) &&
+                dvbdab_streamer_start_service(streamer, subchannel_id) == 0) {
+                started_subchannels.insert(subchannel_id);
+            }
+        }
+    }
+};
+
+// One TS source feeding its pipelines from a reader thread
+class Input {
+public:
+    Input(std::string name, InputConfig cfg) : name_(std::move(name)), cfg_(std::move(cfg)) {}
+
+    ~Input() { stop(); }
+
+    const InputConfig& config() const { return cfg_; }
+
+    bool start() {
+        if (cfg_.udp_port != 0) {
+            udp_ = std::make_unique<dvbdab::UdpTsReceiver>(cfg_.udp_address, cfg_.udp_port, cfg_.interface);
+            if (!udp_->open()) {
+                std::fprintf(stderr, "input %s: cannot receive %s:%u: %s\n", name_.c_str(),
+                             cfg_.udp_address.c_str(), cfg_.udp_port, std::strerror(udp_->getError()));
+                udp_.reset();
+                return false;
+            }
+            running_ = true;
+            thread_ = std::thread(&Input::runUdp, this);
+            return true;
+        }
+
+        if (!cfg_.path.empty()) {
+            fd_ = open(cfg_.path.c_str(), O_RDONLY);
+            if (fd_ < 0) {
+                std::fprintf(stderr, "input %s: cannot open %s: %s\n", name_.c_str(),
+                             cfg_.path.c_str(), std::strerror(errno));
+                return false;
+            }
+            own_fd_ = true;
+        } else {
+            fd_ = cfg_.fd;
+        }
+
+        reader_ = std::make_unique<dvbdab::DvrReader>(
+            fd_, cfg_.ring_size ? cfg_.ring_size : dvbdab::DvrReader::DEFAULT_RING_SIZE);
+        if (!reader_->start()) return false;
+
+        running_ = true;
+        thread_ = std::thread(&Input::run, this);
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) thread_.join();
+        if (reader_) reader_->stop();
+        reader_.reset();
+        udp_.reset();
+        if (own_fd_ && fd_ >= 0) close(fd_);
+        fd_ = -1;
+        own_fd_ = false;
+    }
+
+    // Replace the pipeline set; unchanged pipelines keep running
+    void updatePipelines(const std::map<std::string, PipelineConfig>& wanted) {
+        std::map<std::string, std::unique_ptr<Pipeline>> next;
+        std::vector<std::unique_ptr<Pipeline>> retired;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [name, pl] : pipelines_) {
+            auto it = wanted.find(name);
+            if (it != wanted.end() && it->second == pl->cfg) {
+                next[name] = std::move(pl);
+            } else {
+                retired.push_back(std::move(pl));
+            }
+        }
+        for (const auto& [name, cfg] : wanted) {
+            if (next.count(name)) continue;
+            auto pl = std::make_unique<Pipeline>();
+            pl->name = name;
+            pl->cfg = cfg;
+            if (pl->start()) {
+                std::fprintf(stderr, "pipeline %s: started\n", name.c_str());
+                next[name] = std::move(pl);
+            }
+        }
+        pipelines_ = std::move(next);
+        // Retired pipelines are destroyed after the lock is released
+    }
+
+    void printStats(unsigned int window_s) {
+        if (udp_) {
+            std::fprintf(stderr, "input %s: %zu datagrams (%s), %zu sequence gaps, %zu lost, %llu kernel drops\n",
+                         name_.c_str(), udp_->getDatagramCount(), udp_->usesRing() ? "ring" : "socket",
+                         udp_->getSequenceGapCount(), udp_->getLostDatagramCount(),
+                         static_cast<unsigned long long>(udp_->getDropCount()));
+        } else if (reader_) {
+            std::fprintf(stderr, "input %s: %.1f Mbit/s, %zu reads (%zu bytes each), %zu overflows, %zu ring full%s\n",
+                         name_.c_str(), reader_->getRate() * 8 / 1e6, reader_->getReadCount(),
+                         reader_->getReadSize(), reader_->getOverflowCount(), reader_->getRingFullCount(),
+                         reader_->finished() ? ", ended" : "");
+        } else {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [name, pl] : pipelines_) {
+            dvbdab_ensemble_stats_t es{};
+            dvbdab_streamer_get_subchannel_stats(pl->streamer, window_s, &es, nullptr, 0);
+            std::fprintf(stderr, "  pipeline %s: %s, %llu bytes out, %d/%d CU, %.0f kbit/s carried\n",
+                         name.c_str(),
+                         dvbdab_streamer_is_ready(pl->streamer) ? "ready" :
+                         dvbdab_streamer_is_basic_ready(pl->streamer) ? "basic ready" : "waiting",
+                         static_cast<unsigned long long>(pl->output_bytes.load()),
+                         es.cu_used, es.cu_capacity, es.carried_kbps);
+        }
+    }
+
+private:
+    void run() {
+        while (running_ && !reader_->finished()) {
+            reader_->consume([this](const uint8_t* data, size_t len) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (auto& [name, pl] : pipelines_) {
+                    pl->feed(data, len);
+                }
+            }, 100);
+        }
+        if (running_) {
+            std::fprintf(stderr, "input %s: end of input\n", name_.c_str());
+        }
+    }
+
+    void runUdp() {
+        while (running_) {
+            udp_->consume([this](const struct iovec* iov, int iovcnt, bool discontinuity) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                for (auto& [name, pl] : pipelines_) {
+                    if (discontinuity) dvbdab_streamer_signal_discontinuity(pl->streamer);
+                    for (int i = 0; i < iovcnt; i++) {
+                        pl->feed(static_cast<const uint8_t*>(iov[i].iov_base), iov[i].iov_len);
+                    }
+                }
+            }, 100);
+        }
+    }
+
+    std::string name_;
+    InputConfig cfg_;
+    int fd_{-1};
+    bool own_fd_{false};
+    std::unique_ptr<dvbdab::DvrReader> reader_;
+    std::unique_ptr<dvbdab::UdpTsReceiver> udp_;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    std::mutex mutex_;  // Guards pipelines_
+    std::map<std::string, std::unique_ptr<Pipeline>> pipelines_;
+};
+
+// Apply a config: keep unchanged inputs, restart changed ones
+void applyConfig(const Config& cfg, std::map<std::string, std::unique_ptr<Input>>& inputs) {
+    for (auto it = inputs.begin(); it != inputs.end();) {
+        auto want = cfg.inputs.find(it->first);
+        if (want == cfg.inputs.end() || !(want->second == it->second->config())) {
+            std::fprintf(stderr, "input %s: stopped\n", it->first.c_str());
+            it = inputs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    for (const auto& [name, in_cfg] : cfg.inputs) {
+        std::map<std::string, PipelineConfig> wanted;
+        for (const auto& [pl_name, pl_cfg] : cfg.pipelines) {
+            if (pl_cfg.input == name) wanted[pl_name] = pl_cfg;
+        }
+
+        auto it = inputs.find(name);
+        if (it == inputs.end()) {
+            auto input = std::make_unique<Input>(name, in_cfg);
+            input->updatePipelines(wanted);
+            if (!input->start()) continue;
+            std::fprintf(stderr, "input %s: started\n", name.c_str());
+            inputs[name] = std::move(input);
+        } else {
+            it->second->updatePipelines(wanted);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "Usage: %s <config-file>\n", argv[0]);
+        return 1;
+    }
+    const std::string config_path = argv[1];
+
+    Config cfg;
+    std::string error;
+    if (!parseConfig(config_path, cfg, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 1;
+    }
+
+    struct sigaction sa{};
+    sa.sa_handler = onSignal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+    sigaction(SIGHUP, &sa, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::map<std::string, std::unique_ptr<Input>> inputs;
+    applyConfig(cfg, inputs);
+
+    auto last_stats = std::chrono::steady_clock::now();
+    while (!g_stop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+        if (g_reload) {
+            g_reload = 0;
+            Config next;
+            if (parseConfig(config_path, next, error)) {
+                std::fprintf(stderr, "reloading %s\n", config_path.c_str());
+                cfg = std::move(next);
+                applyConfig(cfg, inputs);
+            } else {
+                std::fprintf(stderr, "reload failed, keeping old config: %s\n", error.c_str());
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (cfg.stats_interval && now - last_stats >= std::chrono::seconds(cfg.stats_interval)) {
+            last_stats = now;
+            for (auto& [name, input] : inputs) {
+                input->printStats(cfg.stats_interval);
+            }
+        }
+    }
+
+    inputs.clear();
+    return 0;
+}
@@ -0,0 +1,310 @@
+// dvbdab-pad-bench - PadDecoder throughput and allocation benchmark
+//
+// Feeds synthetic DAB+ AUs through PadDecoder::processPad and reports AUs/s
+// and heap allocations per scenario. The AUs carry variable X-PAD as
+// broadcast: DLS labels (two segments, changing every few repetitions),
+// DLS with DL Plus tags, and a MOT slideshow (DGLI + MOT header/body data
+// groups, four images in a carousel - later passes are repetitions). The
+// streams are built before timing starts, so only the decoder is measured.
+//
+// Usage: dvbdab-pad-bench [-n aus]
+
+#include "output/pad_decoder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <vector>
+
+// Count heap allocations of the whole process
+static std::atomic<size_t> g_alloc_count{0};
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+// Not inlined: GCC would pair malloc() and free() across the call sites
+// and warn about a mismatched deallocation
+__attribute__((noinline)) void operator delete(void* p) noexcept { std::free(p); }
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+using dvbdab::PadDecoder;
+
+constexpr size_t AU_SIZE = 256;          // Audio part is never read by the PAD decoder
+constexpr size_t DLS_REPEAT = 8;         // Repetitions of a label before it changes
+constexpr size_t MOT_SEGMENT_SIZE = 1024;
+constexpr size_t MOT_BODY_SIZE = 6000;
+
+// X-PAD application types (EN 300 401 Table 11)
+constexpr uint8_t APP_DGLI = 1;
+constexpr uint8_t APP_DG_START = 2;
+constexpr uint8_t APP_DG_CONT = 3;
+constexpr uint8_t APP_MOT_START = 12;
+constexpr uint8_t APP_MOT_CONT = 13;
+
+// Variable X-PAD subfield length indices (EN 300 401 Table 10)
+constexpr uint8_t LEN_4 = 0;
+constexpr uint8_t LEN_16 = 4;
+constexpr uint8_t LEN_48 = 7;
+constexpr size_t SUBFIELD_LEN[8] = {4, 6, 8, 12, 16, 24, 32, 48};
+
+using Bytes = std::vector<uint8_t>;
+
+uint16_t crc16(const uint8_t* data, size_t len) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= static_cast<uint16_t>(data[i]) << 8;
+        for (int b = 0; b < 8; b++) {
+            crc = (crc & 0x8000) ? static_cast<uint16_t>((crc << 1) ^ 0x1021)
+                                 : static_cast<uint16_t>(crc << 1);
+        }
+    }
+    return crc ^ 0xFFFF;
+}
+
+void appendCrc(Bytes& data) {
+    uint16_t crc = crc16(data.data(), data.size());
+    data.push_back(static_cast<uint8_t>(crc >> 8));
+    data.push_back(static_cast<uint8_t>(crc));
+}
+
+// One X-PAD subfield: application type + data (padded to the subfield length)
+struct Subfield {
+    uint8_t app_type;
+    uint8_t len_idx;
+    Bytes data;
+};
+
+// DAB+ AU with a DSE carrying variable X-PAD (CIs, end marker, subfields)
+// in reversed byte order followed by F-PAD
+Bytes makeAu(const std::vector<Subfield>& subfields) {
+    Bytes xpad;
+    for (const auto& sf : subfields) {
+        xpad.push_back(static_cast<uint8_t>((sf.len_idx << 5) | sf.app_type));
+    }
+    if (subfields.size() < 4) xpad.push_back(0x00);  // End of CI list
+    for (const auto& sf : subfields) {
+        Bytes field = sf.data;
+        field.resize(SUBFIELD_LEN[sf.len_idx], 0x00);
+        xpad.insert(xpad.end(), field.begin(), field.end());
+    }
+
+    Bytes au(AU_SIZE, 0x00);
+    size_t n = xpad.size();
+    au[0] = 0x80;  // DSE, element_id 4
+    au[1] = static_cast<uint8_t>(n + 2);
+    std::copy(xpad.rbegin(), xpad.rend(), au.begin() + 2);
+    au[2 + n] = 0x20;  // F-PAD: variable size X-PAD
+    au[3 + n] = 0x02;  // CI flag
+    return au;
+}
+
+// Split a data group into X-PAD subfields of one size (start, continuation...)
+void appendDataGroup(std::vector<Bytes>& aus, const Bytes& dg, uint8_t start_type,
+                     uint8_t cont_type, uint8_t len_idx, const Subfield* prefix = nullptr) {
+    size_t step = SUBFIELD_LEN[len_idx];
+    for (size_t off = 0; off < dg.size(); off += step) {
+        size_t n = dg.size() - off < step ? dg.size() - off : step;
+        std::vector<Subfield> subfields;
+        if (off == 0 && prefix) subfields.push_back(*prefix);
+        subfields.push_back({off == 0 ? start_type : cont_type, len_idx,
+                             Bytes(dg.begin() + off, dg.begin() + off + n)});
+        aus.push_back(makeAu(subfields));
+    }
+}
+
+// DLS segments (ETSI TS 102 980 / EN 300 401 7.4.5.2), 16 characters each
+void appendDls(std::vector<Bytes>& aus, const std::string& text, bool toggle) {
+    size_t segments = (text.size() + 15) / 16;
+    for (size_t i = 0; i < segments; i++) {
+        size_t n = text.size() - i * 16 < 16 ? text.size() - i * 16 : 16;
+        Bytes dg;
+        dg.push_back(static_cast<uint8_t>((toggle ? 0x80 : 0) | (i == 0 ? 0x40 : 0) |
+                                          (i + 1 == segments ? 0x20 : 0) | (n - 1)));
+        dg.push_back(i == 0 ? 0x0F : static_cast<uint8_t>(i << 4));  // UTF-8 / segment number
+        dg.insert(dg.end(), text.begin() + i * 16, text.begin() + i * 16 + n);
+        appendCrc(dg);
+        appendDataGroup(aus, dg, APP_DG_START, APP_DG_CONT, LEN_16);
+    }
+}
+
+// DL Plus command with artist and title tags
+void appendDlPlus(std::vector<Bytes>& aus, const std::string& text, bool toggle) {
+    size_t split = text.find(" - ");
+    if (split == std::string::npos) return;
+    size_t title_start = split + 3;
+    Bytes dg;
+    dg.push_back(static_cast<uint8_t>((toggle ? 0x80 : 0) | 0x60 | 0x10 | 0x02));
+    dg.push_back(0x01);  // Two tags
+    dg.push_back(static_cast<uint8_t>(dvbdab::DLPlusContentType::ITEM_ARTIST));
+    dg.push_back(0);
+    dg.push_back(static_cast<uint8_t>(split - 1));
+    dg.push_back(static_cast<uint8_t>(dvbdab::DLPlusContentType::ITEM_TITLE));
+    dg.push_back(static_cast<uint8_t>(title_start));
+    dg.push_back(static_cast<uint8_t>(text.size() - title_start - 1));
+    appendCrc(dg);
+    appendDataGroup(aus, dg, APP_DG_START, APP_DG_CONT, LEN_16);
+}
+
+// Terminates the last DLS/DL Plus data group (completed on the next start)
+void appendDgEnd(std::vector<Bytes>& aus) {
+    aus.push_back(makeAu({{APP_DG_START, LEN_4, {}}}));
+}
+
+Bytes motDataGroup(uint8_t dg_type, uint16_t tid, size_t segment_number, bool last,
+                   const uint8_t* segment, size_t len) {
+    Bytes dg;
+    dg.push_back(static_cast<uint8_t>(0x40 | 0x20 | 0x10 | dg_type));  // CRC, segment, user access
+    dg.push_back(0x00);                                                // Continuity/repetition
+    dg.push_back(static_cast<uint8_t>((last ? 0x80 : 0) | (segment_number >> 8)));
+    dg.push_back(static_cast<uint8_t>(segment_number));
+    dg.push_back(0x12);  // Transport ID, 2 bytes
+    dg.push_back(static_cast<uint8_t>(tid >> 8));
+    dg.push_back(static_cast<uint8_t>(tid));
+    dg.push_back(static_cast<uint8_t>(len >> 8));  // Repetition count 0 + segment size
+    dg.push_back(static_cast<uint8_t>(len));
+    dg.insert(dg.end(), segment, segment + len);
+    appendCrc(dg);
+    return dg;
+}
+
+// MOT data group preceded by its Data Group Length Indicator
+void appendMotDataGroup(std::vector<Bytes>& aus, const Bytes& dg) {
+    Bytes dgli = {static_cast<uint8_t>(dg.size() >> 8), static_cast<uint8_t>(dg.size())};
+    appendCrc(dgli);
+    Subfield prefix{APP_DGLI, LEN_4, dgli};
+    appendDataGroup(aus, dg, APP_MOT_START, APP_MOT_CONT, LEN_48, &prefix);
+}
+
+// SlideShow object: MOT header (JPEG, ContentName) + segmented body
+void appendMotObject(std::vector<Bytes>& aus, uint16_t tid) {
+    Bytes body(MOT_BODY_SIZE);
+    for (size_t i = 0; i < body.size(); i++) {
+        body[i] = static_cast<uint8_t>(i * 31 + tid);
+    }
+
+    const std::string name = "slide" + std::to_string(tid) + ".jpg";
+    Bytes header(7);
+    size_t header_size = 7 + 2 + 1 + name.size();
+    header[0] = static_cast<uint8_t>(body.size() >> 20);
+    header[1] = static_cast<uint8_t>(body.size() >> 12);
+    header[2] = static_cast<uint8_t>(body.size() >> 4);
+    header[3] = static_cast<uint8_t>((body.size() << 4) | (header_size >> 9));
+    header[4] = static_cast<uint8_t>(header_size >> 1);
+    header[5] = static_cast<uint8_t>((header_size << 7) | (2 << 1));  // Content type image
+    header[6] = 0x01;                                                 // JPEG
+    header.push_back(0xCC);  // ContentName, data field length follows
+    header.push_back(static_cast<uint8_t>(1 + name.size()));
+    header.push_back(0x00);  // Charset
+    header.insert(header.end(), name.begin(), name.end());
+
+    appendMotDataGroup(aus, motDataGroup(3, tid, 0, true, header.data(), header.size()));
+    size_t segments = (body.size() + MOT_SEGMENT_SIZE - 1) / MOT_SEGMENT_SIZE;
+    for (size_t i = 0; i < segments; i++) {
+        size_t off = i * MOT_SEGMENT_SIZE;
+        size_t n = body.size() - off < MOT_SEGMENT_SIZE ? body.size() - off : MOT_SEGMENT_SIZE;
+        appendMotDataGroup(aus, motDataGroup(4, tid, i, i + 1 == segments, body.data() + off, n));
+    }
+}
+
+const char* const LABELS[] = {
+    "The Artist - A Song Title",
+    "Another Band - Second Song With A Longer Title",
+    "Third Artist - Short",
+    "News at the top of the hour - Weather",
+};
+
+std::vector<Bytes> dlsStream(bool dlplus) {
+    std::vector<Bytes> aus;
+    bool toggle = false;
+    for (const char* label : LABELS) {
+        for (size_t r = 0; r < DLS_REPEAT; r++) {
+            appendDls(aus, label, toggle);
+            if (dlplus) appendDlPlus(aus, label, toggle);
+        }
+        toggle = !toggle;
+    }
+    appendDgEnd(aus);
+    return aus;
+}
+
+std::vector<Bytes> motStream() {
+    std::vector<Bytes> aus;
+    for (uint16_t tid = 1; tid <= 4; tid++) {
+        appendMotObject(aus, tid);
+    }
+    return aus;
+}
+
+struct Result {
+    size_t aus;
+    size_t allocs;
+    double seconds;
+};
+
+// Run n AUs (cycling over the stream) through a fresh decoder
+Result run(const std::vector<Bytes>& stream, size_t n, bool mot, size_t& events) {
+    PadDecoder decoder;
+    events = 0;
+    decoder.setDLSCallback([&](const std::string&) { events++; });
+    decoder.setDLPlusCallback([&](const std::string&, const std::vector<dvbdab::DLPlusTag>&) { events++; });
+    if (mot) {
+        decoder.setMotCallback([&](const dvbdab::MotObject&) { events++; });
+    }
+
+    size_t allocs = g_alloc_count.load(std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < n; i++) {
+        const Bytes& au = stream[i % stream.size()];
+        decoder.processPad(au.data(), au.size());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {n, g_alloc_count.load(std::memory_order_relaxed) - allocs, seconds};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t n = 2000000;
+    if (argc == 3 && std::strcmp(argv[1], "-n") == 0) {
+        n = std::strtoul(argv[2], nullptr, 10);
+    } else if (argc != 1) {
+        n = 0;
+    }
+    if (n == 0) {
+        std::fprintf(stderr, "Usage: %s [-n aus]\n", argv[0]);
+        return 1;
+    }
+
+    struct Scenario {
+        const char* name;
+        std::vector<Bytes> stream;
+        bool mot;
+        const char* events;
+    };
+    Scenario scenarios[] = {
+        {"dls", dlsStream(false), false, "labels"},
+        {"dls+dlplus", dlsStream(true), false, "labels/tags"},
+        {"mot", motStream(), true, "objects"},
+    };
+
+    std::printf("%-12s %10s %12s %12s %12s %10s\n",
+                "scenario", "AUs", "AUs/s", "allocs", "allocs/kAU", "events");
+    for (const auto& sc : scenarios) {
+        size_t events = 0;
+        Result r = run(sc.stream, n, sc.mot, events);
+        std::printf("%-12s %10zu %12.0f %12zu %12.2f %10zu %s\n",
+                    sc.name, r.aus, r.seconds > 0 ? r.aus / r.seconds : 0.0,
+                    r.allocs, r.allocs * 1000.0 / r.aus, events, sc.events);
+    }
+    return 0;
+}
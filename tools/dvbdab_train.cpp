@@ -0,0 +1,119 @@
+// dvbdab-train - PGO training driver
+//
+// Runs the full pipeline over TS captures: the scanner finds the ensembles
+// of each capture (MPE, GSE, ETI-NA, TSNI), then one streamer per ensemble
+// decodes every service with MOT enabled. Output is discarded. Used by the
+// pgo-train target of a DVBDAB_PGO=GENERATE build.
+//
+// Usage: dvbdab-train [-n passes] capture.ts...
+
+#include <dvbdab/dvbdab_c.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+constexpr size_t CHUNK_SIZE = 188 * 348;
+
+std::vector<uint8_t> readFile(const char* path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), {});
+}
+
+void discardOutput(void*, const uint8_t*, size_t) {}
+void discardMot(void*, const dvbdab_mot_object_t*) {}
+
+dvbdab_streamer_config_t streamerConfig(const dvbdab_ensemble_t& ens) {
+    dvbdab_streamer_config_t cfg{};
+    cfg.pid = ens.source_pid;
+    cfg.eid = ens.eid;
+    cfg.format = static_cast<dvbdab_format_t>(ens.format);
+    if (cfg.format == DVBDAB_FORMAT_ETI_NA) {
+        cfg.eti_padding = static_cast<uint8_t>(ens.etina_padding);
+        cfg.eti_bit_offset = static_cast<uint8_t>(ens.etina_bit_offset);
+        cfg.eti_inverted = static_cast<uint8_t>(ens.etina_inverted);
+    } else if (cfg.format != DVBDAB_FORMAT_TSNI) {
+        cfg.filter_ip = ens.source_ip;
+        cfg.filter_port = ens.source_port;
+    }
+    return cfg;
+}
+
+// Scan one capture, then stream all of its ensembles. Returns bytes processed.
+size_t train(const char* path, const std::vector<uint8_t>& data) {
+    dvbdab_scanner_t* scanner = dvbdab_scanner_create();
+    if (!scanner) return 0;
+    // Stream time, so every run of a capture trains the same code paths
+    dvbdab_scanner_set_clock(scanner, DVBDAB_CLOCK_MEDIA);
+    dvbdab_scanner_set_timeout(scanner, 60000);
+    for (size_t off = 0; off < data.size(); off += CHUNK_SIZE) {
+        size_t len = data.size() - off < CHUNK_SIZE ? data.size() - off : CHUNK_SIZE;
+        if (dvbdab_scanner_feed(scanner, data.data() + off, len)) break;
+    }
+    dvbdab_results_t* results = dvbdab_scanner_get_results(scanner);
+    dvbdab_scanner_destroy(scanner);
+    if (!results) return 0;
+
+    std::vector<dvbdab_streamer_t*> streamers;
+    for (int i = 0; i < results->ensemble_count; i++) {
+        dvbdab_streamer_config_t cfg = streamerConfig(results->ensembles[i]);
+        dvbdab_streamer_t* s = dvbdab_streamer_create(&cfg);
+        if (!s) continue;
+        dvbdab_streamer_set_output(s, discardOutput, nullptr);
+        dvbdab_streamer_set_mot_callback(s, discardMot, nullptr);
+        dvbdab_streamer_subscribe_mot(s, DVBDAB_MOT_ALL);
+        dvbdab_streamer_start_all(s);
+        streamers.push_back(s);
+    }
+    std::fprintf(stderr, "%s: %d ensembles\n", path, results->ensemble_count);
+    dvbdab_results_free(results);
+
+    for (size_t off = 0; off < data.size(); off += CHUNK_SIZE) {
+        size_t len = data.size() - off < CHUNK_SIZE ? data.size() - off : CHUNK_SIZE;
+        for (auto* s : streamers) {
+            dvbdab_streamer_feed(s, data.data() + off, len);
+        }
+    }
+    for (auto* s : streamers) {
+        dvbdab_streamer_destroy(s);
+    }
+    return data.size() * (streamers.size() + 1);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int passes = 1;
+    int first = 1;
+    if (argc > 2 && std::strcmp(argv[1], "-n") == 0) {
+        passes = std::atoi(argv[2]);
+        first = 3;
+    }
+    if (first >= argc || passes < 1) {
+        std::fprintf(stderr, "Usage: %s [-n passes] capture.ts...\n", argv[0]);
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    size_t total = 0;
+    for (int pass = 0; pass < passes; pass++) {
+        for (int i = first; i < argc; i++) {
+            std::vector<uint8_t> data = readFile(argv[i]);
+            if (data.empty()) {
+                std::fprintf(stderr, "%s: cannot read\n", argv[i]);
+                return 1;
+            }
+            total += train(argv[i], data);
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "processed %.1f MB in %.2f s (%.1f MB/s)\n",
+                 total / 1e6, seconds, seconds > 0 ? total / 1e6 / seconds : 0.0);
+    return 0;
+}